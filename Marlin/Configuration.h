@@ -2128,6 +2128,13 @@
   #define SEGMENT_LEVELED_MOVES
   #define LEVELED_SEGMENT_LENGTH 5.0 // (mm) Length of all segments (except the last one)
 
+  /**
+   * Store mesh Z values as 16-bit microns instead of floats.
+   * Halves the RAM and EEPROM used by the mesh, allowing a larger grid
+   * on boards with little RAM. Values are limited to ±32.767mm.
+   */
+  //#define COMPACT_MESH
+
   /**
    * Enable the G26 Mesh Validation Pattern tool.
    */
@@ -3672,6 +3679,8 @@ EEPROM_W25Q
 #ifdef MCU_STM32F407VE
   #if DISABLED(_RB_DEBUG_)
     #define THUMBNAILS_PREVIEW
+    #define THUMBNAILS_CACHE        // Keep decoded and scaled thumbnails on the SD card (hidden /.thumbs folder)
+    #define THUMBNAILS_CACHE_FILES 100  // The oldest cached thumbnails are deleted to stay below this many files
   #endif
 #endif
 
@@ -3679,3 +3688,24 @@ EEPROM_W25Q
 #define HAS_LCD_BRIGHTNESS 1
 
 //  #define BOOT_MARLIN_RB_LOGO
+
+//
+// The Linux motion replay (env:linux_replay) runs without the board hardware
+//
+#if ENABLED(LINUX_REPLAY)
+  #undef MKS_WIFI
+  #undef SERIAL_PORT_2
+  #undef ENDSTOP_INTERRUPTS_FEATURE
+  #undef MKS_ROBIN_TFT35
+  #undef TFT_COLOR_UI
+  #undef LCD_BED_LEVELING
+  #undef LCD_BED_TRAMMING
+  #undef TOUCH_SCREEN
+  #undef TOUCH_SCREEN_CALIBRATION
+  #undef HAS_LCD_BRIGHTNESS
+  #undef BLTOUCH              // No servos on HAL/LINUX
+  #define FIX_MOUNTED_PROBE
+  #undef FILAMENT_RUNOUT_SENSOR
+  #undef SDSUPPORT            // G-code comes in on the serial queue
+  #undef EEPROM_SETTINGS      // Every run starts from these defaults
+#endif
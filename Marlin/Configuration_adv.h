@@ -1153,13 +1153,26 @@
   // Try increasing this value if stepper motion is not smooth.
   #define FTM_STEPPERCMD_BUFF_SIZE 2000                 // Size of the stepper command buffers.
 
+  // Use fixed-point math for trajectory generation, shaping and step conversion.
+  // For boards without an FPU (e.g., STM32F1). Shaper setup and arcs still use float.
+  // Check with buildroot/share/scripts/ftm_fixed_compare.py against the float build.
+  #if ANY(MCU_STM32F103RE, MCU_STM32F103VE, MCU_STM32F103ZE)
+    #define FTM_FIXED_POINT
+  #endif
+
+  // With Mesh or Bilinear leveling, have the trajectory follow the mesh within each
+  // block, so leveled moves aren't split at grid lines or into segments.
+  #if ANY(MESH_BED_LEVELING, AUTO_BED_LEVELING_BILINEAR)
+    #define FTM_LEVELING
+  #endif
+
   #define FT_MOTION_MENU                              // Provide a MarlinUI menu to set M493 parameters.
 #endif
 
 /**
  * Input Shaping -- EXPERIMENTAL
  *
- * Zero Vibration (ZV) Input Shaping for X and/or Y movements.
+ * Zero Vibration (ZV) and multi-impulse Input Shaping for X and/or Y movements.
  *
  * This option uses a lot of SRAM for the step buffer. The buffer size is
  * calculated automatically from SHAPING_FREQ_[XY], DEFAULT_AXIS_STEPS_PER_UNIT,
@@ -1173,7 +1186,7 @@
  *
  *  D<factor>    Set the zeta/damping factor. If axes (X, Y, etc.) are not specified, set for all axes.
  *  F<frequency> Set the frequency. If axes (X, Y, etc.) are not specified, set for all axes.
- *  T[map]       Input Shaping type, 0:ZV, 1:EI, 2:2H EI (not implemented yet)
+ *  T<type>      Input Shaping type, 0:ZV, 1:EI, 2:2H EI, 3:ZVD, 4:MZV
  *  X<1>         Set the given parameters only for the X axis.
  *  Y<1>         Set the given parameters only for the Y axis.
  */
@@ -1185,13 +1198,18 @@
   #if ENABLED(INPUT_SHAPING_X)
     #define SHAPING_FREQ_X  40          // (Hz) The default dominant resonant frequency on the X axis.
     #define SHAPING_ZETA_X  0.15f       // Damping ratio of the X axis (range: 0.0 = no damping to 1.0 = critical damping).
+    #define SHAPING_TYPE_X  0           // Default shaper of the X axis. 0:ZV, 1:EI, 2:2H EI, 3:ZVD, 4:MZV
   #endif
   #if ENABLED(INPUT_SHAPING_Y)
     #define SHAPING_FREQ_Y  40          // (Hz) The default dominant resonant frequency on the Y axis.
     #define SHAPING_ZETA_Y  0.15f       // Damping ratio of the Y axis (range: 0.0 = no damping to 1.0 = critical damping).
+    #define SHAPING_TYPE_Y  0           // Default shaper of the Y axis. 0:ZV, 1:EI, 2:2H EI, 3:ZVD, 4:MZV
   #endif
   //#define SHAPING_MIN_FREQ  20        // By default the minimum of the shaping frequencies. Override to affect SRAM usage.
   //#define SHAPING_MAX_STEPRATE 10000  // By default the maximum total step rate of the shaped axes. Override to affect SRAM usage.
+  #define SHAPING_MAX_IMPULSES 2      // Largest shaper for M593 T. 2:ZV only, 3:+ZVD/MZV/EI, 4:+2H EI.
+                                      // Each impulse above 2 adds the size of the ZV step buffer in SRAM.
+  #define SHAPING_V_TOL        0.05f  // Vibration tolerance of the EI shapers
   #define SHAPING_MENU                // Add a menu to the LCD to set shaping parameters.
 #endif
 
@@ -1372,6 +1390,25 @@
  */
 #define MULTISTEPPING_LIMIT   16  //: [1, 2, 4, 8, 16, 32, 64, 128]
 
+/**
+ * Step Stream moves the trapezoid and Bresenham math out of the Stepper ISR.
+ * The main loop turns upcoming planner blocks into a ring of pre-computed step
+ * events (interval, step mask, direction mask) and the ISR only pops and pulses.
+ * This lowers ISR jitter and raises the step rate reachable without multi-stepping.
+ * Size the ring to cover the longest main loop stall (at least a few ms of steps).
+ * When the ring runs low in the middle of a move the ISR slows down at the axis
+ * acceleration limits, and if it runs dry motion holds until it is refilled and
+ * resumes from a crawl. M111 reports how often this happened.
+ * Not compatible with FT_MOTION, LIN_ADVANCE, INPUT_SHAPING_*, DIRECT_STEPPING,
+ * INTEGRATED_BABYSTEPPING, ADAPTIVE_STEP_SMOOTHING, MIXING_EXTRUDER or LASER_FEATURE.
+ */
+//#define STEP_STREAM
+#if ENABLED(STEP_STREAM)
+  #define STEP_STREAM_SIZE    512 // (step events) 8 bytes each on 32-bit MCUs
+  #define STEP_STREAM_LOW_WATER 256 // (step events) Slow down below this many events while the main loop still owes steps.
+                                    // Stopping from v steps/s at a steps/s² takes v²/2a steps, so this covers ~11k steps/s at 240k steps/s².
+#endif
+
 /**
  * Adaptive Step Smoothing increases the resolution of multi-axis moves, particularly at step frequencies
  * below 1kHz (for AVR) or 10kHz (for ARM), where aliasing between axes in multi-axis moves causes audible
@@ -1654,6 +1691,46 @@
 
   #define SD_PROCEDURE_DEPTH 1              // Increase if you need more nested M32 calls
 
+  // Read the printed file ahead in blocks of this many 512-byte sectors, each block
+  // fetched with a single multi-sector SDIO DMA transfer. Costs 512 bytes of SRAM per sector.
+  // Set to 0 to read through FatFs one byte at a time.
+  #define SD_READ_AHEAD_SECTORS 4
+
+  // Print binary G-code files (.bgcode) as made by recent slicers. Each block is checked
+  // against its CRC before use, then heatshrink (12,4) and MeatPack blocks are decoded
+  // while printing. Thumbnails are found by their block headers. Costs about 4.3K of SRAM.
+  //#define SD_BINARY_GCODE
+
+  // Build a cluster link map of the printed file when it is opened, so seeks
+  // (M26, M24 S, power-loss resume) don't walk the FAT chain from the start.
+  // The map is kept in the shared memory pool and dropped when a WiFi upload needs it.
+  #define SD_FAST_SEEK
+
+  // Index the shown entries of the current folder once per folder change, so the file
+  // browser seeks straight to an entry instead of rescanning the folder for every line.
+  // Costs 12 bytes of SRAM per entry. Larger folders fall back to scanning.
+  #define SD_DIR_INDEX_SIZE 256
+  //#define SD_DIR_INDEX_BY_DATE            // List the files newest first
+
+  // Allocate a WiFi upload as one contiguous extent of the announced size when it is opened,
+  // so the FAT is not updated cluster by cluster and the printed file reads sequentially.
+  // Uploads fall back to normal growth when no free extent is large enough.
+  #define SD_PREALLOCATE_UPLOADS
+  #if ENABLED(SD_PREALLOCATE_UPLOADS)
+    #define SD_PREALLOCATE_SCAN_SECTORS 256 // Search at most this many FAT sectors for the extent,
+                                            // so a fragmented card can't stall the upload (0 = no limit)
+  #endif
+
+  // FAT32 cards whose FSINFO has no valid free cluster count or next free cluster hint are
+  // scanned in the background, this many FAT sectors per idle loop, and FSINFO is written
+  // back. Later mounts and the first file create then don't walk the FAT. 0 to disable.
+  #define SD_FSINFO_SCAN_SECTORS 4
+
+  // Keep this many recently used FAT and directory sectors in RAM between FatFs and the
+  // SDIO driver, 512 bytes each. Writes go through to the card. M5010 reports hits/misses.
+  // Set to 0 to disable.
+  #define SD_SECTOR_CACHE_SIZE 4
+
   #define SD_FINISHED_STEPPERRELEASE true   // Disable steppers when SD Print is finished
   #define SD_FINISHED_RELEASECOMMAND "M84"  // Use "M84XYE" to keep Z enabled so your bed stays in place
 
@@ -2424,6 +2501,11 @@
   #define N_ARC_CORRECTION       25   // Number of interpolated segments between corrections
   //#define ARC_P_CIRCLES             // Enable the 'P' parameter to specify complete circles
   //#define SF_ARC_FIX                // Enable only if using SkeinForge with "Arc Point" fillet procedure
+  #if ENABLED(FT_MOTION)
+    #define ARC_BLOCKS                // With Fixed-Time Motion active (M493) queue arcs as a few native
+                                      // planner blocks and let ft_motion trace the curve. Requires ~1.2K.
+    #define ARC_BLOCK_MAX_SWEEP  90   // (°) Largest piece of an arc in a single planner block
+  #endif
 #endif
 
 // G5 Bézier Curve Support with XYZE destination and IJPQ offsets
@@ -2529,6 +2611,17 @@
 #define MAX_CMD_SIZE 96
 #define BUFSIZE 36
 
+/**
+ * Pack queued commands end-to-end at their actual length instead of giving
+ * each one a MAX_CMD_SIZE slot. BUFSIZE becomes the most commands queued at
+ * once and COMMAND_QUEUE_BYTES the RAM they share. Typical moves take about
+ * 30 bytes, so around three times as many fit in the same RAM.
+ */
+//#define PACKED_COMMAND_QUEUE
+#if ENABLED(PACKED_COMMAND_QUEUE)
+  #define COMMAND_QUEUE_BYTES 3456  // (bytes) RAM for queued commands. The fixed queue uses BUFSIZE * MAX_CMD_SIZE.
+#endif
+
 // Transmission to Host Buffer Size
 // To save 386 bytes of flash (and TX_BUFFER_SIZE+3 bytes of RAM) set to 0.
 // To buffer a simple "ok" you need 4 bytes.
@@ -2550,6 +2643,18 @@
   //#define SERIAL_XON_XOFF
 #endif
 
+/**
+ * Serial DMA Receive (STM32F1 / STM32F4)
+ *
+ * Receive serial data into the RX buffer by circular DMA instead of an interrupt
+ * for every byte. The buffer is updated on line idle and half/full transfer events
+ * and whenever it is polled, which cuts the interrupt load of fast host streaming.
+ * Each hardware serial port in use takes one receive DMA stream (channel on STM32F1).
+ * With MKS_WIFI serial port 1 stays on interrupts, as WiFi uploads use its DMA.
+ * With SERIAL_STATS_RX_BUFFER_OVERRUNS, M111 reports bytes lost to a full RX buffer.
+ */
+//#define SERIAL_DMA_RX
+
 #if HAS_MEDIA
   // Enable this option to collect and display the maximum
   // RX queue usage after transferring a file to SD.
@@ -3828,6 +3933,17 @@
 
 #if ENABLED(FASTER_GCODE_PARSER)
   //#define GCODE_QUOTED_STRINGS  // Support for quoted string parameters
+
+  /**
+   * Tokenize G0-G3 moves as they are queued, converting parameter values
+   * ahead of time so dispatch skips the parse and string-to-float work.
+   * Other commands are parsed at dispatch as usual.
+   * Uses (5 + 6 * GCODE_TOKEN_PARAMS) bytes of SRAM, rounded up, per BUFSIZE.
+   */
+  //#define GCODE_PRETOKENIZE
+  #if ENABLED(GCODE_PRETOKENIZE)
+    #define GCODE_TOKEN_PARAMS 5  // Moves with more parameters are parsed at dispatch
+  #endif
 #endif
 
 // Support for MeatPack G-code compression (https://github.com/scottmudge/OctoPrint-MeatPack)
@@ -4407,3 +4523,13 @@
 
 // Report uncleaned reset reason from register r2 instead of MCUSR. Supported by Optiboot on AVR.
 //#define OPTIBOOT_RESET_REASON
+
+//
+// The Linux motion replay (env:linux_replay) runs without the board hardware
+//
+#if ENABLED(LINUX_REPLAY)
+  #undef FAST_PWM_FAN
+  #undef ADVANCED_PAUSE_FEATURE  // Needs an LCD
+  #undef PARK_HEAD_ON_PAUSE
+  #undef FILAMENT_LOAD_UNLOAD_GCODES
+#endif
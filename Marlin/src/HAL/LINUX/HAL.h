@@ -122,7 +122,11 @@ public:
   static void delay_ms(const int ms) { _delay_ms(ms); }
 
   // Tasks, called from idle()
-  static void idletask() {}
+  #ifdef LINUX_REPLAY
+    static void idletask() { Clock::delayMicros(10); } // Replay: each idle() costs 10µs of simulated time
+  #else
+    static void idletask() {}
+  #endif
 
   // Reset
   static constexpr uint8_t reset_reason = RST_POWER_ON;
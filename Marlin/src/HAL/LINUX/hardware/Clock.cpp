@@ -27,5 +27,9 @@
 std::chrono::nanoseconds Clock::startup = std::chrono::high_resolution_clock::now().time_since_epoch();
 uint32_t Clock::frequency = F_CPU;
 double Clock::time_multiplier = 1.0;
+#ifdef LINUX_REPLAY
+  uint64_t Clock::sim_nanos = 0;
+  void (*Clock::wait_fn)(uint64_t until) = nullptr;
+#endif
 
 #endif // __PLAT_LINUX__
@@ -43,11 +43,38 @@ public:
     Clock::frequency = freq;
   }
 
-  // Time Acceleration compensated
-  static uint64_t nanos() {
-    auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
-    return (now.count() - Clock::startup.count()) * Clock::time_multiplier;
-  }
+  #ifdef LINUX_REPLAY
+
+    // Replay: simulated time starting at 0. It only moves when the firmware
+    // waits, and every wait goes through wait_fn so due timers can run first.
+
+    static uint64_t nanos() {
+      return Clock::sim_nanos;
+    }
+
+    static void setNanos(uint64_t ns) {
+      if (ns > Clock::sim_nanos) Clock::sim_nanos = ns;
+    }
+
+    static void delayNanos(uint64_t ns) {
+      const uint64_t until = Clock::sim_nanos + ns;
+      if (Clock::wait_fn) Clock::wait_fn(until);
+      setNanos(until);
+    }
+
+    static void setWaitHandler(void (*fn)(uint64_t until)) {
+      Clock::wait_fn = fn;
+    }
+
+  #else
+
+    // Time Acceleration compensated
+    static uint64_t nanos() {
+      auto now = std::chrono::high_resolution_clock::now().time_since_epoch();
+      return (now.count() - Clock::startup.count()) * Clock::time_multiplier;
+    }
+
+  #endif
 
   static uint64_t micros() {
     return Clock::nanos() / 1000;
@@ -61,21 +88,32 @@ public:
     return Clock::nanos() / 1000000000.0;
   }
 
-  static void delayCycles(uint64_t cycles) {
-    std::this_thread::sleep_for(std::chrono::nanoseconds( (1000000000L / frequency) * cycles) / Clock::time_multiplier );
-  }
+  #ifdef LINUX_REPLAY
 
-  static void delayMicros(uint64_t micros) {
-    std::this_thread::sleep_for(std::chrono::microseconds( micros ) / Clock::time_multiplier);
-  }
+    static void delayCycles(uint64_t cycles) { delayNanos((1000000000ULL / frequency) * cycles); }
+    static void delayMicros(uint64_t micros) { delayNanos(micros * 1000ULL); }
+    static void delayMillis(uint64_t millis) { delayNanos(millis * 1000000ULL); }
+    static void delaySeconds(double secs)    { delayNanos(uint64_t(secs * 1000000000.0)); }
 
-  static void delayMillis(uint64_t millis) {
-    std::this_thread::sleep_for(std::chrono::milliseconds( millis ) / Clock::time_multiplier);
-  }
+  #else
 
-  static void delaySeconds(double secs) {
-    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(secs * 1000) / Clock::time_multiplier);
-  }
+    static void delayCycles(uint64_t cycles) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds( (1000000000L / frequency) * cycles) / Clock::time_multiplier );
+    }
+
+    static void delayMicros(uint64_t micros) {
+      std::this_thread::sleep_for(std::chrono::microseconds( micros ) / Clock::time_multiplier);
+    }
+
+    static void delayMillis(uint64_t millis) {
+      std::this_thread::sleep_for(std::chrono::milliseconds( millis ) / Clock::time_multiplier);
+    }
+
+    static void delaySeconds(double secs) {
+      std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(secs * 1000) / Clock::time_multiplier);
+    }
+
+  #endif
 
   // Will reduce timer resolution increasing likelihood of overflows
   static void setTimeMultiplier(double tm) {
@@ -86,4 +124,8 @@ private:
   static std::chrono::nanoseconds startup;
   static uint32_t frequency;
   static double time_multiplier;
+  #ifdef LINUX_REPLAY
+    static uint64_t sim_nanos;
+    static void (*wait_fn)(uint64_t until);
+  #endif
 };
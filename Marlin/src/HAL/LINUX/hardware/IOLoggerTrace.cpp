@@ -0,0 +1,112 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#ifdef __PLAT_LINUX__
+
+#include "IOLoggerTrace.h"
+#include <string.h>
+
+static const char trace_magic[4] = { 'M', 'R', 'T', '1' };
+
+static const char* event_name(const uint8_t event) {
+  return event == GpioEvent::RISE ? "rise" : event == GpioEvent::FALL ? "fall" : "gap";
+}
+
+IOLoggerTrace::IOLoggerTrace(const char *filename) {
+  last_timestamp = record_count = step_count = 0;
+  memset(watched, 0, sizeof(watched));
+  file = fopen(filename, "wb");
+  if (file) fwrite(trace_magic, sizeof(trace_magic), 1, file);
+}
+
+IOLoggerTrace::~IOLoggerTrace() {
+  close();
+}
+
+void IOLoggerTrace::close() {
+  if (file) fclose(file);
+  file = nullptr;
+}
+
+void IOLoggerTrace::watch(pin_type pin, bool step) {
+  if (Gpio::valid_pin(pin)) watched[pin] = step ? 2 : 1;
+}
+
+void IOLoggerTrace::write(uint32_t delta, uint8_t pin, uint8_t event) {
+  const TraceRecord rec = { delta, pin, event };
+  fwrite(&rec, sizeof(rec), 1, file);
+  record_count++;
+}
+
+void IOLoggerTrace::log(GpioEvent ev) {
+  // Only real edges on traced pins; repeated writes of the same level are NOPs
+  if (!file || !Gpio::valid_pin(ev.pin_id) || !watched[ev.pin_id]) return;
+  if (ev.event != GpioEvent::RISE && ev.event != GpioEvent::FALL) return;
+
+  uint64_t delta = ev.timestamp - last_timestamp;
+  last_timestamp = ev.timestamp;
+  for (; delta >= 0xFFFFFFFFULL; delta -= 0xFFFFFFFFULL) write(0xFFFFFFFF, 0, GpioEvent::NOP);
+  write(uint32_t(delta), uint8_t(ev.pin_id), uint8_t(ev.event));
+
+  if (watched[ev.pin_id] == 2 && ev.event == GpioEvent::RISE) step_count++;
+}
+
+bool IOLoggerTrace::compare(const char *trace, const char *golden) {
+  FILE *a = fopen(trace, "rb"), *b = fopen(golden, "rb");
+  bool same = false;
+  char magic_a[4], magic_b[4];
+
+  if (!a || !b)
+    fprintf(stderr, "Trace: can't open %s\n", a ? golden : trace);
+  else if (fread(magic_a, 4, 1, a) != 1 || fread(magic_b, 4, 1, b) != 1 || memcmp(magic_a, trace_magic, 4) || memcmp(magic_b, trace_magic, 4))
+    fprintf(stderr, "Trace: not a trace file\n");
+  else {
+    TraceRecord ra, rb;
+    uint64_t index = 0, time_a = 0, time_b = 0;
+    for (;;) {
+      const bool got_a = fread(&ra, sizeof(ra), 1, a) == 1,
+                 got_b = fread(&rb, sizeof(rb), 1, b) == 1;
+      if (!got_a && !got_b) { same = true; break; }
+      if (got_a) time_a += ra.delta;
+      if (got_b) time_b += rb.delta;
+      if (got_a != got_b) {
+        fprintf(stderr, "Trace: record %llu only in %s (at %llu ns)\n", (unsigned long long)index,
+                got_a ? trace : golden, (unsigned long long)(got_a ? time_a : time_b));
+        break;
+      }
+      if (ra.pin != rb.pin || ra.event != rb.event || time_a != time_b) {
+        fprintf(stderr, "Trace: record %llu differs: pin %u %s at %llu ns, golden pin %u %s at %llu ns\n",
+                (unsigned long long)index,
+                ra.pin, event_name(ra.event), (unsigned long long)time_a,
+                rb.pin, event_name(rb.event), (unsigned long long)time_b);
+        break;
+      }
+      index++;
+    }
+    if (same) fprintf(stderr, "Trace: %llu records match %s\n", (unsigned long long)index, golden);
+  }
+
+  if (a) fclose(a);
+  if (b) fclose(b);
+  return same;
+}
+
+#endif // __PLAT_LINUX__
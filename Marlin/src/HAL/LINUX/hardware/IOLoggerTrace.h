@@ -0,0 +1,65 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <stdio.h>
+#include "Gpio.h"
+
+/**
+ * Binary trace of the step and direction pins, written by the replay harness.
+ *
+ * The file starts with "MRT1", followed by one 6 byte record per edge:
+ *   uint32_t  nanoseconds since the previous record
+ *   uint8_t   pin
+ *   uint8_t   GpioEvent::Type (RISE or FALL)
+ * A gap too long for 32 bits is split with NOP records of 0xFFFFFFFF ns.
+ */
+struct TraceRecord {
+  uint32_t delta;
+  uint8_t pin;
+  uint8_t event;
+} __attribute__((packed));
+
+class IOLoggerTrace: public IOLogger {
+public:
+  IOLoggerTrace(const char *filename);
+  virtual ~IOLoggerTrace();
+  bool ok() { return file != nullptr; }
+  void watch(pin_type pin, bool step=false);
+  void log(GpioEvent ev);
+  void close();
+
+  uint64_t records() { return record_count; }
+  uint64_t steps() { return step_count; }
+
+  // Compare two trace files and describe the first difference on stderr
+  static bool compare(const char *trace, const char *golden);
+
+private:
+  void write(uint32_t delta, uint8_t pin, uint8_t event);
+
+  FILE *file;
+  uint64_t last_timestamp;
+  uint64_t record_count;
+  uint64_t step_count;
+  uint8_t watched[Gpio::pin_count + 1]; // 0: not traced, 1: traced, 2: traced step pin
+};
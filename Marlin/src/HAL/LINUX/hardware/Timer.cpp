@@ -34,8 +34,46 @@ Timer::Timer() {
   period = 0;
   start_time = 0;
   avg_error = 0;
+  #ifdef LINUX_REPLAY
+    next_event = 0;
+  #endif
 }
 
+#ifdef LINUX_REPLAY
+
+/**
+ * Replay: no POSIX timer and no signal. The timer only keeps the simulated time
+ * it is due next. setCompare() counts from now, like the signal version does.
+ */
+Timer::~Timer() {}
+
+void Timer::init(uint32_t, uint32_t sim_freq, callback_fn* fn) {
+  frequency = sim_freq;
+  cbfn = fn;
+}
+
+void Timer::start(uint32_t frequency) {
+  setCompare(this->frequency / frequency);
+}
+
+void Timer::enable()  { active = true; }
+void Timer::disable() { active = false; }
+
+void Timer::setCompare(uint32_t compare) {
+  this->compare = compare;
+  this->period = Clock::ticksToNanos(compare, frequency);
+  this->start_time = Clock::nanos();
+  this->next_event = this->start_time + this->period;
+}
+
+void Timer::fire() {
+  this->start_time = this->next_event; // wrap
+  this->next_event += this->period;    // periodic unless the callback sets a new compare
+  cbfn();
+}
+
+#else
+
 Timer::~Timer() {
   timer_delete(timerid);
 }
@@ -110,6 +148,8 @@ void Timer::setCompare(uint32_t compare) {
   this->start_time = Clock::nanos();
 }
 
+#endif // !LINUX_REPLAY
+
 uint32_t Timer::getCount() {
   return Clock::nanosToTicks(Clock::nanos() - this->start_time, frequency);
 }
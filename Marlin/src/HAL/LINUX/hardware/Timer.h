@@ -52,6 +52,13 @@ public:
     return (*(intptr_t*)timerid);
   }
 
+  #ifdef LINUX_REPLAY
+    // Replay: Replay::advance() fires the timer once simulated time reaches next_event
+    bool pending(uint64_t until) { return active && period && next_event <= until; }
+    uint64_t nextEvent() { return next_event; }
+    void fire();
+  #endif
+
   static void handler(int sig, siginfo_t *si, void *uc) {
     Timer* _this = (Timer*)si->si_value.sival_ptr;
     _this->avg_error += (Clock::nanos() - _this->start_time) - _this->period; //high_resolution_clock is also limited in precision, but best we have
@@ -73,4 +80,7 @@ private:
   uint64_t period;
   uint64_t avg_error;
   uint64_t start_time;
+  #ifdef LINUX_REPLAY
+    uint64_t next_event;
+  #endif
 };
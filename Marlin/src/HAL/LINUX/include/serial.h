@@ -89,8 +89,12 @@ struct HalSerial {
 
   size_t write(char c) {
     if (!host_connected) return 0;
-    while (!transmit_buffer.free());
-    return transmit_buffer.write(c);
+    #ifdef LINUX_REPLAY
+      return fputc(c, stdout) == EOF ? 0 : 1; // Replay has no serial thread to empty the buffer
+    #else
+      while (!transmit_buffer.free());
+      return transmit_buffer.write(c);
+    #endif
   }
 
   bool connected() { return host_connected; }
@@ -29,6 +29,9 @@
 #include "hardware/IOLoggerCSV.h"
 #include "hardware/Heater.h"
 #include "hardware/LinearAxis.h"
+#ifdef LINUX_REPLAY
+  #include "replay.h"
+#endif
 
 #include <stdio.h>
 #include <stdarg.h>
@@ -105,6 +108,14 @@ void simulation_loop() {
   }
 }
 
+#ifdef LINUX_REPLAY
+
+int main(int argc, char *argv[]) {
+  return Replay::run(argc, argv);
+}
+
+#else
+
 int main() {
   std::thread write_serial (write_serial_thread);
   std::thread read_serial (read_serial_thread);
@@ -135,4 +146,6 @@ int main() {
   read_serial.join();
 }
 
+#endif // !LINUX_REPLAY
+
 #endif // __PLAT_LINUX__
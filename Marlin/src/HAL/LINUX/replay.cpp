@@ -0,0 +1,170 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#ifdef __PLAT_LINUX__
+#ifdef LINUX_REPLAY
+
+#include "../../inc/MarlinConfig.h"
+#include "../../gcode/queue.h"
+#include "../../module/planner.h"
+#include "hardware/Timer.h"
+#include "hardware/IOLoggerTrace.h"
+#include "hardware/Heater.h"
+#include "hardware/LinearAxis.h"
+#include "replay.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+#define REPLAY_TIME_LIMIT_S 86400 // Stop a file that never finishes after one simulated day
+
+extern void setup();
+extern void loop();
+extern Timer timers[2];
+
+bool Replay::in_isr = false;
+uint64_t Replay::isr_count = 0,
+         Replay::isr_total_ns = 0,
+         Replay::isr_max_ns = 0;
+
+static uint64_t host_nanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Replay::advance(uint64_t until) {
+  if (in_isr) return; // Waits inside an ISR only move the clock
+
+  for (;;) {
+    Timer *next = nullptr;
+    for (Timer &t : timers)
+      if (t.pending(until) && (!next || t.nextEvent() < next->nextEvent())) next = &t;
+    if (!next) break;
+
+    Clock::setNanos(next->nextEvent());
+    const uint64_t start = host_nanos();
+    in_isr = true;
+    next->fire();
+    in_isr = false;
+
+    if (next == &timers[MF_TIMER_STEP]) {
+      const uint64_t ns = host_nanos() - start;
+      isr_count++;
+      isr_total_ns += ns;
+      NOLESS(isr_max_ns, ns);
+    }
+  }
+}
+
+int Replay::run(int argc, char *argv[]) {
+  const char *gcode = nullptr, *trace = "replay_trace.bin", *golden = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-o") && i + 1 < argc) trace = argv[++i];
+    else if (!strcmp(argv[i], "-g") && i + 1 < argc) golden = argv[++i];
+    else gcode = argv[i];
+  }
+  if (!gcode) {
+    fprintf(stderr, "Usage: %s file.gcode [-o trace.bin] [-g golden.bin]\n", argv[0]);
+    return 2;
+  }
+
+  FILE *in = fopen(gcode, "rb");
+  if (!in) { fprintf(stderr, "Replay: can't open %s\n", gcode); return 2; }
+
+  IOLoggerTrace logger(trace);
+  if (!logger.ok()) { fprintf(stderr, "Replay: can't create %s\n", trace); fclose(in); return 2; }
+  logger.watch(X_STEP_PIN, true);  logger.watch(X_DIR_PIN);
+  logger.watch(Y_STEP_PIN, true);  logger.watch(Y_DIR_PIN);
+  logger.watch(Z_STEP_PIN, true);  logger.watch(Z_DIR_PIN);
+  logger.watch(E0_STEP_PIN, true); logger.watch(E0_DIR_PIN);
+  Gpio::attachLogger(&logger);
+
+  Clock::setFrequency(F_CPU);
+  Clock::setWaitHandler(advance);
+  HAL_timer_init();
+
+  // Same simulated hardware as the threaded build
+  Heater hotend(HEATER_0_PIN, TEMP_0_PIN);
+  Heater bed(HEATER_BED_PIN, TEMP_BED_PIN);
+  LinearAxis x_axis(X_ENABLE_PIN, X_DIR_PIN, X_STEP_PIN, X_MIN_PIN, X_MAX_PIN);
+  LinearAxis y_axis(Y_ENABLE_PIN, Y_DIR_PIN, Y_STEP_PIN, Y_MIN_PIN, Y_MAX_PIN);
+  LinearAxis z_axis(Z_ENABLE_PIN, Z_DIR_PIN, Z_STEP_PIN, Z_MIN_PIN, Z_MAX_PIN);
+  LinearAxis extruder0(E0_ENABLE_PIN, E0_DIR_PIN, E0_STEP_PIN, P_NC, P_NC);
+
+  setup();
+
+  uint32_t lines = 0, underruns = 0;
+  uint64_t loop_total_ns = 0, loop_max_ns = 0;
+  bool eof = false, was_moving = false;
+
+  for (;;) {
+    // Keep the serial receive buffer full, like a host streaming the file
+    while (!eof && usb_serial.receive_buffer.free()) {
+      const int c = fgetc(in);
+      if (c == EOF) { eof = true; break; }
+      usb_serial.receive_buffer.write(uint8_t(c));
+      if (c == '\n') lines++;
+    }
+
+    hotend.update();
+    bed.update();
+    x_axis.update();
+    y_axis.update();
+    z_axis.update();
+    extruder0.update();
+
+    // loop() calls idle(), which moves simulated time on (MarlinHAL::idletask)
+    const uint64_t start = host_nanos();
+    loop();
+    const uint64_t ns = host_nanos() - start;
+    loop_total_ns += ns;
+    NOLESS(loop_max_ns, ns);
+
+    const bool input_left = !eof || usb_serial.available() || queue.has_commands_queued(),
+               moving = planner.has_blocks_queued();
+    if (was_moving && !moving && input_left) underruns++;
+    was_moving = moving;
+
+    if (!input_left && !planner.busy()) break;
+    if (Clock::seconds() > REPLAY_TIME_LIMIT_S) {
+      fprintf(stderr, "Replay: stopped after %d simulated seconds\n", REPLAY_TIME_LIMIT_S);
+      break;
+    }
+  }
+
+  fclose(in);
+  Gpio::attachLogger(nullptr);
+  logger.close();
+
+  fprintf(stderr, "Replay: %u lines, %.3f s simulated, %llu steps, %llu trace records\n",
+          lines, Clock::seconds(), (unsigned long long)logger.steps(), (unsigned long long)logger.records());
+  fprintf(stderr, "Host loop(): %llu ns per line, longest %llu ns\n",
+          (unsigned long long)(loop_total_ns / _MAX(lines, 1U)), (unsigned long long)loop_max_ns);
+  fprintf(stderr, "Host step ISR: %llu calls, %llu ns per step, longest %llu ns\n",
+          (unsigned long long)isr_count, (unsigned long long)(isr_total_ns / _MAX(logger.steps(), uint64_t(1))), (unsigned long long)isr_max_ns);
+  fprintf(stderr, "Planner ran dry %u times with input left\n", underruns);
+
+  if (golden) return IOLoggerTrace::compare(trace, golden) ? 0 : 1;
+  return 0;
+}
+
+#endif // LINUX_REPLAY
+#endif // __PLAT_LINUX__
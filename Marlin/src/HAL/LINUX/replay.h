@@ -0,0 +1,51 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * Deterministic motion replay for HAL/LINUX (build with -DLINUX_REPLAY, env:linux_replay)
+ *
+ * Usage: <firmware> file.gcode [-o trace.bin] [-g golden.bin]
+ *
+ * Feeds the G-code file through the serial queue and runs the stepper and
+ * temperature ISRs in simulated time, so every run of the same build, config
+ * and file gives the same result. All step and direction edges are written to
+ * a binary trace (IOLoggerTrace.h). With -g the trace is compared to a golden
+ * run and the exit code is 1 if they differ.
+ *
+ * Host timings (loop() per line, step ISR per step, longest step ISR) are
+ * reported on stderr. They measure this machine, use them to compare builds.
+ */
+
+#include <stdint.h>
+
+class Replay {
+public:
+  static int run(int argc, char *argv[]);
+
+  // Let simulated time reach 'until', firing the timers that fall due on the way
+  static void advance(uint64_t until);
+
+private:
+  static bool in_isr;
+  static uint64_t isr_count, isr_total_ns, isr_max_ns;
+};
@@ -65,6 +65,11 @@ hal_timer_t HAL_timer_get_compare(const uint8_t timer_num) {
 }
 
 hal_timer_t HAL_timer_get_count(const uint8_t timer_num) {
+  #ifdef LINUX_REPLAY
+    // Simulated time is frozen otherwise, so let each read cost one stepper tick
+    // to end the pulse width wait loops
+    Clock::delayNanos(Clock::ticksToNanos(1, STEPPER_TIMER_RATE));
+  #endif
   return timers[timer_num].getCount();
 }
 
@@ -38,13 +38,59 @@
   #define USART5 UART5
 #endif
 
-#define DECLARE_SERIAL_PORT(ser_num) \
+#if ENABLED(SERIAL_DMA_RX)
+
+  #ifndef HAL_UART_RECEPTION_TOIDLE
+    #error "SERIAL_DMA_RX requires an STM32 core with HAL_UARTEx_ReceiveToIdle_DMA. Update the platform or disable SERIAL_DMA_RX."
+  #endif
+
+  // Receive DMA of each USART: controller, stream (channel on STM32F1), request channel
+  #ifdef STM32F1xx
+    #define RX_DMA_1 1, Channel5, 0
+    #define RX_DMA_2 1, Channel6, 0
+    #define RX_DMA_3 1, Channel3, 0
+    #define RX_DMA_4 2, Channel3, 0
+    #define _DMA_CHANNEL(C) 0
+  #else
+    #define RX_DMA_1 2, Stream5, 4
+    #define RX_DMA_2 1, Stream5, 4
+    #define RX_DMA_3 1, Stream1, 4
+    #define RX_DMA_4 1, Stream2, 4
+    #define RX_DMA_5 1, Stream0, 4
+    #define RX_DMA_6 2, Stream1, 5
+    #define _DMA_CHANNEL(C) DMA_CHANNEL_##C
+  #endif
+
+  #define __DMA_RX_ARGS(D,S,C) , DMA##D##_##S, _DMA_CHANNEL(C), DMA##D##_##S##_IRQn
+  #define _DMA_RX_ARGS(V) __DMA_RX_ARGS(V)
+  #define DMA_RX_ARGS(ser_num) _DMA_RX_ARGS(RX_DMA_##ser_num)
+
+  #define __DECLARE_DMA_RX_IRQ(ser_num,D,S,C) extern "C" void DMA##D##_##S##_IRQHandler() { MSerial ## ser_num ._rx_dma_irq(); }
+  #define _DECLARE_DMA_RX_IRQ(ser_num,V) __DECLARE_DMA_RX_IRQ(ser_num,V)
+  #define DECLARE_DMA_RX_IRQ(ser_num) _DECLARE_DMA_RX_IRQ(ser_num, RX_DMA_##ser_num)
+
+#else
+
+  #define DMA_RX_ARGS(ser_num)
+  #define DECLARE_DMA_RX_IRQ(ser_num)
+
+#endif
+
+#define _DECLARE_SERIAL_PORT(ser_num, DMA_ARGS) \
   void _rx_complete_irq_ ## ser_num (serial_t * obj); \
-  MSerialT MSerial ## ser_num (true, USART ## ser_num, &_rx_complete_irq_ ## ser_num); \
+  MSerialT MSerial ## ser_num (true, USART ## ser_num, &_rx_complete_irq_ ## ser_num DMA_ARGS); \
   void _rx_complete_irq_ ## ser_num (serial_t * obj) { MSerial ## ser_num ._rx_complete_irq(obj); }
 
+#define DECLARE_SERIAL_PORT(ser_num) \
+  _DECLARE_SERIAL_PORT(ser_num, DMA_RX_ARGS(ser_num)) \
+  DECLARE_DMA_RX_IRQ(ser_num)
+
 #if USING_HW_SERIAL1
-  DECLARE_SERIAL_PORT(1)
+  #if ALL(SERIAL_DMA_RX, MKS_WIFI)
+    _DECLARE_SERIAL_PORT(1, )   // MKS WiFi uploads drive the USART1 receive DMA and its IRQ handler
+  #else
+    DECLARE_SERIAL_PORT(1)
+  #endif
 #endif
 #if USING_HW_SERIAL2
   DECLARE_SERIAL_PORT(2)
@@ -80,11 +126,128 @@
 void MarlinSerial::begin(unsigned long baud, uint8_t config) {
   HardwareSerial::begin(baud, config);
   // Replace the IRQ callback with the one we have defined
-  TERN_(EMERGENCY_PARSER, _serial.rx_callback = _rx_callback);
+  #if ANY(EMERGENCY_PARSER, SERIAL_DMA_RX, SERIAL_STATS_RX_BUFFER_OVERRUNS)
+    _serial.rx_callback = _rx_callback;
+  #endif
+  TERN_(SERIAL_DMA_RX, _rx_dma_begin());
 }
 
+#if ENABLED(SERIAL_DMA_RX)
+
+  /**
+   * Receive into the RX buffer by circular DMA. What the DMA has written is
+   * added to the buffer on line idle and half/full transfer events, and
+   * whenever the buffer is polled, instead of on an interrupt for every byte.
+   */
+  void MarlinSerial::_rx_dma_begin() {
+    if (!_rx_dma.Instance) return;
+
+    #ifdef DMA2
+      if (uint32_t(_rx_dma.Instance) >= DMA2_BASE) __HAL_RCC_DMA2_CLK_ENABLE(); else
+    #endif
+        __HAL_RCC_DMA1_CLK_ENABLE();
+
+    #ifdef STM32F4xx
+      _rx_dma.Init.Channel = _dma_channel;
+      _rx_dma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    #endif
+    _rx_dma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    _rx_dma.Init.PeriphInc = DMA_PINC_DISABLE;
+    _rx_dma.Init.MemInc = DMA_MINC_ENABLE;
+    _rx_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    _rx_dma.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    _rx_dma.Init.Mode = DMA_CIRCULAR;
+    _rx_dma.Init.Priority = DMA_PRIORITY_HIGH;
+    HAL_DMA_DeInit(&_rx_dma);
+    if (HAL_DMA_Init(&_rx_dma) != HAL_OK) return;   // Keep receiving by interrupt
+    __HAL_LINKDMA(&_serial.handle, hdmarx, _rx_dma);
+
+    // Same priority as the USART so the two never preempt each other
+    HAL_NVIC_SetPriority(_dma_irq, UART_IRQ_PRIO, UART_IRQ_SUBPRIO);
+    HAL_NVIC_EnableIRQ(_dma_irq);
+
+    _rx_dma_start();
+  }
+
+  // (Re)start the DMA at the start of the empty buffer
+  void MarlinSerial::_rx_dma_start() {
+    HAL_UART_AbortReceive(&_serial.handle);
+    _serial.rx_head = _serial.rx_tail = 0;
+    _rx_halves_done = _rx_halves_seen = 0;
+    HAL_UARTEx_ReceiveToIdle_DMA(&_serial.handle, _serial.rx_buff, SERIAL_RX_BUFFER_SIZE);
+  }
+
+  void MarlinSerial::_rx_dma_irq() {
+    // Count the half/full transfer events before the HAL clears them
+    if (__HAL_DMA_GET_FLAG(&_rx_dma, __HAL_DMA_GET_HT_FLAG_INDEX(&_rx_dma))) ++_rx_halves_done;
+    if (__HAL_DMA_GET_FLAG(&_rx_dma, __HAL_DMA_GET_TC_FLAG_INDEX(&_rx_dma))) ++_rx_halves_done;
+    HAL_DMA_IRQHandler(&_rx_dma);
+  }
+
+  // Add the bytes written by the DMA since the last update to the buffer
+  void MarlinSerial::_rx_dma_update() {
+    constexpr uint32_t half = SERIAL_RX_BUFFER_SIZE / 2;
+    const rx_buffer_index_t head = _serial.rx_head,
+                            pos = (SERIAL_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(&_rx_dma)) % SERIAL_RX_BUFFER_SIZE;
+    uint32_t received = (pos + SERIAL_RX_BUFFER_SIZE - head) % SERIAL_RX_BUFFER_SIZE;
+
+    // The DMA completing more half buffers than the head has passed means it went all the way round unseen
+    _rx_halves_seen += (head + received) / half - head / half;
+    while (int8_t(_rx_halves_done - _rx_halves_seen) > 0) {
+      received += SERIAL_RX_BUFFER_SIZE;
+      _rx_halves_seen += 2;
+    }
+    if (!received) return;
+
+    // The DMA doesn't wait for the buffer to be read. If it wrote over unread bytes
+    // drop them, keeping the newest SERIAL_RX_BUFFER_SIZE - 1 bytes in order.
+    const uint32_t unread = (head + SERIAL_RX_BUFFER_SIZE - _serial.rx_tail) % SERIAL_RX_BUFFER_SIZE;
+    if (unread + received >= SERIAL_RX_BUFFER_SIZE) {
+      TERN_(SERIAL_STATS_RX_BUFFER_OVERRUNS, _rx_overruns += unread + received - (SERIAL_RX_BUFFER_SIZE - 1));
+      _serial.rx_tail = (pos + 1) % SERIAL_RX_BUFFER_SIZE;
+    }
+
+    #if ENABLED(EMERGENCY_PARSER)
+      const rx_buffer_index_t from = received < SERIAL_RX_BUFFER_SIZE ? head : _serial.rx_tail;
+      for (rx_buffer_index_t i = from; i != pos; i = (i + 1) % SERIAL_RX_BUFFER_SIZE)
+        emergency_parser.update(static_cast<MSerialT*>(this)->emergency_state, _serial.rx_buff[i]);
+    #endif
+
+    _serial.rx_head = pos;
+  }
+
+  int MarlinSerial::available() {
+    CRITICAL_SECTION_START();
+    if (_serial.handle.ReceptionType == HAL_UART_RECEPTION_TOIDLE)
+      _rx_dma_update();
+    else if (_serial.handle.hdmarx && _serial.rx_head == _serial.rx_tail)
+      _rx_dma_start();  // A receive error stopped the DMA and the core went back to interrupts
+    CRITICAL_SECTION_END();
+    return HardwareSerial::available();
+  }
+
+  // An overrun moves the tail from the interrupt, so take bytes with interrupts off
+  int MarlinSerial::read() {
+    CRITICAL_SECTION_START();
+    const int c = HardwareSerial::read();
+    CRITICAL_SECTION_END();
+    return c;
+  }
+
+  // Line idle and half/full transfer events of a receive DMA
+  extern "C" void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t) {
+    serial_t * const obj = (serial_t*)((char*)huart - offsetof(serial_t, handle));
+    if (obj->rx_callback) obj->rx_callback(obj);
+  }
+
+#endif // SERIAL_DMA_RX
+
 // This function is Copyright (c) 2006 Nicholas Zambetti.
 void MarlinSerial::_rx_complete_irq(serial_t *obj) {
+  #if ENABLED(SERIAL_DMA_RX)
+    if (obj->handle.ReceptionType == HAL_UART_RECEPTION_TOIDLE) { _rx_dma_update(); return; }
+  #endif
+
   // No Parity error, read byte and store it in the buffer if there is room
   unsigned char c;
 
@@ -100,6 +263,10 @@ void MarlinSerial::_rx_complete_irq(serial_t *obj) {
       obj->rx_buff[obj->rx_head] = c;
       obj->rx_head = i;
     }
+    #if ENABLED(SERIAL_STATS_RX_BUFFER_OVERRUNS)
+      else
+        ++_rx_overruns;
+    #endif
 
     #if ENABLED(EMERGENCY_PARSER)
       emergency_parser.update(static_cast<MSerialT*>(this)->emergency_state, c);
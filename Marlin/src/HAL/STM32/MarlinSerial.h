@@ -31,18 +31,54 @@
 
 typedef void (*usart_rx_callback_t)(serial_t * obj);
 
+#if ENABLED(SERIAL_DMA_RX)
+  typedef decltype(DMA_HandleTypeDef::Instance) rx_dma_instance_t;
+#endif
+
 struct MarlinSerial : public HardwareSerial {
-  MarlinSerial(void *peripheral, usart_rx_callback_t rx_callback) :
-      HardwareSerial(peripheral), _rx_callback(rx_callback)
-  { }
+  #if ENABLED(SERIAL_DMA_RX)
+    // Without a DMA the port receives by interrupt
+    MarlinSerial(void *peripheral, usart_rx_callback_t rx_callback, rx_dma_instance_t dma=nullptr, const uint32_t dma_channel=0, const IRQn_Type dma_irq=NonMaskableInt_IRQn) :
+        HardwareSerial(peripheral), _rx_callback(rx_callback), _dma_channel(dma_channel), _dma_irq(dma_irq)
+    { _rx_dma.Instance = dma; }
+  #else
+    MarlinSerial(void *peripheral, usart_rx_callback_t rx_callback) :
+        HardwareSerial(peripheral), _rx_callback(rx_callback)
+    { }
+  #endif
 
   void begin(unsigned long baud, uint8_t config);
   inline void begin(unsigned long baud) { begin(baud, SERIAL_8N1); }
 
   void _rx_complete_irq(serial_t *obj);
 
+  #if ENABLED(SERIAL_DMA_RX)
+    int available() override;
+    int read() override;
+    void _rx_dma_irq();
+  #endif
+
+  #if ENABLED(SERIAL_STATS_RX_BUFFER_OVERRUNS)
+    uint32_t buffer_overruns() { return _rx_overruns; }
+  #endif
+
 protected:
   usart_rx_callback_t _rx_callback;
+
+  #if ENABLED(SERIAL_DMA_RX)
+    DMA_HandleTypeDef _rx_dma;
+    const uint32_t _dma_channel;
+    const IRQn_Type _dma_irq;
+    uint8_t _rx_halves_done,  // Half buffers completed by the DMA (half/full transfer events)
+            _rx_halves_seen;  // Half buffer boundaries the buffer head has passed
+    void _rx_dma_begin();
+    void _rx_dma_start();
+    void _rx_dma_update();
+  #endif
+
+  #if ENABLED(SERIAL_STATS_RX_BUFFER_OVERRUNS)
+    uint32_t _rx_overruns = 0;  // Received bytes lost to a full buffer
+  #endif
 };
 
 typedef Serial1Class<MarlinSerial> MSerialT;
@@ -47,6 +47,52 @@
   #error "SERIAL_STATS_DROPPED_RX is not supported on STM32."
 #endif
 
+#if ENABLED(SERIAL_DMA_RX)
+  #if NOT_TARGET(STM32F1xx, STM32F4xx)
+    #error "SERIAL_DMA_RX is currently only supported on STM32F1 and STM32F4 hardware."
+  #elif ANY(USING_HW_SERIAL7, USING_HW_SERIAL8, USING_HW_SERIAL9, USING_HW_SERIAL10, USING_HW_SERIALLP1) || (defined(STM32F1xx) && ANY(USING_HW_SERIAL5, USING_HW_SERIAL6))
+    #error "SERIAL_DMA_RX has no receive DMA for one of the serial ports in use."
+  #elif ENABLED(MKS_WIFI) && defined(MKS_WIFI_SERIAL_NUM) && MKS_WIFI_SERIAL_NUM != 1
+    #error "SERIAL_DMA_RX requires MKS_WIFI on serial port 1 (USART1), the port whose receive DMA the WiFi upload takes over."
+  #endif
+
+  // A serial receive DMA can't be shared with the DMA of the SPI TFT or the SPI flash (MarlinSPI).
+  // The SPI is found from the SCK pin, as the STM32 core does.
+  #define _SCK_ON_SPI1(P) (P == PA5 || P == PB3)
+  #define _SCK_ON_SPI2(P) (P == PB10 || P == PB13)
+  #define _SCK_ON_SPI3(P) (P == PC10)
+  #if HAS_SPI_TFT && defined(TFT_SCK_PIN)
+    #define TFT_ON_SPI(N) _SCK_ON_SPI##N(TFT_SCK_PIN)
+  #else
+    #define TFT_ON_SPI(N) 0
+  #endif
+  #if ENABLED(SPI_FLASH) && defined(SPI_FLASH_SCK_PIN)
+    #define FLASH_ON_SPI(N) _SCK_ON_SPI##N(SPI_FLASH_SCK_PIN)
+  #else
+    #define FLASH_ON_SPI(N) 0
+  #endif
+
+  #ifdef STM32F1xx
+    #if USING_HW_SERIAL1 && DISABLED(MKS_WIFI) && (TFT_ON_SPI(2) || FLASH_ON_SPI(2))
+      #error "SERIAL_DMA_RX for serial port 1 uses DMA1 Channel 5, which the SPI TFT or SPI flash on SPI2 also uses."
+    #elif USING_HW_SERIAL3 && (TFT_ON_SPI(1) || FLASH_ON_SPI(1))
+      #error "SERIAL_DMA_RX for serial port 3 uses DMA1 Channel 3, which the SPI TFT or SPI flash on SPI1 also uses."
+    #endif
+  #else
+    #if USING_HW_SERIAL2 && (TFT_ON_SPI(3) || FLASH_ON_SPI(3))
+      #error "SERIAL_DMA_RX for serial port 2 uses DMA1 Stream 5, which the SPI TFT or SPI flash on SPI3 also uses."
+    #elif USING_HW_SERIAL4 && FLASH_ON_SPI(3)
+      #error "SERIAL_DMA_RX for serial port 4 uses DMA1 Stream 2, which the SPI flash on SPI3 also uses."
+    #endif
+  #endif
+
+  #undef _SCK_ON_SPI1
+  #undef _SCK_ON_SPI2
+  #undef _SCK_ON_SPI3
+  #undef TFT_ON_SPI
+  #undef FLASH_ON_SPI
+#endif
+
 #if ANY(TFT_COLOR_UI, TFT_LVGL_UI, TFT_CLASSIC_UI) && NOT_TARGET(STM32H7xx, STM32F4xx, STM32F1xx)
   #error "TFT_COLOR_UI, TFT_LVGL_UI and TFT_CLASSIC_UI are currently only supported on STM32H7, STM32F4 and STM32F1 hardware."
 #endif
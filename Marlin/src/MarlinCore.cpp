@@ -867,6 +867,9 @@ void idle(const bool no_stepper_sleep/*=false*/) {
   // Manage Fixed-time Motion Control
   TERN_(FT_MOTION, fxdTiCtrl.loop());
 
+  // Convert planner blocks into pre-computed step events
+  TERN_(STEP_STREAM, stepper.stream_fill());
+
   IDLE_DONE:
   TERN_(MARLIN_DEV_MODE, idle_depth--);
 
@@ -1335,7 +1338,7 @@ void setup() {
 
   TERN_(HAS_FANCHECK, fan_check.init());
 
-  f_mount(&FS_flash, DISK_FLASH, 1);
+  TERN_(HAS_MEDIA, f_mount(&FS_flash, DISK_FLASH, 1));
 
 //  SETUP_RUN(ui.init());
 
@@ -1652,8 +1655,8 @@ void setup() {
   #if ENABLED(EASYTHREED_UI)
     SETUP_RUN(easythreed_ui.init());
   #endif
-  
-  mks_wifi_init();
+
+  TERN_(MKS_WIFI, mks_wifi_init());
 
   #if HAS_TRINAMIC_CONFIG && DISABLED(PSU_DEFAULT_OFF)
     SETUP_RUN(test_tmc_connection());
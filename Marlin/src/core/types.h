@@ -1111,6 +1111,48 @@ public:
 
 };
 
+//
+// Mesh Z value. With COMPACT_MESH it is held as signed microns in 16 bits
+// (±32.767mm) with INT16_MIN standing in for NAN (an unmeasured point).
+// Reads convert to float so the leveling math is unchanged.
+//
+#if ENABLED(COMPACT_MESH)
+
+  struct mesh_z_t {
+    static constexpr int16_t z_nan = INT16_MIN;
+    static constexpr float z_scale = 1000.0f;
+
+    int16_t um;
+
+    mesh_z_t() = default;
+    explicit mesh_z_t(const float z) { um = to_store(z); }
+
+    // Round to the nearest micron, saturating at the ends of the range
+    static int16_t to_store(const float z) {
+      if (isnan(z)) return z_nan;
+      const long s = LROUND(z * z_scale);
+      return s <= z_nan ? int16_t(z_nan + 1) : s > INT16_MAX ? int16_t(INT16_MAX) : int16_t(s);
+    }
+    static float from_store(const int16_t s) { return s == z_nan ? NAN : s * (1.0f / z_scale); }
+
+    FI operator float() const { return from_store(um); }
+
+    // No integer conversions, so a mixed `cond ? z : 0` can't truncate to int
+    template<typename T, typename = typename Private::enable_if<Private::is_integral<T>::value>::type>
+    operator T() const = delete;
+
+    FI mesh_z_t& operator=(const float z)  { um = to_store(z); return *this; }
+    FI mesh_z_t& operator+=(const float z) { return *this = float(*this) + z; }
+    FI mesh_z_t& operator-=(const float z) { return *this = float(*this) - z; }
+    FI mesh_z_t& operator*=(const float z) { return *this = float(*this) * z; }
+  };
+
+#else
+
+  typedef float mesh_z_t;
+
+#endif
+
 #undef _RECIP
 #undef _ABS
 #undef _LS
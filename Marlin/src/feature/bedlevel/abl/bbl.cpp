@@ -42,8 +42,7 @@ xy_pos_t LevelingBilinear::grid_spacing,
          LevelingBilinear::grid_start;
 xy_float_t LevelingBilinear::grid_factor;
 bed_mesh_t LevelingBilinear::z_values;
-xy_pos_t LevelingBilinear::cached_rel;
-xy_int8_t LevelingBilinear::cached_g;
+bilinear_cell_t LevelingBilinear::cells[ABL_CELLS_X][ABL_CELLS_Y];
 
 /**
  * Extrapolate a single point from its neighbors
@@ -171,7 +170,7 @@ void LevelingBilinear::print_leveling_grid(const bed_mesh_t* _z_values/*=nullptr
 
   #define ABL_TEMP_POINTS_X (bedlevel_settings.bedlevel_points.x + 2)
   #define ABL_TEMP_POINTS_Y (bedlevel_settings.bedlevel_points.y + 2)
-  float LevelingBilinear::z_values_virt[ABL_GRID_POINTS_VIRT_X][ABL_GRID_POINTS_VIRT_Y];
+  mesh_z_t LevelingBilinear::z_values_virt[ABL_GRID_POINTS_VIRT_X][ABL_GRID_POINTS_VIRT_Y];
   xy_pos_t LevelingBilinear::grid_spacing_virt;
   xy_float_t LevelingBilinear::grid_factor_virt;
 
@@ -257,13 +256,6 @@ void LevelingBilinear::print_leveling_grid(const bed_mesh_t* _z_values/*=nullptr
 
 #endif // ABL_BILINEAR_SUBDIVISION
 
-// Refresh after other values have been updated
-void LevelingBilinear::refresh_bed_level() {
-  TERN_(ABL_BILINEAR_SUBDIVISION, subdivide_mesh());
-  cached_rel.x = cached_rel.y = -999.999;
-  cached_g.x = cached_g.y = -99;
-}
-
 #if ENABLED(ABL_BILINEAR_SUBDIVISION)
   #define ABL_BG_SPACING(A) grid_spacing_virt.A
   #define ABL_BG_FACTOR(A)  grid_factor_virt.A
@@ -278,88 +270,55 @@ void LevelingBilinear::refresh_bed_level() {
   #define ABL_BG_GRID(X,Y)  z_values[X][Y]
 #endif
 
-// Get the Z adjustment for non-linear bed leveling
-float LevelingBilinear::get_z_correction(const xy_pos_t &raw) {
-
-  static float z1, d2, z3, d4, L, D;
-
-  static xy_pos_t ratio;
-
-  // Whole units for the grid line indices. Constrained within bounds.
-  static xy_int8_t thisg, nextg;
-
-  // XY relative to the probed area
-  xy_pos_t rel = raw - grid_start.asFloat();
-
-  #if ENABLED(EXTRAPOLATE_BEYOND_GRID)
-    #define FAR_EDGE_OR_BOX 2   // Keep using the last grid box
-  #else
-    #define FAR_EDGE_OR_BOX 1   // Just use the grid far edge
-  #endif
-
-  if (cached_rel.x != rel.x) {
-    cached_rel.x = rel.x;
-    ratio.x = rel.x * ABL_BG_FACTOR(x);
-    const float gx = constrain(FLOOR(ratio.x), 0, ABL_BG_POINTS_X - (FAR_EDGE_OR_BOX));
-    ratio.x -= gx;      // Subtract whole to get the ratio within the grid box
-
-    #if DISABLED(EXTRAPOLATE_BEYOND_GRID)
-      // Beyond the grid maintain height at grid edges
-      NOLESS(ratio.x, 0); // Never <0 (>1 is ok when nextg.x==thisg.x)
-    #endif
-
-    thisg.x = gx;
-    nextg.x = _MIN(thisg.x + 1, ABL_BG_POINTS_X - 1);
-  }
-
-  if (cached_rel.y != rel.y || cached_g.x != thisg.x) {
-
-    if (cached_rel.y != rel.y) {
-      cached_rel.y = rel.y;
-      ratio.y = rel.y * ABL_BG_FACTOR(y);
-      const float gy = constrain(FLOOR(ratio.y), 0, ABL_BG_POINTS_Y - (FAR_EDGE_OR_BOX));
-      ratio.y -= gy;
+#if ENABLED(EXTRAPOLATE_BEYOND_GRID)
+  #define FAR_EDGE_OR_BOX 2   // Keep using the last grid box
+#else
+  #define FAR_EDGE_OR_BOX 1   // Just use the grid far edge
+#endif
 
-      #if DISABLED(EXTRAPOLATE_BEYOND_GRID)
-        // Beyond the grid maintain height at grid edges
-        NOLESS(ratio.y, 0); // Never < 0.0. (> 1.0 is ok when nextg.y==thisg.y.)
-      #endif
+// Refresh after other values have been updated
+void LevelingBilinear::refresh_bed_level() {
+  TERN_(ABL_BILINEAR_SUBDIVISION, subdivide_mesh());
 
-      thisg.y = gy;
-      nextg.y = _MIN(thisg.y + 1, ABL_BG_POINTS_Y - 1);
+  // Get the surface of each grid box from its corners
+  for (uint8_t x = 0; x < ABL_BG_POINTS_X; ++x) {
+    const uint8_t nx = _MIN(x + 1, ABL_BG_POINTS_X - 1);
+    for (uint8_t y = 0; y < ABL_BG_POINTS_Y; ++y) {
+      const uint8_t ny = _MIN(y + 1, ABL_BG_POINTS_Y - 1);
+      const float z1 = ABL_BG_GRID(x, y),         // left-front
+                  d2 = ABL_BG_GRID(x, ny) - z1,   // left-back (delta)
+                  z3 = ABL_BG_GRID(nx, y),        // right-front
+                  d4 = ABL_BG_GRID(nx, ny) - z3;  // right-back (delta)
+      cells[x][y] = { mesh_z_t(z1), mesh_z_t(z3 - z1), mesh_z_t(d2), mesh_z_t(d4 - d2) };
     }
+  }
+}
 
-    if (cached_g != thisg) {
-      cached_g = thisg;
-      // Z at the box corners
-      z1 = ABL_BG_GRID(thisg.x, thisg.y);       // left-front
-      d2 = ABL_BG_GRID(thisg.x, nextg.y) - z1;  // left-back (delta)
-      z3 = ABL_BG_GRID(nextg.x, thisg.y);       // right-front
-      d4 = ABL_BG_GRID(nextg.x, nextg.y) - z3;  // right-back (delta)
-    }
+// Get the Z adjustment for non-linear bed leveling
+float LevelingBilinear::get_z_correction(const xy_pos_t &raw) {
 
-    // Bilinear interpolate. Needed since rel.y or thisg.x has changed.
-                L = z1 + d2 * ratio.y;   // Linear interp. LF -> LB
-    const float R = z3 + d4 * ratio.y;   // Linear interp. RF -> RB
+  // XY relative to the probed area, in grid boxes
+  xy_float_t ratio = raw - grid_start.asFloat();
+  ratio.x *= ABL_BG_FACTOR(x);
+  ratio.y *= ABL_BG_FACTOR(y);
 
-    D = R - L;
-  }
+  // Whole units for the grid line indices. Constrained within bounds.
+  const int8_t gx = constrain(FLOOR(ratio.x), 0, ABL_BG_POINTS_X - (FAR_EDGE_OR_BOX)),
+               gy = constrain(FLOOR(ratio.y), 0, ABL_BG_POINTS_Y - (FAR_EDGE_OR_BOX));
 
-  const float offset = L + ratio.x * D;   // the offset almost always changes
+  // Subtract whole to get the ratio within the grid box
+  ratio.x -= gx;
+  ratio.y -= gy;
 
-  /*
-  static float last_offset = 0;
-  if (ABS(last_offset - offset) > 0.2) {
-    SERIAL_ECHOLNPGM("Sudden Shift at x=", rel.x, " / ", grid_spacing.x, " -> thisg.x=", thisg.x);
-    SERIAL_ECHOLNPGM(" y=", rel.y, " / ", grid_spacing.y, " -> thisg.y=", thisg.y);
-    SERIAL_ECHOLNPGM(" ratio.x=", ratio.x, " ratio.y=", ratio.y);
-    SERIAL_ECHOLNPGM(" z1=", z1, " z2=", z2, " z3=", z3, " z4=", z4);
-    SERIAL_ECHOLNPGM(" L=", L, " R=", R, " offset=", offset);
-  }
-  last_offset = offset;
-  //*/
+  #if DISABLED(EXTRAPOLATE_BEYOND_GRID)
+    // Beyond the grid maintain height at grid edges
+    NOLESS(ratio.x, 0); // Never <0 (>1 is ok on the far edge, which is flat)
+    NOLESS(ratio.y, 0);
+  #endif
 
-  return offset;
+  // Bilinear interpolate
+  const bilinear_cell_t &c = cells[gx][gy];
+  return c.z + ratio.x * c.dx + ratio.y * (c.dy + ratio.x * c.dxy);
 }
 
 #if IS_CARTESIAN && DISABLED(SEGMENT_LEVELED_MOVES)
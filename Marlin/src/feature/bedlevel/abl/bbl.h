@@ -23,6 +23,22 @@
 
 #include "../../../inc/MarlinConfigPre.h"
 
+#if ENABLED(ABL_BILINEAR_SUBDIVISION)
+  #define ABL_GRID_POINTS_VIRT_X (GRID_MAX_CELLS_X * (BILINEAR_SUBDIVISIONS) + 1)
+  #define ABL_GRID_POINTS_VIRT_Y (GRID_MAX_CELLS_Y * (BILINEAR_SUBDIVISIONS) + 1)
+  #define ABL_CELLS_X ABL_GRID_POINTS_VIRT_X
+  #define ABL_CELLS_Y ABL_GRID_POINTS_VIRT_Y
+#else
+  #define ABL_CELLS_X GRID_MAX_POINTS_X
+  #define ABL_CELLS_Y GRID_MAX_POINTS_Y
+#endif
+
+// Bilinear surface of one grid cell: z = z + dx * tx + dy * ty + dxy * tx * ty
+// where tx, ty are the position within the cell (0..1). The cells on the far
+// edges have no next grid line and keep their height beyond it.
+// With COMPACT_MESH the terms are held in microns, like the mesh itself.
+typedef struct { mesh_z_t z, dx, dy, dxy; } bilinear_cell_t;
+
 class LevelingBilinear {
 public:
   static bed_mesh_t z_values;
@@ -30,16 +46,13 @@ public:
 
 private:
   static xy_float_t grid_factor;
-  static xy_pos_t cached_rel;
-  static xy_int8_t cached_g;
+  static bilinear_cell_t cells[ABL_CELLS_X][ABL_CELLS_Y];
 
   static void extrapolate_one_point(const uint8_t x, const uint8_t y, const int8_t xdir, const int8_t ydir);
 
   #if ENABLED(ABL_BILINEAR_SUBDIVISION)
-    #define ABL_GRID_POINTS_VIRT_X (GRID_MAX_CELLS_X * (BILINEAR_SUBDIVISIONS) + 1)
-    #define ABL_GRID_POINTS_VIRT_Y (GRID_MAX_CELLS_Y * (BILINEAR_SUBDIVISIONS) + 1)
 
-    static float z_values_virt[ABL_GRID_POINTS_VIRT_X][ABL_GRID_POINTS_VIRT_Y];
+    static mesh_z_t z_values_virt[ABL_GRID_POINTS_VIRT_X][ABL_GRID_POINTS_VIRT_Y];
     static xy_pos_t grid_spacing_virt;
     static xy_float_t grid_factor_virt;
 
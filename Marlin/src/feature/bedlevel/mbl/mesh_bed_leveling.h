@@ -38,9 +38,9 @@ enum MeshLevelingState : char {
 class mesh_bed_leveling {
 public:
   static float z_offset,
-               z_values[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y],
                index_to_xpos[GRID_MAX_POINTS_X],
                index_to_ypos[GRID_MAX_POINTS_Y];
+  static bed_mesh_t z_values;
 
   mesh_bed_leveling();
 
@@ -1842,7 +1842,7 @@ void unified_bed_leveling::smart_fill_mesh() {
 
     param.KLS_storage_slot = (int8_t)parser.value_int();
 
-    float tmp_z_values[GRID_MAX_POINTS_X][GRID_MAX_POINTS_Y];
+    bed_mesh_t tmp_z_values;
     settings.load_mesh(param.KLS_storage_slot, &tmp_z_values);
 
     SERIAL_ECHOLNPGM("Subtracting mesh in slot ", param.KLS_storage_slot, " from current mesh.");
@@ -78,6 +78,8 @@ enum MeatPack_ConfigStateBits : uint8_t {
   MPConfig_Bit_NoSpaces = 1
 };
 
+extern const uint8_t meatPackLookupTable[16];
+
 class MeatPack {
 
   // Utility definitions
@@ -97,6 +99,12 @@ class MeatPack {
           full_char_count, // Counter for full-width characters to be received
           char_out_count;  // Stores number of characters to be read out.
   uint8_t char_out_buf[2]; // Output buffer for caching up to 2 characters
+  bool report;             // Report the state after each command? (Not for files.)
+
+  // Table character, with 'E' in place of ' ' when spaces are omitted
+  uint8_t lookup(const uint8_t chr) const {
+    return (chr == kSpaceCharIdx && TEST(state, MPConfig_Bit_NoSpaces)) ? kSpaceCharReplace : meatPackLookupTable[chr];
+  }
 
 public:
   // Pass in a character rx'd by SD card or serial. Automatically parses command/ctrl sequences,
@@ -118,7 +126,7 @@ public:
   void handle_output_char(const uint8_t c);
   void handle_rx_char_inner(const uint8_t c);
 
-  MeatPack() : cmd_is_next(false), state(0), second_char(0), cmd_count(0), full_char_count(0), char_out_count(0) {}
+  MeatPack(const bool report=true) : cmd_is_next(false), state(0), second_char(0), cmd_count(0), full_char_count(0), char_out_count(0), report(report) {}
 };
 
 // Implement the MeatPack serial class so it's transparent to rest of the code
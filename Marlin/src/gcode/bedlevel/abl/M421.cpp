@@ -59,7 +59,7 @@ void GcodeSuite::M421() {
               sy = iy >= 0 ? iy : 0, ey = iy >= 0 ? iy : bedlevel_settings.bedlevel_points.y - 1;
       for (uint8_t x = sx; x <= ex; ++x) {
         for (uint8_t y = sy; y <= ey; ++y) {
-          bedlevel.z_values[x][y] = zval + (hasQ ? bedlevel.z_values[x][y] : 0);
+          bedlevel.z_values[x][y] = zval + (hasQ ? bedlevel.z_values[x][y] : 0.0f);
           TERN_(EXTENSIBLE_UI, ExtUI::onMeshUpdate(x, y, bedlevel.z_values[x][y]));
         }
       }
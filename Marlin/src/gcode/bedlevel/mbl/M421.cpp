@@ -30,7 +30,7 @@
 
 #include "../../gcode.h"
 #include "../../../module/motion.h"
-#include "../../../feature/bedlevel/mbl/mesh_bed_leveling.h"
+#include "../../../feature/bedlevel/bedlevel.h"
 
 /**
  * M421: Set a single Mesh Bed Leveling Z coordinate
@@ -53,7 +53,7 @@ void GcodeSuite::M421() {
   else if (ix < 0 || iy < 0)
     SERIAL_ERROR_MSG(STR_ERR_MESH_XY);
   else
-    bedlevel.set_z(ix, iy, parser.value_linear_units() + (hasQ ? bedlevel.z_values[ix][iy] : 0));
+    bedlevel.set_z(ix, iy, parser.value_linear_units() + (hasQ ? bedlevel.z_values[ix][iy] : 0.0f));
 }
 
 #endif // MESH_BED_LEVELING
@@ -66,9 +66,9 @@ void GcodeSuite::M421() {
   else if (!WITHIN(ij.x, 0, .x - 1) || !WITHIN(ij.y, 0, bedlevel_settings.bedlevel_points.y - 1))
     SERIAL_ERROR_MSG(STR_ERR_MESH_XY);
   else {
-    float &zval = bedlevel.z_values[ij.x][ij.y];                          // Altering this Mesh Point
-    zval = hasN ? NAN : parser.value_linear_units() + (hasQ ? zval : 0);  // N=NAN, Z=NEWVAL, or Q=ADDVAL
-    TERN_(EXTENSIBLE_UI, ExtUI::onMeshUpdate(ij.x, ij.y, zval));          // Ping ExtUI in case it's showing the mesh
+    mesh_z_t &zval = bedlevel.z_values[ij.x][ij.y];                         // Altering this Mesh Point
+    zval = hasN ? NAN : parser.value_linear_units() + (hasQ ? zval : 0.0f);  // N=NAN, Z=NEWVAL, or Q=ADDVAL
+    TERN_(EXTENSIBLE_UI, ExtUI::onMeshUpdate(ij.x, ij.y, zval));            // Ping ExtUI in case it's showing the mesh
     TERN_(DWIN_LCD_PROUI, dwinMeshUpdate(ij.x, ij.y, zval));
   }
 }
@@ -22,6 +22,10 @@
 
 #include "../gcode.h"
 
+#if ENABLED(STEP_STREAM)
+  #include "../../module/stepper.h"
+#endif
+
 /**
  * M111: Set the debug level
  */
@@ -72,6 +76,10 @@ void GcodeSuite::M111() {
         SERIAL_ECHOPGM("\nMax RX Queue Size: ", MYSERIAL1.rxMaxEnqueued());
       #endif
     #endif // !__AVR__ || !USBCON
+
+    #if ENABLED(STEP_STREAM)
+      SERIAL_ECHOPGM("\nStep Stream Slowdowns: ", stepper.stream_slowdowns, " Stalls: ", stepper.stream_stalls);
+    #endif
   }
   SERIAL_EOL();
 }
@@ -32,14 +32,16 @@ void GcodeSuite::M593_report(const bool forReplay/*=true*/) {
   #if ENABLED(INPUT_SHAPING_X)
     SERIAL_ECHOLNPGM("  M593 X"
       " F", stepper.get_shaping_frequency(X_AXIS),
-      " D", stepper.get_shaping_damping_ratio(X_AXIS)
+      " D", stepper.get_shaping_damping_ratio(X_AXIS),
+      " T", stepper.get_shaping_type(X_AXIS)
     );
   #endif
   #if ENABLED(INPUT_SHAPING_Y)
     TERN_(INPUT_SHAPING_X, report_echo_start(forReplay));
     SERIAL_ECHOLNPGM("  M593 Y"
       " F", stepper.get_shaping_frequency(Y_AXIS),
-      " D", stepper.get_shaping_damping_ratio(Y_AXIS)
+      " D", stepper.get_shaping_damping_ratio(Y_AXIS),
+      " T", stepper.get_shaping_type(Y_AXIS)
     );
   #endif
 }
@@ -48,7 +50,8 @@ void GcodeSuite::M593_report(const bool forReplay/*=true*/) {
  * M593: Get or Set Input Shaping Parameters
  *  D<factor>    Set the zeta/damping factor. If axes (X, Y, etc.) are not specified, set for all axes.
  *  F<frequency> Set the frequency. If axes (X, Y, etc.) are not specified, set for all axes.
- *  T[map]       Input Shaping type, 0:ZV, 1:EI, 2:2H EI (not implemented yet)
+ *  T<type>      Input Shaping type, 0:ZV, 1:EI, 2:2H EI, 3:ZVD, 4:MZV.
+ *               Limited by SHAPING_MAX_IMPULSES: ZV has 2 impulses, 2H EI has 4, the others 3.
  *  X            Set the given parameters only for the X axis.
  *  Y            Set the given parameters only for the Y axis.
  */
@@ -60,6 +63,16 @@ void GcodeSuite::M593() {
              for_X = seen_X || TERN0(INPUT_SHAPING_X, (!seen_X && !seen_Y)),
              for_Y = seen_Y || TERN0(INPUT_SHAPING_Y, (!seen_X && !seen_Y));
 
+  if (parser.seen('T')) {
+    const uint8_t type = parser.value_byte();
+    if (type < NUM_SHAPERS && stepper.get_shaping_impulses(shaping_type_t(type)) <= SHAPING_MAX_IMPULSES) {
+      if (for_X) stepper.set_shaping_type(X_AXIS, shaping_type_t(type));
+      if (for_Y) stepper.set_shaping_type(Y_AXIS, shaping_type_t(type));
+    }
+    else
+      SERIAL_ECHO_MSG("?Type (T) not available. Check SHAPING_MAX_IMPULSES.");
+  }
+
   if (parser.seen('D')) {
     const float zeta = parser.value_float();
     if (WITHIN(zeta, 0, 1)) {
@@ -72,7 +85,7 @@ void GcodeSuite::M593() {
 
   if (parser.seen('F')) {
     const float freq = parser.value_float();
-    constexpr float min_freq = float(uint32_t(STEPPER_TIMER_RATE) / 2) / shaping_time_t(-2);
+    constexpr float min_freq = float(uint32_t(STEPPER_TIMER_RATE) / 2) * shaping_max_echoes / shaping_time_t(-2);
     if (freq == 0.0f || freq > min_freq) {
       if (for_X) stepper.set_shaping_frequency(X_AXIS, freq);
       if (for_Y) stepper.set_shaping_frequency(Y_AXIS, freq);
@@ -69,7 +69,9 @@ GcodeSuite gcode;
   #include "../feature/fancheck.h"
 #endif
 
-#include "../module/mks_wifi/mks_wifi_gcodes.h"
+#if ENABLED(MKS_WIFI)
+  #include "../module/mks_wifi/mks_wifi_gcodes.h"
+#endif
 
 #include "../MarlinCore.h" // for idle, kill
 
@@ -315,7 +317,9 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
   TERN_(HAS_FANCHECK, fan_check.check_deferred_error());
 
   KEEPALIVE_STATE(IN_HANDLER);
-  serial_index_t port = queue.ring_buffer.command_port();
+  #if ENABLED(MKS_WIFI)
+    const serial_index_t port = queue.ring_buffer.command_port();
+  #endif
 
  /**
   * Block all Gcodes except M511 Unlock Printer, if printer is locked
@@ -511,11 +515,13 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
       #if HAS_MEDIA
         case 20:                                                  // M20: List SD card
           DEBUG("Command M20 with param: %s", parser.string_arg);
+          #if ENABLED(MKS_WIFI)
           if(port.index == MKS_WIFI_SERIAL_NUM)
           {
             mks_m20(parser.string_arg);
           }
           else
+          #endif
           {
             M20();           
           }
@@ -532,21 +538,25 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
           break;                                                  // M24: Start SD print
         case 25: M25(); break;                                    // M25: Pause SD print
         case 26:
+          #if ENABLED(MKS_WIFI)
           if(port.index == MKS_WIFI_SERIAL_NUM)
           {
             mks_m26();                           // MKS M26: Stop printing
           }
           else
+          #endif
           {
             M26();                                                // M26: Set SD index
           }
           break;
         case 27:
+          #if ENABLED(MKS_WIFI)
           if(port.index == MKS_WIFI_SERIAL_NUM)
           {
             mks_m27();
           }
           else
+          #endif
           {
             M27();
           }
@@ -554,10 +564,13 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
         case 28: M28(); break;                                    // M28: Start SD write
         case 29: M29(); break;                                    // M29: Stop SD write
         case 30: M30();                                           // M30 <filename> Delete File
+          #if ENABLED(MKS_WIFI)
           if(port.index == MKS_WIFI_SERIAL_NUM)
           {
             mks_m30(parser.string_arg);
-          }else{
+          }else
+          #endif
+          {
             M30();           
           }
           break;
@@ -618,11 +631,13 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
       #endif
 
       case 105: 
+        #if ENABLED(MKS_WIFI)
         if(port.index == MKS_WIFI_SERIAL_NUM)
         {
           mks_m105();
         }
         else
+        #endif
         {
           M105(); 
         }
@@ -723,11 +738,13 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
       case 92: M92(); break;                                      // M92: Set the steps-per-unit for one or more axes
       case 114: M114(); break;                                    // M114: Report current position
       case 115: 
+        #if ENABLED(MKS_WIFI)
         if(port.index == MKS_WIFI_SERIAL_NUM)
         {
           mks_m115();
         }
         else
+        #endif
         {
           M115(); 
         }
@@ -1134,33 +1151,37 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
         case 995: M995(); break;                                  // M995: Touch screen calibration for TFT display
       #endif
 
-      case 991:
-        if(port.index == MKS_WIFI_SERIAL_NUM)
-        {
-          mks_m991();
-        };
-        return;
+      #if ENABLED(MKS_WIFI)
+        case 991:
+          if(port.index == MKS_WIFI_SERIAL_NUM)
+          {
+            mks_m991();
+          };
+          return;
 
-      case 992:
-        if(port.index == MKS_WIFI_SERIAL_NUM)
-        {
-          mks_m992();
-        };
-        return;
+        case 992:
+          if(port.index == MKS_WIFI_SERIAL_NUM)
+          {
+            mks_m992();
+          };
+          return;
 
-      case 994:
-        if(port.index == MKS_WIFI_SERIAL_NUM)
-        {
-          mks_m994();
-        };
-        return;
+        case 994:
+          if(port.index == MKS_WIFI_SERIAL_NUM)
+          {
+            mks_m994();
+          };
+          return;
+      #endif
 
       case 997: 
+        #if ENABLED(MKS_WIFI)
         if(port.index == MKS_WIFI_SERIAL_NUM)
         {
           mks_m997();
         }
         else
+        #endif
         {
           #if ENABLED(PLATFORM_M997_SUPPORT)
             M997();
@@ -1198,8 +1219,13 @@ void GcodeSuite::process_parsed_command(const bool no_ok/*=false*/) {
 
 
 
-      case 5000: M5000(); break;                                // M5000: Store parameters in .ini file
-      case 5001: M5001(); break;                                // M5001 - Load parameters from .ini file
+      #if HAS_MEDIA
+        case 5000: M5000(); break;                              // M5000: Store parameters in .ini file
+        case 5001: M5001(); break;                              // M5001 - Load parameters from .ini file
+      #endif
+      #if HAS_SD_SECTOR_CACHE
+        case 5010: M5010(); break;                              // M5010 - Report SD sector cache statistics
+      #endif
 
 
       default: parser.unknown_command_warning(); break;
@@ -1253,7 +1279,7 @@ void GcodeSuite::process_next_command() {
   }
 
   // Parse the next command in the queue
-  parser.parse(command.buffer);
+  parser.parse(command.buffer OPTARG(GCODE_PRETOKENIZE, queue.ring_buffer.peek_next_token()));
   process_parsed_command();
 }
 
@@ -331,6 +331,7 @@
  * 
  * M5000 - Store parameters in .ini file. 
  * M5001 - Load parameters from .ini file. 
+ * M5010 - Report SD sector cache statistics. (Requires SD_SECTOR_CACHE_SIZE)
  */
 
 #include "../inc/MarlinConfig.h"
@@ -1288,6 +1289,9 @@ private:
 
     static void M5000();
     static void M5001();
+    #if HAS_SD_SECTOR_CACHE
+      static void M5010();
+    #endif
 };
 
 extern GcodeSuite gcode;
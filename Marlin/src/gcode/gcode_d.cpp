@@ -250,6 +250,29 @@ void GcodeSuite::D(const int16_t dcode) {
         card.closefile();
       } break;
 
+      case 103: { // D103 Benchmark G-code line reads from the selected file (M23)
+        if (!card.isFileOpen() || card.isPrinting()) {
+          SERIAL_ECHOLNPGM("Select a file with M23 first.");
+          return;
+        }
+        card.setIndex(0);
+        uint32_t lines = 0, line_max_us = 0;
+        const uint32_t start_us = micros();
+        while (!card.eof()) {
+          const uint32_t line_us = micros();
+          int16_t n;
+          do { n = card.get(); } while (n >= 0 && !ISEOL(n) && !card.eof());
+          NOLESS(line_max_us, micros() - line_us);
+          lines++;
+          if (n < 0) { SERIAL_ECHOLNPGM(" Read error!"); break; }
+          if (!(lines & 0xFF)) hal.watchdog_refresh();
+        }
+        const uint32_t total_us = _MAX(micros() - start_us, 1UL), bytes = card.getIndex();
+        SERIAL_ECHOLNPGM("Read ", bytes, " bytes, ", lines, " lines in ", total_us / 1000, " ms");
+        SERIAL_ECHOLNPGM("Throughput ", uint32_t(uint64_t(bytes) * 1000000UL / total_us), " bytes/s, line avg ", total_us / _MAX(lines, 1UL), " us, max ", line_max_us, " us");
+        card.setIndex(0);
+      } break;
+
     #endif // HAS_MEDIA
 
     #if ENABLED(POSTMORTEM_DEBUGGING)
@@ -89,6 +89,7 @@ void GcodeSuite::M73() {
 #include "../gcode.h"
 #include "../../lcd/marlinui.h"
 #include "../../sd/cardreader.h"
+#include "../../module/printcounter.h"
 
 /**
  * M73: Set percentage complete and remaining time (for display on LCD)
@@ -29,6 +29,10 @@
 #include "../../module/planner.h"
 #include "../../module/temperature.h"
 
+#if ENABLED(ARC_BLOCKS)
+  #include "../../module/ft_motion.h"
+#endif
+
 #if ENABLED(DELTA)
   #include "../../module/delta.h"
 #elif ENABLED(SCARA)
@@ -202,6 +206,58 @@ void plan_arc(
   // Feedrate for the move, scaled by the feedrate multiplier
   const feedRate_t scaled_fr_mm_s = MMS_SCALED(feedrate_mm_s);
 
+  #if ENABLED(ARC_BLOCKS)
+    /**
+     * With Fixed-Time Motion active the arc goes to the planner as a few native arc blocks.
+     * The block steps hold the chord of each piece, and ft_motion traces the curve itself.
+     * Leveling needs the short segments, so it falls back to those, as do CoreXY arcs outside the XY plane.
+     */
+    if (fxdTiCtrl.cfg.mode && TERN1(HAS_LEVELING, !planner.leveling_active) && TERN1(CORE_IS_XY, axis_l == Z_AXIS)) {
+      const uint16_t pieces = CEIL(abs_angular_travel / RADIANS(ARC_BLOCK_MAX_SWEEP));
+      const float piece_mm = flat_mm / pieces;
+
+      PlannerHints hints(TERN(HAS_Z_AXIS, HYPOT(flat_mm, travel_L), flat_mm) / pieces);
+      hints.arc.sweep = angular_travel / pieces;
+      hints.arc.radius = radius;
+      hints.arc.axis_p = axis_p;
+      hints.arc.axis_q = axis_q;
+
+      // Same safe speed limits as the segments below
+      const float limiting_accel = _MIN(planner.settings.max_acceleration_mm_per_s2[axis_p], planner.settings.max_acceleration_mm_per_s2[axis_q]),
+                  limiting_speed = _MIN(planner.settings.max_feedrate_mm_s[axis_p], planner.settings.max_feedrate_mm_s[axis_q]),
+                  limiting_speed_sqr = _MIN(sq(limiting_speed), limiting_accel * radius, sq(scaled_fr_mm_s));
+
+      xyze_pos_t raw = current_position;
+      for (uint16_t i = 1; i <= pieces; i++) {
+        hints.arc.offset = -rvec;     // Center relative to the start of the piece
+
+        if (i < pieces) {
+          const float Ti = i * hints.arc.sweep, cos_Ti = cos(Ti), sin_Ti = sin(Ti);
+          rvec.a = -offset[0] * cos_Ti + offset[1] * sin_Ti;
+          rvec.b = -offset[0] * sin_Ti - offset[1] * cos_Ti;
+          raw[axis_p] = center_P + rvec.a;
+          raw[axis_q] = center_Q + rvec.b;
+          ARC_LIJKUVWE_CODE(
+            raw[axis_l] += travel_L / pieces,
+            raw.i += travel_I / pieces, raw.j += travel_J / pieces, raw.k += travel_K / pieces,
+            raw.u += travel_U / pieces, raw.v += travel_V / pieces, raw.w += travel_W / pieces,
+            raw.e += travel_E / pieces
+          );
+        }
+        else
+          raw = cart;
+
+        apply_motion_limits(raw);
+
+        hints.safe_exit_speed_sqr = _MIN(limiting_speed_sqr, 2 * limiting_accel * piece_mm * (pieces - i));
+        if (!planner.buffer_line(raw, scaled_fr_mm_s, active_extruder, hints)) break;
+      }
+
+      current_position = raw;
+      return;
+    }
+  #endif
+
   // Get the ideal segment length for the move based on settings
   const float ideal_segment_mm = (
     #if ARC_SEGMENTS_PER_SEC  // Length based on segments per second and feedrate
@@ -67,9 +67,77 @@ uint16_t GCodeParser::codenum;
   char *GCodeParser::command_args; // start of parameters
 #endif
 
+#if ENABLED(GCODE_PRETOKENIZE)
+  uint32_t GCodeParser::valbits;   // values from the token
+  float GCodeParser::values[26];   // parameter values from the token
+  uint8_t GCodeParser::value_ind;  // parameter last found by seen()
+#endif
+
 // Create a global instance of the GCode parser singleton
 GCodeParser parser;
 
+/**
+ * Convert a decimal number to float, stopping at 'E' or 'X' to prevent
+ * scientific notation or hex interpretation.
+ *
+ * Numbers from slicers have few significant digits, so the digits fit a
+ * float exactly and so does the power of ten that scales them. A single
+ * (correctly rounded) division then gives the same result as strtof.
+ * Longer numbers are handed to strtof.
+ */
+float GCodeParser::parse_float(char * const p) {
+  static const float pow10[] PROGMEM = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+  const char *d = p;
+  const bool neg = *d == '-';
+  if (neg || *d == '+') ++d;
+
+  uint32_t mant = 0;          // Significant digits
+  uint8_t digits = 0,         // Number of significant digits
+          zeros = 0,          // Fraction zeros not yet applied
+          scale = 0;          // Number of fraction digits applied
+
+  for (; NUMERIC(*d); ++d) {
+    if (mant || *d != '0') {
+      if (++digits > 9) goto slow;
+      mant = mant * 10 + (*d - '0');
+    }
+  }
+
+  if (*d == '.') {
+    for (++d; NUMERIC(*d); ++d) {
+      if (*d == '0') { ++zeros; continue; }
+      // Apply pending zeros only when a non-zero digit follows them
+      scale += zeros + 1;
+      if (mant) digits += zeros;
+      if (++digits > 9) goto slow;
+      for (; zeros; --zeros) mant *= 10;
+      mant = mant * 10 + (*d - '0');
+    }
+  }
+
+  if (mant < _BV32(24) && scale < COUNT(pow10)) {
+    float f = mant;
+    if (scale) f /= pgm_read_float(&pow10[scale]);
+    return neg ? -f : f;
+  }
+
+  slow:
+  char *e = p;
+  for (;;) {
+    const char c = *e;
+    if (c == '\0' || c == ' ') break;
+    if (c == 'E' || c == 'e' || c == 'X' || c == 'x') {
+      *e = '\0';
+      const float ret = strtof(p, nullptr);
+      *e = c;
+      return ret;
+    }
+    ++e;
+  }
+  return strtof(p, nullptr);
+}
+
 /**
  * Clear all code-seen (and value pointers)
  *
@@ -85,6 +153,7 @@ void GCodeParser::reset() {
     codebits = 0;                       // No codes yet
     //ZERO(param);                      // No parameters (should be safe to comment out this line)
   #endif
+  TERN_(GCODE_PRETOKENIZE, valbits = 0); // No values from a token
 }
 
 #if ENABLED(GCODE_QUOTED_STRINGS)
@@ -365,6 +434,114 @@ void GCodeParser::parse(char *p) {
   }
 }
 
+#if ENABLED(GCODE_PRETOKENIZE)
+
+  /**
+   * Tokenize a plain G0-G3 move as it goes into the queue, converting its
+   * parameter values ahead of time. Anything else, including moves with a
+   * parameter that needs the full parser (no value, repeated, lowercase,
+   * quoted, or too many), is left for parse() to handle at dispatch.
+   *
+   * This is called from idle() while other commands run, so it must not
+   * touch the parser state.
+   */
+  void GCodeParser::tokenize(char * const cmd, gcode_token_t &tok) {
+    tok.ready = false;
+
+    char *p = cmd;
+
+    // Skip spaces and N[-0-9]
+    while (*p == ' ') ++p;
+    if (*p == 'N' && NUMERIC_SIGNED(p[1])) {
+      p += 2;
+      while (NUMERIC(*p)) ++p;
+      while (*p == ' ') ++p;
+    }
+
+    char * const command = p;
+    if (*p++ != 'G') return;
+
+    // Nullify asterisk and trailing whitespace, same as parse()
+    char *starpos = strchr(p, '*');
+    if (starpos) {
+      --starpos;
+      while (*starpos == ' ') --starpos;
+      starpos[1] = '\0';
+    }
+
+    // G0, G1, G2, or G3 with no subcode
+    while (*p == ' ') ++p;
+    if (!NUMERIC(*p)) return;
+    uint8_t code = 0;
+    do {
+      code = code * 10 + *p++ - '0';
+      if (code > 3) return;
+    } while (NUMERIC(*p));
+    if (*p == '.') return;
+    while (*p == ' ') ++p;
+
+    char * const args = p;
+
+    // Each parameter is an uppercase letter with a number, seen only once
+    uint8_t count = 0;
+    uint32_t bits = 0;
+    while (const char param = *p++) {
+      if (!WITHIN(param, 'A', 'Z') || count >= GCODE_TOKEN_PARAMS) return;
+      const uint8_t ind = LETTER_BIT(param);
+      if (TEST32(bits, ind)) return;
+      SBI32(bits, ind);
+
+      while (*p == ' ') p++;
+      if (!valid_float(p)) return;
+
+      tok.letter[count] = ind;
+      tok.offset[count] = p - command;
+      tok.value[count] = parse_float(p);
+      count++;
+
+      while (*p && DECIMAL_SIGNED(*p)) p++;
+      while (*p == ' ') p++;
+    }
+
+    tok.command = command - cmd;
+    tok.args = args - command;
+    tok.codenum = code;
+    tok.count = count;
+    tok.ready = true;
+  }
+
+  /**
+   * Populate all fields from a token made by tokenize(),
+   * or parse the line the usual way if it wasn't tokenized.
+   */
+  void GCodeParser::parse(char * const p, const gcode_token_t &tok) {
+    if (!tok.ready) return parse(p);
+
+    reset();
+
+    command_ptr = p + tok.command;
+    command_letter = 'G';
+    codenum = tok.codenum;
+    command_args = command_ptr + tok.args;
+
+    for (uint8_t i = 0; i < tok.count; ++i) {
+      const uint8_t ind = tok.letter[i];
+      SBI32(codebits, ind);
+      param[ind] = tok.offset[i];
+      SBI32(valbits, ind);
+      values[ind] = tok.value[i];
+    }
+
+    #if ENABLED(GCODE_MOTION_MODES)
+      if (codenum <= TERN(ARC_SUPPORT, 3, 1)) {
+        motion_mode_codenum = codenum;
+        TERN_(USE_GCODE_SUBCODES, motion_mode_subcode = 0);
+      }
+    #endif
+  }
+
+#endif // GCODE_PRETOKENIZE
+
 #if ENABLED(CNC_COORDINATE_SYSTEMS)
 
   // Parse the next parameter as a new command
@@ -432,3 +609,90 @@ void GCodeParser::unknown_command_warning() {
   }
 
 #endif // DEBUG_GCODE_PARSER
+
+#if ENABLED(MARLIN_TEST_BUILD)
+
+  #ifdef __PLAT_LINUX__
+    #include <chrono>
+    // The replay's micros() is simulated time, so time the host
+    static uint32_t test_micros() {
+      return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+  #else
+    #define test_micros micros
+  #endif
+
+  static uint32_t test_rand(uint32_t &x) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; return x; }
+
+  /**
+   * Write a slicer-style number: an optional sign, up to 4 integer and 6 fraction
+   * digits, with extra zeros. Some are too long for the quick parse and some have
+   * an 'E' after them. Return the length without the 'E'.
+   */
+  static uint8_t test_number(char * const s, uint32_t &seed) {
+    const uint32_t r = test_rand(seed);
+    const bool is_long = r % 64 == 1;
+    const uint8_t idig = is_long ? 6 : (r >> 6) % 5,
+                  fdig = is_long ? 7 : (r >> 9) % 7;
+    char *p = s;
+    if (r % 8 == 0) *p++ = '-';
+    for (uint8_t i = 0; i < idig; ++i) *p++ = '0' + test_rand(seed) % 10;
+    if (fdig || !idig) {
+      *p++ = '.';
+      for (uint8_t i = 0; i < _MAX(fdig, 1); ++i) {
+        const uint32_t d = test_rand(seed);
+        *p++ = d % 4 ? '0' + (d >> 2) % 10 : '0';
+      }
+    }
+    const uint8_t len = p - s;
+    if (r % 16 == 2) { *p++ = 'E'; *p++ = '1'; }
+    *p = '\0';
+    return len;
+  }
+
+  /**
+   * Check parse_float and parse_int against strtof and strtol with 'count' random
+   * numbers, then time them on a small set of numbers. Report on the serial port.
+   */
+  void GCodeParser::test_numbers(const uint32_t count) {
+    char s[20], ref[20];
+    uint32_t seed = 1, float_bad = 0, int_bad = 0;
+    for (uint32_t n = 0; n < count; ++n) {
+      const uint8_t len = test_number(s, seed);
+      memcpy(ref, s, len); ref[len] = '\0';   // parse_float stops at 'E'
+      const float f = parse_float(s), g = strtof(ref, nullptr);
+      if (memcmp(&f, &g, sizeof(f)) && ++float_bad <= 5)
+        SERIAL_ECHOLNPGM("parse_float(", s, ") = ", p_float_t(f, 9), " strtof = ", p_float_t(g, 9));
+      int32_t v;
+      if (parse_int(s, v) && v != strtol(s, nullptr, 10) && ++int_bad <= 5)
+        SERIAL_ECHOLNPGM("parse_int(", s, ") = ", v, " strtol = ", strtol(s, nullptr, 10));
+    }
+
+    static char set[32][20];
+    seed = 1;
+    for (auto &t : set) t[test_number(t, seed)] = '\0';
+    const uint32_t reps = _MAX(count / 4 / COUNT(set), 1U);
+    const float per = 1000.0f / (reps * COUNT(set)); // ns per number
+    volatile float fsink;
+    volatile int32_t isink;
+    uint32_t us[4];
+
+    #define _TIME(N, CODE) do{ \
+      const uint32_t t0 = test_micros(); \
+      for (uint32_t r = reps; r--;) for (auto &t : set) { CODE; } \
+      us[N] = test_micros() - t0; \
+    }while(0)
+
+    _TIME(0, fsink = parse_float(t));
+    _TIME(1, fsink = strtof(t, nullptr));
+    _TIME(2, int32_t v; isink = parse_int(t, v) ? v : strtol(t, nullptr, 10));
+    _TIME(3, isink = strtol(t, nullptr, 10));
+    UNUSED(fsink); UNUSED(isink);
+
+    SERIAL_ECHOLNPGM("parse_float: ", count, " numbers, ", float_bad, " differ from strtof. ",
+                     p_float_t(us[0] * per, 1), " ns vs. ", p_float_t(us[1] * per, 1), " ns per number.");
+    SERIAL_ECHOLNPGM("parse_int: ", count, " numbers, ", int_bad, " differ from strtol. ",
+                     p_float_t(us[2] * per, 1), " ns vs. ", p_float_t(us[3] * per, 1), " ns per number.");
+  }
+
+#endif // MARLIN_TEST_BUILD
@@ -42,6 +42,23 @@
   typedef enum : uint8_t { LINEARUNIT_MM, LINEARUNIT_INCH } LinearUnit;
 #endif
 
+#if ENABLED(GCODE_PRETOKENIZE)
+  /**
+   * A G0-G3 move tokenized as it was queued, so dispatch can skip the
+   * parse and the string-to-float conversion of its parameters.
+   */
+  typedef struct {
+    bool ready;                                 // Tokenized? Otherwise parse the line at dispatch.
+    uint8_t command,                            // Offset of the command letter in the line
+            args,                               // Offset of the first parameter
+            codenum,                            // G-code number
+            count;                              // Number of parameters
+    uint8_t letter[GCODE_TOKEN_PARAMS],         // Parameter letter index (0-25)
+            offset[GCODE_TOKEN_PARAMS];         // Value offset from the command letter
+    float value[GCODE_TOKEN_PARAMS];            // Parameter value
+  } gcode_token_t;
+#endif
+
 /**
  * GCode parser
  *
@@ -66,6 +83,28 @@ private:
     static char *command_args;      // Args start here, for slow scan
   #endif
 
+  #if ENABLED(GCODE_PRETOKENIZE)
+    static uint32_t valbits;        // Parameters with a value from the token
+    static float values[26];        // For A-Z, values from the token
+    static uint8_t value_ind;       // Parameter last found by seen()
+  #endif
+
+  // Decimal number to float. Short numbers, as slicers emit, are converted without strtof.
+  static float parse_float(char * const p);
+
+  // Decimal number to integer. Returns false if there are too many digits for a quick parse.
+  static bool parse_int(const char *p, int32_t &out) {
+    const bool neg = *p == '-';
+    if (neg || *p == '+') ++p;
+    int32_t v = 0;
+    for (uint8_t n = 0; NUMERIC(*p); ++p) {
+      if (++n > 9) return false;
+      v = v * 10 + (*p - '0');
+    }
+    out = neg ? -v : v;
+    return true;
+  }
+
 public:
 
   // Global states for GCode-level units features
@@ -102,6 +141,10 @@ public:
     static void debug();
   #endif
 
+  #if ENABLED(MARLIN_TEST_BUILD)
+    static void test_numbers(const uint32_t count);
+  #endif
+
   // Reset is done before parsing
   static void reset();
 
@@ -154,6 +197,7 @@ public:
         }
         else
           value_ptr = nullptr;
+        TERN_(GCODE_PRETOKENIZE, value_ind = ind);
       }
       return b;
     }
@@ -238,6 +282,14 @@ public:
   // This uses 54 bytes of SRAM to speed up seen/value
   static void parse(char * p);
 
+  #if ENABLED(GCODE_PRETOKENIZE)
+    // Tokenize a G0-G3 move being queued. Leaves the parser state alone.
+    static void tokenize(char * const cmd, gcode_token_t &tok);
+
+    // Populate all fields from a token, or by parsing the line if it has none
+    static void parse(char * const p, const gcode_token_t &tok);
+  #endif
+
   #if ENABLED(CNC_COORDINATE_SYSTEMS)
     // Parse the next parameter as a new command
     static bool chain();
@@ -258,24 +310,23 @@ public:
   // Float removes 'E' to prevent scientific notation interpretation
   static float value_float() {
     if (!value_ptr) return 0;
-    char *e = value_ptr;
-    for (;;) {
-      const char c = *e;
-      if (c == '\0' || c == ' ') break;
-      if (c == 'E' || c == 'e' || c == 'X' || c == 'x') {
-        *e = '\0';
-        const float ret = strtof(value_ptr, nullptr);
-        *e = c;
-        return ret;
-      }
-      ++e;
-    }
-    return strtof(value_ptr, nullptr);
+    #if ENABLED(GCODE_PRETOKENIZE)
+      if (TEST32(valbits, value_ind)) return values[value_ind];
+    #endif
+    return parse_float(value_ptr);
   }
 
   // Code value as a long or ulong
-  static int32_t value_long() { return value_ptr ? strtol(value_ptr, nullptr, 10) : 0L; }
-  static uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, nullptr, 10) : 0UL; }
+  static int32_t value_long() {
+    if (!value_ptr) return 0L;
+    int32_t v;
+    return parse_int(value_ptr, v) ? v : strtol(value_ptr, nullptr, 10);
+  }
+  static uint32_t value_ulong() {
+    if (!value_ptr) return 0UL;
+    int32_t v;
+    return parse_int(value_ptr, v) ? uint32_t(v) : strtoul(value_ptr, nullptr, 10);
+  }
 
   // Code value for use as time
   static millis_t value_millis() { return value_ulong(); }
@@ -99,28 +99,88 @@ PGM_P GCodeQueue::injected_commands_P; // = nullptr
  */
 char GCodeQueue::injected_commands[64]; // = { 0 }
 
-void GCodeQueue::RingBuffer::commit_command(const bool skip_ok
-  OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind/*=-1*/)
-) {
-  commands[index_w].skip_ok = skip_ok;
-  TERN_(HAS_MULTI_SERIAL, commands[index_w].port = serial_ind);
-  TERN_(POWER_LOSS_RECOVERY, recovery.commit_sdpos(index_w));
-  advance_pos(index_w, 1);
-}
+#if ENABLED(PACKED_COMMAND_QUEUE)
 
-/**
- * Copy a command from RAM into the main command buffer.
- * Return true if the command was successfully added.
- * Return false for a full buffer, or if the 'command' is a comment.
- */
-bool GCodeQueue::RingBuffer::enqueue(const char *cmd, const bool skip_ok/*=true*/
-  OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind/*=-1*/)
-) {
-  if (*cmd == ';' || length >= BUFSIZE) return false;
-  strcpy(commands[index_w].buffer, cmd);
-  commit_command(skip_ok OPTARG(HAS_MULTI_SERIAL, serial_ind));
-  return true;
-}
+  /**
+   * Copy a command from RAM into the main command buffer, taking only
+   * the bytes it needs. A command too long for MAX_CMD_SIZE is truncated.
+   * Return true if the command was successfully added.
+   * Return false for a full buffer, or if the 'command' is a comment.
+   */
+  bool GCodeQueue::RingBuffer::enqueue(const char *cmd, const bool skip_ok/*=true*/
+    OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind/*=-1*/)
+  ) {
+    if (*cmd == ';' || length >= BUFSIZE) return false;
+
+    const uint8_t len = strnlen(cmd, MAX_CMD_SIZE - 1);
+    const uint16_t size = sizeof(CommandLine) + len + 1;
+    const int32_t pos = place_for(size);
+    if (pos < 0) return false;
+
+    // Skipping the end of the buffer? Leave a marker for the reader.
+    if (pos != pos_w && pos_w < COMMAND_QUEUE_BYTES) data[pos_w] = 0;
+
+    CommandLine &command = *(CommandLine*)&data[pos];
+    command.size = size;
+    command.skip_ok = skip_ok;
+    TERN_(HAS_MULTI_SERIAL, command.port = serial_ind);
+    memcpy(command.buffer, cmd, len);
+    command.buffer[len] = '\0';
+
+    pos_w = pos + size;
+    TERN_(GCODE_PRETOKENIZE, GCodeParser::tokenize(command.buffer, tokens[index_w]));
+    TERN_(POWER_LOSS_RECOVERY, recovery.commit_sdpos(index_w));
+    advance_pos(index_w, 1);
+    return true;
+  }
+
+  /**
+   * Discard the command that was just processed
+   */
+  void GCodeQueue::RingBuffer::drop_command() {
+    if (!length) return;                          // Cleared by the command handler
+    const uint8_t size = peek_next_command().size;
+    advance_pos(index_r, -1);
+    if (!length)
+      pos_r = pos_w = 0;                          // Empty, so start over at the front
+    else {
+      pos_r += size;
+      if (pos_r >= COMMAND_QUEUE_BYTES || !data[pos_r]) pos_r = 0;  // Follow the writer to the front
+    }
+  }
+
+#else
+
+  void GCodeQueue::RingBuffer::commit_command(const bool skip_ok
+    OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind/*=-1*/)
+  ) {
+    commands[index_w].skip_ok = skip_ok;
+    TERN_(HAS_MULTI_SERIAL, commands[index_w].port = serial_ind);
+    TERN_(GCODE_PRETOKENIZE, GCodeParser::tokenize(commands[index_w].buffer, tokens[index_w]));
+    TERN_(POWER_LOSS_RECOVERY, recovery.commit_sdpos(index_w));
+    advance_pos(index_w, 1);
+  }
+
+  /**
+   * Copy a command from RAM into the main command buffer.
+   * Return true if the command was successfully added.
+   * Return false for a full buffer, or if the 'command' is a comment.
+   */
+  bool GCodeQueue::RingBuffer::enqueue(const char *cmd, const bool skip_ok/*=true*/
+    OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind/*=-1*/)
+  ) {
+    if (*cmd == ';' || length >= BUFSIZE) return false;
+    strcpy(commands[index_w].buffer, cmd);
+    commit_command(skip_ok OPTARG(HAS_MULTI_SERIAL, serial_ind));
+    return true;
+  }
+
+  /**
+   * Discard the command that was just processed
+   */
+  void GCodeQueue::RingBuffer::drop_command() { advance_pos(index_r, -1); }
+
+#endif // !PACKED_COMMAND_QUEUE
 
 /**
  * Enqueue with Serial Echo
@@ -246,7 +306,7 @@ void GCodeQueue::RingBuffer::ok_to_send() {
     // Start counting from the last command's execution
     last_command_time = millis();
   #endif
-  CommandLine &command = commands[index_r];
+  CommandLine &command = peek_next_command();
   #if HAS_MULTI_SERIAL
     const serial_index_t serial_ind = command.port;
     if (!serial_ind.valid()) return;              // Optimization here, skip processing if it's not going anywhere
@@ -456,10 +516,12 @@ void GCodeQueue::get_serial_commands() {
       Если данные от WIFI модуля пропускаем через парсер бинарного протокола. 
       текстовую часть с G-Code пропускаем дальше 
       */
-      if(p == MKS_WIFI_SERIAL_NUM){
-        mks_wifi_input(c);
-        continue;
-      };
+      #if ENABLED(MKS_WIFI)
+        if(p == MKS_WIFI_SERIAL_NUM){
+          mks_wifi_input(c);
+          continue;
+        };
+      #endif
 
       if (c < 0) {
         // This should never happen, let's log it
@@ -592,29 +654,37 @@ void GCodeQueue::get_serial_commands() {
     {
       const int16_t n = card.get();
       const bool card_eof = card.eof();
-      if (n < 0 && !card_eof) { SERIAL_ERROR_MSG(STR_SD_ERR_READ); continue; }
+      if (n < 0 && !card_eof) {
+        SERIAL_ERROR_MSG(STR_SD_ERR_READ);
+        if (card.flag.abort_sd_printing) break;       // The reader gave up on the file
+        continue;
+      }
 
-      CommandLine &command = ring_buffer.commands[ring_buffer.index_w];
+      #if ENABLED(PACKED_COMMAND_QUEUE)
+        static char sd_line[MAX_CMD_SIZE];          // Copied into the queue once complete
+      #else
+        char (&sd_line)[MAX_CMD_SIZE] = ring_buffer.commands[ring_buffer.index_w].buffer;
+      #endif
       const char sd_char = (char)n;
       const bool is_eol = ISEOL(sd_char);
       if (is_eol || card_eof) {
 
         // Reset stream state, terminate the buffer, and commit a non-empty command
         if (!is_eol && sd_count) ++sd_count;          // End of file with no newline
-        if (!process_line_done(sd_input_state, command.buffer, sd_count)) {
+        if (!process_line_done(sd_input_state, sd_line, sd_count)) {
 
           // M808 L saves the sdpos of the next line. M808 loops to a new sdpos.
-          TERN_(GCODE_REPEAT_MARKERS, repeat.early_parse_M808(command.buffer));
+          TERN_(GCODE_REPEAT_MARKERS, repeat.early_parse_M808(sd_line));
 
           #if DISABLED(PARK_HEAD_ON_PAUSE)
             // When M25 is non-blocking it can still suspend SD commands
             // Otherwise the M125 handler needs to know SD printing is active
-            if (command.buffer[0] == 'M' && command.buffer[1] == '2' && command.buffer[2] == '5' && !NUMERIC(command.buffer[3]))
+            if (sd_line[0] == 'M' && sd_line[1] == '2' && sd_line[2] == '5' && !NUMERIC(sd_line[3]))
               card.pauseSDPrint();
           #endif
 
           // Put the new command into the buffer (no "ok" sent)
-          ring_buffer.commit_command(true);
+          TERN(PACKED_COMMAND_QUEUE, ring_buffer.enqueue(sd_line, true), ring_buffer.commit_command(true));
 
           // Prime Power-Loss Recovery for the NEXT commit_command
           TERN_(POWER_LOSS_RECOVERY, recovery.cmd_sdpos = card.getIndex());
@@ -623,7 +693,7 @@ void GCodeQueue::get_serial_commands() {
         if (card.eof()) card.fileHasFinished();         // Handle end of file reached
       }
       else
-        process_stream_char(sd_char, sd_input_state, command.buffer, sd_count);
+        process_stream_char(sd_char, sd_input_state, sd_line, sd_count);
     }
   }
 
@@ -719,7 +789,7 @@ void GCodeQueue::advance() {
   #endif // HAS_MEDIA
 
   // The queue may be reset by a command handler or by code invoked by idle() within a handler
-  ring_buffer.advance_pos(ring_buffer.index_r, -1);
+  ring_buffer.drop_command();
 }
 
 #if ENABLED(BUFFER_MONITORING)
@@ -28,7 +28,13 @@
 
 #include "../inc/MarlinConfig.h"
 
-#include "../module/mks_wifi/mks_wifi.h"
+#if ENABLED(MKS_WIFI)
+  #include "../module/mks_wifi/mks_wifi.h"
+#endif
+
+#if ENABLED(GCODE_PRETOKENIZE)
+  #include "parser.h"
+#endif
 
 class GCodeQueue {
 public:
@@ -52,19 +58,39 @@ public:
   /**
    * GCode Command Queue
    * A simple (circular) ring buffer of BUFSIZE command strings.
+   * With PACKED_COMMAND_QUEUE up to BUFSIZE commands share COMMAND_QUEUE_BYTES.
    *
    * Commands are copied into this buffer by the command injectors
    * (immediate, serial, sd card) and they are processed sequentially by
    * the main loop. The gcode.process_next_command method parses the next
    * command and hands off execution to individual handler functions.
    */
-  struct CommandLine {
-    char buffer[MAX_CMD_SIZE];      //!< The command buffer
-    bool skip_ok;                   //!< Skip sending ok when command is processed?
-    #if HAS_MULTI_SERIAL
-      serial_index_t port;          //!< Serial port the command was received on
-    #endif
-  };
+  #if ENABLED(PACKED_COMMAND_QUEUE)
+
+    /**
+     * With PACKED_COMMAND_QUEUE each command is stored end-to-end in a byte
+     * ring at its actual length. This header is followed by the string.
+     */
+    struct CommandLine {
+      uint8_t size;                 //!< Bytes taken by this entry, header included. 0 marks a wrap to the front.
+      bool skip_ok;                 //!< Skip sending ok when command is processed?
+      #if HAS_MULTI_SERIAL
+        serial_index_t port;        //!< Serial port the command was received on
+      #endif
+      char buffer[];                //!< The command string
+    };
+
+  #else
+
+    struct CommandLine {
+      char buffer[MAX_CMD_SIZE];    //!< The command buffer
+      bool skip_ok;                 //!< Skip sending ok when command is processed?
+      #if HAS_MULTI_SERIAL
+        serial_index_t port;        //!< Serial port the command was received on
+      #endif
+    };
+
+  #endif
 
   /**
    * A handy ring buffer type
@@ -73,33 +99,76 @@ public:
     uint8_t length,                 //!< Number of commands in the queue
             index_r,                //!< Ring buffer's read position
             index_w;                //!< Ring buffer's write position
-    CommandLine commands[BUFSIZE];  //!< The ring buffer of commands
+    #if ENABLED(PACKED_COMMAND_QUEUE)
+      uint16_t pos_r,                 //!< Byte offset of the next command to read
+               pos_w;                 //!< Byte offset where the next command will be written
+      char data[COMMAND_QUEUE_BYTES]; //!< Commands packed end-to-end
+    #else
+      CommandLine commands[BUFSIZE];  //!< The ring buffer of commands
+    #endif
+    #if ENABLED(GCODE_PRETOKENIZE)
+      gcode_token_t tokens[BUFSIZE];  //!< Moves tokenized as they were queued
+    #endif
 
-    inline serial_index_t command_port() const { return TERN0(HAS_MULTI_SERIAL, commands[index_r].port); }
+    inline serial_index_t command_port() const { return TERN0(HAS_MULTI_SERIAL, peek_next_command().port); }
 
-    inline void clear() { length = index_r = index_w = 0; }
+    inline void clear() { length = index_r = index_w = 0; TERN_(PACKED_COMMAND_QUEUE, pos_r = pos_w = 0); }
 
     void advance_pos(uint8_t &p, const int inc) { if (++p >= BUFSIZE) p = 0; length += inc; }
 
-    void commit_command(const bool skip_ok
-      OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind = serial_index_t())
-    );
+    #if ENABLED(PACKED_COMMAND_QUEUE)
+
+      /**
+       * Byte offset where an entry of the given size would go, or -1 if it won't fit.
+       * An entry that won't fit before the end of the buffer goes to the front.
+       */
+      int32_t place_for(const uint16_t size) const {
+        if (!length) return size <= COMMAND_QUEUE_BYTES ? 0 : -1;
+        if (pos_w > pos_r) {
+          if (size <= COMMAND_QUEUE_BYTES - pos_w) return pos_w;
+          return size <= pos_r ? 0 : -1;
+        }
+        return size <= pos_r - pos_w ? pos_w : -1;
+      }
+
+    #else
+
+      void commit_command(const bool skip_ok
+        OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind = serial_index_t())
+      );
+
+    #endif
 
     bool enqueue(const char *cmd, const bool skip_ok=true
       OPTARG(HAS_MULTI_SERIAL, serial_index_t serial_ind = serial_index_t())
     );
 
+    void drop_command();
+
     void ok_to_send();
 
-    inline bool full(uint8_t cmdCount=4) const { return length > (BUFSIZE - cmdCount); }
+    // A packed queue is also full when a command of MAX_CMD_SIZE won't fit
+    inline bool full(uint8_t cmdCount=4) const {
+      return length > (BUFSIZE - cmdCount) || TERN0(PACKED_COMMAND_QUEUE, place_for(sizeof(CommandLine) + MAX_CMD_SIZE) < 0);
+    }
 
     inline bool occupied() const { return length != 0; }
 
     inline bool empty() const { return !occupied(); }
 
-    inline CommandLine& peek_next_command() { return commands[index_r]; }
+    #if ENABLED(PACKED_COMMAND_QUEUE)
+      inline CommandLine& peek_next_command() { return *(CommandLine*)&data[pos_r]; }
+      inline const CommandLine& peek_next_command() const { return *(const CommandLine*)&data[pos_r]; }
+    #else
+      inline CommandLine& peek_next_command() { return commands[index_r]; }
+      inline const CommandLine& peek_next_command() const { return commands[index_r]; }
+    #endif
 
     inline char* peek_next_command_string() { return peek_next_command().buffer; }
+
+    #if ENABLED(GCODE_PRETOKENIZE)
+      inline const gcode_token_t& peek_next_token() const { return tokens[index_r]; }
+    #endif
   };
 
   /**
@@ -42,7 +42,7 @@ void GcodeSuite::M21() {
     else if (vol == 1 || parser.seen_test('U'))  // "U" for USB
       card.changeMedia(&card.media_driver_usbFlash);
   #endif
-  card.mount();
+  card.mount(false, true);
 }
 
 /**
@@ -0,0 +1,44 @@
+/**
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if HAS_SD_SECTOR_CACHE
+
+#include "../gcode.h"
+#include "../../libs/fatfs/diskio.h"
+
+/**
+ * M5010 - Report SD sector cache statistics.
+ *
+ *  R - Reset the counters after the report
+ */
+void GcodeSuite::M5010()
+{
+  const uint32_t reads = sector_cache_stats.hits + sector_cache_stats.misses;
+
+  SERIAL_ECHOLNPGM("M5010: sectors ", SD_SECTOR_CACHE_SIZE,
+                   " hits ", sector_cache_stats.hits,
+                   " misses ", sector_cache_stats.misses,
+                   " hit rate ", reads ? uint32_t(uint64_t(sector_cache_stats.hits) * 100 / reads) : 0UL, "%");
+  SERIAL_ECHOLNPGM("M5010: data reads ", sector_cache_stats.bypassed,
+                   " updated by writes ", sector_cache_stats.updated);
+
+  if (parser.seen_test('R'))
+    sector_cache_stats = {};
+}
+
+#endif // HAS_SD_SECTOR_CACHE
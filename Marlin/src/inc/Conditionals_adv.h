@@ -833,6 +833,22 @@
   #define HAS_MEDIA_SUBCALLS 1
 #endif
 
+#if HAS_MEDIA && SD_READ_AHEAD_SECTORS > 0
+  #define HAS_SD_READ_AHEAD 1
+#endif
+#if HAS_MEDIA && SD_DIR_INDEX_SIZE > 0
+  #define HAS_SD_DIR_INDEX 1
+#endif
+#if HAS_MEDIA && SD_FSINFO_SCAN_SECTORS > 0
+  #define HAS_SD_FSINFO_SCAN 1
+#endif
+#if HAS_MEDIA && SD_SECTOR_CACHE_SIZE > 0
+  #define HAS_SD_SECTOR_CACHE 1
+#endif
+#if ENABLED(SD_BINARY_GCODE)
+  #define HEATSHRINK_STATIC_WINDOW_BITS 12  // The heatshrink window of binary G-code blocks
+#endif
+
 #if ANY(SHOW_PROGRESS_PERCENT, SHOW_ELAPSED_TIME, SHOW_REMAINING_TIME, SHOW_INTERACTION_TIME)
   #define HAS_EXTRA_PROGRESS 1
 #endif
@@ -1265,6 +1281,18 @@
 // Input shaping
 #if ANY(INPUT_SHAPING_X, INPUT_SHAPING_Y)
   #define HAS_ZV_SHAPING 1
+  #ifndef SHAPING_MAX_IMPULSES
+    #define SHAPING_MAX_IMPULSES 2
+  #endif
+  #ifndef SHAPING_V_TOL
+    #define SHAPING_V_TOL 0.05f
+  #endif
+  #if ENABLED(INPUT_SHAPING_X) && !defined(SHAPING_TYPE_X)
+    #define SHAPING_TYPE_X 0
+  #endif
+  #if ENABLED(INPUT_SHAPING_Y) && !defined(SHAPING_TYPE_Y)
+    #define SHAPING_TYPE_Y 0
+  #endif
 #endif
 
 // Toolchange Event G-code
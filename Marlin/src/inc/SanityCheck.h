@@ -254,6 +254,33 @@ static_assert(COUNT(arm) == LOGICAL_AXES, "AXIS_RELATIVE_MODES must contain " _L
   #error "SERIAL_XON_XOFF and SERIAL_STATS_* features not supported on USB-native AVR devices."
 #endif
 
+#if ENABLED(SERIAL_DMA_RX) && !defined(HAL_STM32)
+  #error "SERIAL_DMA_RX is only supported on the STM32 platform (HAL/STM32)."
+#endif
+
+#if ENABLED(PACKED_COMMAND_QUEUE)
+  #if !WITHIN(BUFSIZE, 4, 255)
+    #error "PACKED_COMMAND_QUEUE requires a BUFSIZE between 4 and 255."
+  #elif MAX_CMD_SIZE > 250
+    #error "PACKED_COMMAND_QUEUE requires a MAX_CMD_SIZE of 250 or less."
+  #elif !WITHIN(COMMAND_QUEUE_BYTES, 4 * (MAX_CMD_SIZE), 65535)
+    #error "COMMAND_QUEUE_BYTES must be between 4 * MAX_CMD_SIZE and 65535."
+  #endif
+#endif
+
+/**
+ * Pre-tokenized G-code
+ */
+#if ENABLED(GCODE_PRETOKENIZE)
+  #if DISABLED(FASTER_GCODE_PARSER)
+    #error "GCODE_PRETOKENIZE requires FASTER_GCODE_PARSER."
+  #elif !WITHIN(GCODE_TOKEN_PARAMS, 1, 26)
+    #error "GCODE_TOKEN_PARAMS must be between 1 and 26."
+  #elif MAX_CMD_SIZE > 255
+    #error "GCODE_PRETOKENIZE requires a MAX_CMD_SIZE of 255 or less."
+  #endif
+#endif
+
 /**
  * Multiple Stepper Drivers Per Axis
  */
@@ -419,6 +446,23 @@ static_assert(COUNT(arm) == LOGICAL_AXES, "AXIS_RELATIVE_MODES must contain " _L
 #endif
 #undef SD_CONNECTION_TYPICAL
 
+#if HAS_SD_READ_AHEAD && SD_READ_AHEAD_SECTORS > 32
+  #error "SD_READ_AHEAD_SECTORS must be 32 or smaller."
+#endif
+#if HAS_SD_DIR_INDEX && SD_DIR_INDEX_SIZE > 1024
+  #error "SD_DIR_INDEX_SIZE must be 1024 or smaller."
+#endif
+#if HAS_SD_SECTOR_CACHE && SD_SECTOR_CACHE_SIZE > 16
+  #error "SD_SECTOR_CACHE_SIZE must be 16 or smaller."
+#endif
+#if ENABLED(SD_BINARY_GCODE)
+  #if !HAS_MEDIA
+    #error "SD_BINARY_GCODE requires SD card support."
+  #elif defined(__AVR__)
+    #error "SD_BINARY_GCODE needs more SRAM than AVR boards have."
+  #endif
+#endif
+
 /**
  * SD File Sorting
  */
@@ -1567,6 +1611,16 @@ static_assert(COUNT(arm) == LOGICAL_AXES, "AXIS_RELATIVE_MODES must contain " _L
   #endif
 #endif
 
+#if ENABLED(COMPACT_MESH)
+  #if !HAS_MESH
+    #error "COMPACT_MESH requires MESH_BED_LEVELING, AUTO_BED_LEVELING_BILINEAR, or AUTO_BED_LEVELING_UBL."
+  #elif ENABLED(OPTIMIZED_MESH_STORAGE)
+    #error "OPTIMIZED_MESH_STORAGE is redundant with COMPACT_MESH. Disable one of them."
+  #elif ANY(DWIN_LCD_PROUI, DWIN_CREALITY_LCD_JYERSUI)
+    #error "COMPACT_MESH is not yet supported by DWIN_LCD_PROUI or DWIN_CREALITY_LCD_JYERSUI."
+  #endif
+#endif
+
 #if ENABLED(MESH_EDIT_GFX_OVERLAY)
   #if DISABLED(AUTO_BED_LEVELING_UBL)
     #error "MESH_EDIT_GFX_OVERLAY requires AUTO_BED_LEVELING_UBL."
@@ -4066,9 +4120,22 @@ static_assert(_PLUS_TEST(3), "DEFAULT_MAX_ACCELERATION values must be positive."
     #else
       static_assert(SHAPING_FREQ_X == SHAPING_FREQ_Y, "SHAPING_FREQ_X and SHAPING_FREQ_Y must be the same for COREXY / COREYX / MARKFORGED_*.");
       static_assert(SHAPING_ZETA_X == SHAPING_ZETA_Y, "SHAPING_ZETA_X and SHAPING_ZETA_Y must be the same for COREXY / COREYX / MARKFORGED_*.");
+      static_assert(SHAPING_TYPE_X == SHAPING_TYPE_Y, "SHAPING_TYPE_X and SHAPING_TYPE_Y must be the same for COREXY / COREYX / MARKFORGED_*.");
     #endif
   #endif
 
+  #if !WITHIN(SHAPING_MAX_IMPULSES, 2, 4)
+    #error "SHAPING_MAX_IMPULSES must be between 2 and 4."
+  #endif
+  #define _SHAPER_IMPULSES(T) ((T) == 0 ? 2 : (T) == 2 ? 4 : 3)
+  #if ENABLED(INPUT_SHAPING_X) && !(WITHIN(SHAPING_TYPE_X, 0, 4) && _SHAPER_IMPULSES(SHAPING_TYPE_X) <= SHAPING_MAX_IMPULSES)
+    #error "SHAPING_TYPE_X must be 0-4 and have no more than SHAPING_MAX_IMPULSES impulses."
+  #endif
+  #if ENABLED(INPUT_SHAPING_Y) && !(WITHIN(SHAPING_TYPE_Y, 0, 4) && _SHAPER_IMPULSES(SHAPING_TYPE_Y) <= SHAPING_MAX_IMPULSES)
+    #error "SHAPING_TYPE_Y must be 0-4 and have no more than SHAPING_MAX_IMPULSES impulses."
+  #endif
+  #undef _SHAPER_IMPULSES
+
   #ifdef SHAPING_MIN_FREQ
     static_assert((SHAPING_MIN_FREQ) > 0, "SHAPING_MIN_FREQ must be > 0.");
   #else
@@ -4099,6 +4166,66 @@ static_assert(_PLUS_TEST(3), "DEFAULT_MAX_ACCELERATION values must be positive."
 #if ALL(FT_MOTION, MIXING_EXTRUDER)
   #error "FT_MOTION does not currently support MIXING_EXTRUDER."
 #endif
+#if ENABLED(FTM_FIXED_POINT) && DISABLED(FT_MOTION)
+  #error "FTM_FIXED_POINT requires FT_MOTION."
+#endif
+#if ENABLED(FTM_LEVELING)
+  #if DISABLED(FT_MOTION)
+    #error "FTM_LEVELING requires FT_MOTION."
+  #elif NONE(MESH_BED_LEVELING, AUTO_BED_LEVELING_BILINEAR)
+    #error "FTM_LEVELING requires MESH_BED_LEVELING or AUTO_BED_LEVELING_BILINEAR."
+  #elif ANY(IS_KINEMATIC, CORE_IS_XZ, CORE_IS_YZ)
+    #error "FTM_LEVELING requires an independent Z axis."
+  #elif ENABLED(SKEW_CORRECTION)
+    #error "FTM_LEVELING is incompatible with SKEW_CORRECTION."
+  #endif
+#endif
+
+/**
+ * Native arc block limitations
+ */
+#if ENABLED(ARC_BLOCKS)
+  #if DISABLED(FT_MOTION)
+    #error "ARC_BLOCKS requires FT_MOTION."
+  #elif DISABLED(ARC_SUPPORT)
+    #error "ARC_BLOCKS requires ARC_SUPPORT."
+  #elif ANY(IS_KINEMATIC, CORE_IS_XZ, CORE_IS_YZ, MARKFORGED_XY, MARKFORGED_YX)
+    #error "ARC_BLOCKS is only for Cartesian and CoreXY machines."
+  #elif ENABLED(SKEW_CORRECTION)
+    #error "ARC_BLOCKS is incompatible with SKEW_CORRECTION."
+  #elif !WITHIN(ARC_BLOCK_MAX_SWEEP, 10, 180)
+    #error "ARC_BLOCK_MAX_SWEEP must be between 10 and 180."
+  #endif
+#endif
+
+/**
+ * Step Stream limitations
+ */
+#if ENABLED(STEP_STREAM)
+  #if ENABLED(FT_MOTION)
+    #error "STEP_STREAM is incompatible with FT_MOTION."
+  #elif ENABLED(LIN_ADVANCE)
+    #error "STEP_STREAM does not currently support LIN_ADVANCE."
+  #elif HAS_ZV_SHAPING
+    #error "STEP_STREAM does not currently support INPUT_SHAPING_[XY]."
+  #elif ENABLED(DIRECT_STEPPING)
+    #error "STEP_STREAM is incompatible with DIRECT_STEPPING."
+  #elif ENABLED(INTEGRATED_BABYSTEPPING)
+    #error "STEP_STREAM does not currently support INTEGRATED_BABYSTEPPING."
+  #elif ENABLED(ADAPTIVE_STEP_SMOOTHING)
+    #error "STEP_STREAM does not currently support ADAPTIVE_STEP_SMOOTHING."
+  #elif ENABLED(MIXING_EXTRUDER)
+    #error "STEP_STREAM does not currently support MIXING_EXTRUDER."
+  #elif ENABLED(LASER_FEATURE)
+    #error "STEP_STREAM does not currently support LASER_FEATURE."
+  #elif ENABLED(I2S_STEPPER_STREAM)
+    #error "STEP_STREAM is incompatible with I2S_STEPPER_STREAM."
+  #elif !WITHIN(STEP_STREAM_SIZE, 16, 4096)
+    #error "STEP_STREAM_SIZE must be between 16 and 4096."
+  #elif !WITHIN(STEP_STREAM_LOW_WATER, 1, STEP_STREAM_SIZE - 2)
+    #error "STEP_STREAM_LOW_WATER must be between 1 and STEP_STREAM_SIZE - 2."
+  #endif
+#endif
 
 // Multi-Stepping Limit
 static_assert(WITHIN(MULTISTEPPING_LIMIT, 1, 128) && IS_POWER_OF_2(MULTISTEPPING_LIMIT), "MULTISTEPPING_LIMIT must be 1, 2, 4, 8, 16, 32, 64, or 128.");
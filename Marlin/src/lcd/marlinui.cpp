@@ -80,7 +80,7 @@ constexpr uint8_t epps = ENCODER_PULSES_PER_STEP;
 #endif
 
 #if ENABLED(LCD_SET_PROGRESS_MANUALLY)
-#else
+#elif HAS_PRINT_PROGRESS
   MarlinUI::progress_t MarlinUI::progress_override; // = 0
   #if ENABLED(USE_M73_REMAINING_TIME)
     uint32_t MarlinUI::remaining_time;
@@ -292,7 +292,7 @@ void MarlinUI::init() {
   TERN_(HAS_ENCODER_ACTION, encoderDiff = 0);
 
   reset_status(); // Set welcome message
-  freeze_max_update_time = false;
+  TERN_(HAS_LCD_BRIGHTNESS, freeze_max_update_time = false);
 }
 
 #if HAS_WIRED_LCD
@@ -224,10 +224,20 @@ void change_Z_edit_mesh();
 #if ENABLED(MESH_EDIT_MENU)
 
   inline void refresh_planner() {
+    TERN_(AUTO_BED_LEVELING_BILINEAR, bedlevel.refresh_bed_level());
     set_current_from_steppers_for_axis(ALL_AXES_ENUM);
     sync_plan_position();
   }
 
+  #if ENABLED(COMPACT_MESH)
+    // The compact mesh has no float to point at, so edit a copy and store it back
+    static float mesh_edit_z;
+    void store_mesh_edit_z() {
+      bedlevel.z_values[xind][yind] = mesh_edit_z;
+      refresh_planner();
+    }
+  #endif
+
 
 
   void menu_edit_mesh() {
@@ -403,7 +413,12 @@ void change_Z_edit_mesh();
     // BACK_ITEM(MSG_BED_LEVELING);
     EDIT_ITEM(uint8, MSG_MESH_X, &xind, 0, (bedlevel_settings.bedlevel_points.x) - 1);
     EDIT_ITEM(uint8, MSG_MESH_Y, &yind, 0, (bedlevel_settings.bedlevel_points.x) - 1);
-    EDIT_ITEM_FAST(float43, MSG_MESH_EDIT_Z, &bedlevel.z_values[xind][yind], -(LCD_PROBE_Z_RANGE) * 0.5, (LCD_PROBE_Z_RANGE) * 0.5, refresh_planner);
+    #if ENABLED(COMPACT_MESH)
+      mesh_edit_z = bedlevel.z_values[xind][yind];
+      EDIT_ITEM_FAST(float43, MSG_MESH_EDIT_Z, &mesh_edit_z, -(LCD_PROBE_Z_RANGE) * 0.5, (LCD_PROBE_Z_RANGE) * 0.5, store_mesh_edit_z);
+    #else
+      EDIT_ITEM_FAST(float43, MSG_MESH_EDIT_Z, &bedlevel.z_values[xind][yind], -(LCD_PROBE_Z_RANGE) * 0.5, (LCD_PROBE_Z_RANGE) * 0.5, refresh_planner);
+    #endif
     END_MENU();
   }
 
@@ -32,6 +32,10 @@
 #include "../../sd/cardreader.h"
 #include "../tft/tft.h"
 
+#if ENABLED(THUMBNAILS_PREVIEW)
+  #include "../thumbnails.h"
+#endif
+
 void lcd_sd_updir() {
   ui.encoderPosition = card.cdup() ? ENCODER_STEPS_PER_MENU_ITEM : 0;
   encoderTopLine = 0;
@@ -55,12 +59,14 @@ void lcd_sd_updir() {
 #endif
 
 inline void sdcard_start_selected_file() {
+  TERN_(THUMBNAILS_PREVIEW, thumbnails.Cancel());
   card.openAndPrintFile(card.longest_filename());
   ui.return_to_status();
   ui.reset_status();
 }
 
 inline void sdcard_load_config_file() {
+  TERN_(THUMBNAILS_PREVIEW, thumbnails.Cancel());
   char str[512];
   sprintf(str, "M5001 %s", card.longest_filename());
   queue.enqueue_one(str);
@@ -135,7 +141,7 @@ void menu_media_filelist() {
   #endif
   if (card.isRootDir()) {
     #if !HAS_SD_DETECT
-      ACTION_ITEM(MSG_REFRESH, []{ encoderTopLine = 0; card.mount(); });
+      ACTION_ITEM(MSG_REFRESH, []{ encoderTopLine = 0; card.mount(false, true); });
     #endif
   }
   else if (card.isMounted())
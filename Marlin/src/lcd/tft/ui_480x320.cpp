@@ -60,6 +60,8 @@ void MarlinUI::tft_idle() {
 
   tft.queue.async();
 
+  TERN_(THUMBNAILS_PREVIEW, if (tft.queue.is_empty()) thumbnails.DrawThumbnailStep()); // Thumbnail is decoded a few lines per tick, between queued screen updates
+
   TERN_(TOUCH_SCREEN, if (tft.queue.is_empty()) touch.idle()); // Touch driver is not DMA-aware, so only check for touch controls after screen drawing is completed
 }
 
@@ -367,7 +369,7 @@ void MarlinUI::draw_status_screen() {
       if (elapsed.value > heating.value && (elapsed.value - heating.value) > 60)   // remain time only after 1 minute of printing (except heating time)
       {
         uint32_t  fsize = card.getFileSize();
-        uint32_t  freaded = card.getIndex();
+        uint32_t  freaded = card.getFilePos();
         float     bytes_per_sec = (float)freaded / (elapsed.value - heating.value);
         remain.value = (fsize - freaded) / bytes_per_sec;
         remain.toDigital(buffer);
@@ -665,18 +667,25 @@ void MenuItem_fileconfirm::draw_select_screen(const char * const string) {
       tft.add_text(tft_string.center(TFT_WIDTH), 0, COLOR_MENU_TEXT, tft_string);
     }
 
-    bool is_thumb = thumbnails.Open(card.longest_filename());
-    // card.openFileRead(card.filename);
-    // card.closefile();
-
-    if (is_thumb)
-    {
-      thumbnails.DrawThumbnail(5, 75, 230, 220);
-      thumbnails.Close();
-    }
-    else
+    if (!TERN0(THUMBNAILS_CACHE, thumbnails.DrawCachedThumbnail(card.longest_filename(), 5, 75, 230, 220)))
     {
-      thumbnails.DrawDefaultThumbnail(5, 75, 230, 220);
+      bool is_thumb = thumbnails.Open(card.longest_filename());
+      // card.openFileRead(card.filename);
+      // card.closefile();
+
+      if (is_thumb)
+      {
+        // the rest of the image is drawn from tft_idle()
+        if (!thumbnails.DrawThumbnail(5, 75, 230, 220))
+        {
+          thumbnails.Close();
+          thumbnails.DrawDefaultThumbnail(5, 75, 230, 220);
+        }
+      }
+      else
+      {
+        thumbnails.DrawDefaultThumbnail(5, 75, 230, 220);
+      }
     }
   #else  // ENABLED(THUMBNAILS_PREVIEW)
     uint16_t line = 1;
@@ -33,6 +33,10 @@
 #include "../../module/settings.h"
 #include "../../module/stepper.h"
 
+#if ENABLED(THUMBNAILS_PREVIEW)
+  #include "../thumbnails.h"
+#endif
+
 void menu_pause_option();
 
 static xy_uint_t cursor;
@@ -225,6 +229,8 @@ void MarlinUI::init_lcd() {
 }
 
 void MarlinUI::clear_lcd() {
+  TERN_(THUMBNAILS_PREVIEW, thumbnails.Cancel());
+
   #if ENABLED(TOUCH_SCREEN)
     touch.reset();
     draw_menu_navigation = false;
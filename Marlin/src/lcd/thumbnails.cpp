@@ -8,6 +8,11 @@
 #include "thumbnails.h"
 #include "tft/images/empty_tumbnail_img.h"
 
+#if ENABLED(THUMBNAILS_CACHE)
+  #include "../libs/crc16.h"
+  #include <stddef.h>
+#endif
+
 Thumbnails  thumbnails;
 
 
@@ -16,6 +21,11 @@ Thumbnails::Thumbnails()
 {
   memset(&decode_info, 0, sizeof(decode_info));
   decode_info.old_draw_y = -1;
+  #if ENABLED(THUMBNAILS_CACHE)
+    cache_key_valid = false;
+    cache_writing = false;
+    cache_stamp = 0;
+  #endif
 }
 
 
@@ -28,6 +38,8 @@ bool    Thumbnails::Open(char *fname)
   int32_t           linereaded = 0;
   char              *tpos;
 
+  Cancel();
+
   if (!card.isFileOpen())
   {
     card.closefile();
@@ -42,15 +54,37 @@ bool    Thumbnails::Open(char *fname)
     return FALSE;
   }
 
+  #if ENABLED(SD_BINARY_GCODE)
+    // в бинарном G-коде превью - отдельный блок с PNG, он находится по заголовкам блоков
+    uint32_t  png_pos, png_size;
+    uint16_t  png_w, png_h;
+    if (BinaryGcode::find_thumbnail(THUMB_MIN_WIDTH, THUMB_MAX_WIDTH, png_pos, png_size, png_w, png_h))
+    {
+      if (png_size == 0)
+      {
+        card.closefile();
+        return FALSE;
+      }
+      decode_info.raw_png = true;
+      decode_info.img_width = png_w;
+      decode_info.img_height = png_h;
+      decode_info.img_base64_size = png_size;
+      decode_info.srcfile_begin_pos = png_pos;
+      base64_reset();
+      return TRUE;
+    }
+    card.setIndex(0);
+  #endif
+
   // ищем признаки встроенного предпросмотра
   for (uint32_t i = 0; i < 256; i++)
   {
-    linereaded = ReadLine(strbuff, 255);
+    linereaded = ReadLine(rawbuff, 255);
     if (linereaded == -1)
       return FALSE;
-    strbuff[linereaded] = 0;
+    rawbuff[linereaded] = 0;
 
-    tpos = strstr((char*)strbuff, TSTRING);
+    tpos = strstr((char*)rawbuff, TSTRING);
     if (tpos != NULL)
     {
       tpos += tstrlen;
@@ -71,6 +105,7 @@ bool    Thumbnails::Open(char *fname)
 
   // запоминаем позицию начала кодированного PNG в файле
   decode_info.srcfile_begin_pos = card.getIndex();
+  base64_reset();
 
   return TRUE;
 }
@@ -86,16 +121,20 @@ void    Thumbnails::Close()
   DEBUG("Thumbnails: closing");
 
   png.close();
-  card.closefile();
+
+  // файл мог быть уже заменен другим (M23, начало печати), его не трогаем
+  if (card.flag.thumbnail)
+    card.closefile();
 }
 
 
 
 
-void    Thumbnails::DrawThumbnail(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+// начинает вывод превью, дальше он идет порциями из DrawThumbnailStep()
+bool    Thumbnails::DrawThumbnail(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
   if (decode_info.img_base64_size == 0)
-    return;
+    return false;
 
   // вычисляем масштабирование
   float s1 = (float)decode_info.img_width / (float)w;
@@ -112,21 +151,283 @@ void    Thumbnails::DrawThumbnail(uint16_t x, uint16_t y, uint16_t w, uint16_t h
     x += (w - decode_info.draw_width) / 2;
   if (decode_info.draw_height < h)
     y += (h - decode_info.draw_height) / 2;
+  decode_info.draw_x = x;
+  decode_info.draw_y = y;
 
   int rc = png.open("", PNGOpen, PNGClose, PNGRead, PNGSeek, PNGDraw);
   if (rc != PNG_SUCCESS)
   {
+    return false;
+  }
+
+  if (png.decodeBegin(NULL, 0) != PNG_SUCCESS)
+  {
+    return false;
+  }
+
+  #if ENABLED(THUMBNAILS_CACHE)
+    if (cache_key_valid && cache_header.box_width == w && cache_header.box_height == h)
+      CacheBegin();
+  #endif
+  decode_info.drawing = true;
+  return true;
+}
+
+
+
+
+// выводит очередные THUMB_DRAW_LINES строк PNG, вызывается из MarlinUI::tft_idle()
+void    Thumbnails::DrawThumbnailStep()
+{
+  if (!decode_info.drawing)
+    return;
+
+  // файл мог быть закрыт, заменен другим или уже идет печать
+  if (!card.isFileOpen() || !card.flag.thumbnail || card.isPrinting())
+  {
+    Cancel();
     return;
   }
 
-  tft.set_window(x, y, x+decode_info.draw_width-1, y+decode_info.draw_height-1);
-  //    tft.set_window(x, y, x+w, y+h);
-  rc = png.decode(NULL, 0);
+  // между порциями на экран выводилось что-то другое, поэтому окно выставляется заново на оставшиеся строки
+  while (tft.is_busy());
+  const int32_t next_y = decode_info.old_draw_y + 1;
+  if (next_y < (int32_t)decode_info.draw_height)
+    tft.set_window(decode_info.draw_x, decode_info.draw_y + next_y, decode_info.draw_x + decode_info.draw_width - 1, decode_info.draw_y + decode_info.draw_height - 1);
+
+  if (png.decodeLines(THUMB_DRAW_LINES))
+    return;
+
+  // декодирование закончено
+  decode_info.drawing = false;
+  TERN_(THUMBNAILS_CACHE, CacheEnd(png.getLastError() == PNG_SUCCESS));
+  Close();
 }
 
 
 
 
+// прерывает незаконченный вывод превью
+void    Thumbnails::Cancel()
+{
+  if (!decode_info.drawing)
+    return;
+
+  decode_info.drawing = false;
+  png.decodeAbort();
+  TERN_(THUMBNAILS_CACHE, CacheEnd(false));
+  Close();
+}
+
+
+
+
+#if ENABLED(THUMBNAILS_CACHE)
+
+// формирует имя файла кэша из контрольных сумм пути файла и его размера, даты, времени
+bool    Thumbnails::CacheKey(char *fname, uint16_t w, uint16_t h)
+{
+  FILINFO   finfo;
+  char      curpath[256];
+  uint16_t  name_crc = 0, info_crc = 0;
+
+  cache_key_valid = false;
+  if (fname == NULL || f_stat(fname, &finfo) != FR_OK)
+    return FALSE;
+  if (f_getcwd(curpath, sizeof(curpath)) != FR_OK)
+    return FALSE;
+
+  memset(&cache_header, 0, sizeof(cache_header));
+  cache_header.magic = THUMB_CACHE_MAGIC;
+  cache_header.fsize = finfo.fsize;
+  cache_header.fdate = finfo.fdate;
+  cache_header.ftime = finfo.ftime;
+  cache_header.box_width = w;
+  cache_header.box_height = h;
+
+  crc16(&name_crc, curpath, strlen(curpath));
+  crc16(&name_crc, fname, strlen(fname));
+  crc16(&info_crc, &cache_header, sizeof(cache_header));
+  sprintf(cache_fname, THUMB_CACHE_DIR "/%04X%04X.bin", name_crc, info_crc);
+
+  cache_key_valid = true;
+  return TRUE;
+}
+
+
+
+
+// выводит готовое изображение из кэша, без декодирования PNG
+bool    Thumbnails::DrawCachedThumbnail(char *fname, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+  THUMB_CACHE_HEADER  header;
+  UINT                rd = 0;
+  uint16_t            *buff;
+  uint8_t             half = 0;
+
+  Cancel();
+
+  if (!CacheKey(fname, w, h))
+    return FALSE;
+
+  if (f_open(&cache_file, cache_fname, FA_READ) != FR_OK)
+    return FALSE;
+
+  // ключ в заголовке должен совпадать полностью, размер файла - соответствовать изображению
+  if (f_read(&cache_file, &header, sizeof(header), &rd) != FR_OK || rd != sizeof(header)
+    || memcmp(&header, &cache_header, offsetof(THUMB_CACHE_HEADER, draw_width)) != 0
+    || header.draw_width == 0 || header.draw_width > w
+    || header.draw_height == 0 || header.draw_height > h
+    || f_size(&cache_file) != sizeof(header) + (uint32_t)header.draw_width * header.draw_height * 2)
+  {
+    f_close(&cache_file);
+    return FALSE;
+  }
+
+  if (header.draw_width < w)
+    x += (w - header.draw_width) / 2;
+  if (header.draw_height < h)
+    y += (h - header.draw_height) / 2;
+
+  tft.set_window(x, y, x+header.draw_width-1, y+header.draw_height-1);
+
+  // читаем пиксели в одну половину буфера, пока DMA выводит на дисплей другую
+  while (1)
+  {
+    buff = linebuff + half * THUMB_MAX_WIDTH;
+    if (f_read(&cache_file, buff, THUMB_MAX_WIDTH * 2, &rd) != FR_OK || rd < 2)
+      break;
+    while (tft.is_busy());
+    tft.write_sequence(buff, rd / 2);
+    half ^= 1;
+  }
+  while (tft.is_busy());
+
+  f_close(&cache_file);
+  return TRUE;
+}
+
+
+
+
+// удаляет самые старые файлы кэша, пока их не станет меньше THUMBNAILS_CACHE_FILES
+// часов на плате нет, поэтому вместо даты файлы кэша помечаются порядковым номером (fdate:ftime),
+// самый старый файл - с наименьшим номером. Возвращает номер для нового файла
+uint32_t    Thumbnails::CachePrune()
+{
+  DIR       dir;
+  FILINFO   finfo;
+  char      oldest_name[13];
+  char      path[sizeof(THUMB_CACHE_DIR) + 13];
+
+  while (1)
+  {
+    uint32_t  oldest = 0xFFFFFFFF, newest = 0;
+    uint16_t  count = 0;
+
+    if (f_opendir(&dir, THUMB_CACHE_DIR) != FR_OK)
+      return 0;
+    while (f_readdir(&dir, &finfo) == FR_OK && finfo.fname[0] != 0)
+    {
+      // чужие файлы и папки не трогаем, имена файлов кэша - 8.3
+      if ((finfo.fattrib & AM_DIR) || strlen(finfo.fname) > 12)
+        continue;
+      uint32_t  stamp = ((uint32_t)finfo.fdate << 16) | finfo.ftime;
+      count++;
+      if (stamp < oldest)
+      {
+        oldest = stamp;
+        strcpy(oldest_name, finfo.fname);
+      }
+      if (stamp > newest)
+        newest = stamp;
+    }
+    f_closedir(&dir);
+
+    if (count < THUMBNAILS_CACHE_FILES)
+      return newest + 1;
+
+    sprintf(path, THUMB_CACHE_DIR "/%s", oldest_name);
+    if (f_unlink(path) != FR_OK)
+      return newest + 1;
+  }
+}
+
+
+
+
+void    Thumbnails::CacheBegin()
+{
+  THUMB_CACHE_HEADER  header;
+  UINT                wr = 0;
+
+  cache_writing = false;
+  cache_rows = 0;
+
+  FRESULT res = f_mkdir(THUMB_CACHE_DIR);
+  if (res == FR_OK)
+    f_chmod(THUMB_CACHE_DIR, AM_HID, AM_HID);
+  else if (res != FR_EXIST)
+    return;
+
+  cache_stamp = CachePrune();
+
+  if (f_open(&cache_file, cache_fname, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+    return;
+
+  // пока изображение не декодировано до конца, в заголовке нет сигнатуры
+  cache_header.draw_width = decode_info.draw_width;
+  cache_header.draw_height = decode_info.draw_height;
+  header = cache_header;
+  header.magic = 0;
+  if (f_write(&cache_file, &header, sizeof(header), &wr) != FR_OK || wr != sizeof(header))
+  {
+    f_close(&cache_file);
+    f_unlink(cache_fname);
+    return;
+  }
+
+  cache_writing = true;
+}
+
+
+
+
+void    Thumbnails::CacheEnd(bool decoded)
+{
+  UINT    wr = 0;
+
+  if (!cache_writing)
+    return;
+  cache_writing = false;
+
+  // из-за округления масштаба строк может получиться на одну меньше
+  if (cache_rows < cache_header.draw_height)
+    cache_header.draw_height = cache_rows;
+
+  if (decoded && cache_rows > 0
+    && f_lseek(&cache_file, 0) == FR_OK
+    && f_write(&cache_file, &cache_header, sizeof(cache_header), &wr) == FR_OK && wr == sizeof(cache_header))
+  {
+    f_close(&cache_file);
+
+    // порядковый номер файла для CachePrune()
+    FILINFO   finfo;
+    finfo.fdate = cache_stamp >> 16;
+    finfo.ftime = cache_stamp & 0xFFFF;
+    f_utime(cache_fname, &finfo);
+    return;
+  }
+
+  f_close(&cache_file);
+  f_unlink(cache_fname);
+}
+
+#endif  // ENABLED(THUMBNAILS_CACHE)
+
+
+
+
 void    Thumbnails::DrawDefaultThumbnail(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
   int rc = png.openFLASH((uint8_t*)empty_tumbnail_img, sizeof(empty_tumbnail_img), PNGDraw);
@@ -190,122 +491,169 @@ int32_t    Thumbnails::ReadLine(uint8_t* buff, uint32_t buffsize)
 
 
 
-void    Thumbnails::base64_decode_block(uint8_t *in, uint8_t *out )
-{   
-  out[0] = (uint8_t) (in[0] << 2 | in[1] >> 4);
-  out[1] = (uint8_t) (in[1] << 4 | in[2] >> 2);
-  out[2] = (uint8_t) (((in[2] << 6) & 0xc0) | in[3]);
+// таблица base64: 0..63 - значение символа, B64_PAD - '=', B64_SKIP - все остальное
+// (переводы строк, "; " в начале строк G-кода и т.п.)
+#define B64_PAD   0x40
+#define B64_SKIP  0x80
+
+static const uint8_t b64_table[256] = {
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,   62, 0x80, 0x80, 0x80,   63,  //  +  /
+    52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80,  // 0-9  =
+  0x80,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,  // A-O
+    15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0x80, 0x80, 0x80, 0x80, 0x80,  // P-Z
+  0x80,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,  // a-o
+    41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0x80, 0x80, 0x80, 0x80, 0x80,  // p-z
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+};
+
+
+
+
+// возврат декодера к началу закодированного PNG
+void    Thumbnails::base64_reset()
+{
+  card.setIndex(decode_info.srcfile_begin_pos);
+  decode_info.raw_pos = 0;
+  decode_info.raw_len = 0;
+  decode_info.remain_chars = decode_info.img_base64_size;
+  decode_info.imgfile_pos = 0;
+  decode_info.quad = 0;
+  decode_info.quad_len = 0;
+  decode_info.pend_pos = 0;
+  decode_info.pend_len = 0;
 }
 
 
 
 
-uint32_t    Thumbnails::base64_read(uint8_t* buff,	uint32_t size)
+// Потоковое декодирование base64 прямо в буфер PNGdec (или пропуск, если buff == NULL).
+// Текст читается из файла посекторно, обрамление комментариев G-кода
+// отбрасывается по таблице в том же проходе.
+uint32_t    Thumbnails::base64_read(uint8_t* buff, uint32_t size)
 {
-  static const char cd64[] = "|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
-  uint32_t	count = 0;
-  int16_t		rd;
+  DECODE_INFO   &di = decode_info;
+  uint32_t      count = 0;
+  uint32_t      quad = di.quad;
+  uint8_t       quad_len = di.quad_len;
+  uint8_t       v;
+
+  // PNG из бинарного G-кода лежит в файле как есть
+  if (di.raw_png)
+  {
+    NOMORE(size, di.remain_chars);
+    if (buff)
+    {
+      int32_t rd = card.read(buff, size);
+      if (rd <= 0)
+        return 0;
+      count = rd;
+    }
+    else
+    {
+      card.setIndex(card.getIndex() + size);
+      count = size;
+    }
+    di.remain_chars -= count;
+    di.imgfile_pos += count;
+    return count;
+  }
 
   while (count < size)
   {
-    // переносим декодированные данные в буфер JPEG
-    while (decode_info.buff_current_decpos < decode_info.buff_ready_decbytes)
+    // сначала отдаем байты, оставшиеся от прошлой четверки
+    if (di.pend_pos < di.pend_len)
     {
       if (buff)
-        buff[count] = binbuff[decode_info.buff_current_decpos];
+        buff[count] = di.pend[di.pend_pos];
+      di.pend_pos++;
       count++;
-      decode_info.buff_current_decpos++;
-      decode_info.imgfile_pos++;
-
-      if (count >= size)
-        break;
+      continue;
     }
-    if (count >= size)
-      break;
-
-    // читаем и декодируем из base64 очередную порцию
-    decode_info.buff_current_decpos = 0;
-    decode_info.buff_ready_decbytes = 0;
-    // считываем сырые данные
-    rd = card.read(strbuff + decode_info.remain_rawbytes, 240);
-    if (rd <= 0)
-      return 0;
-
-    decode_info.buff_readed_rawbytes = decode_info.remain_rawbytes + rd;
 
-    // чистим считанное от лишних символов (переводы строки, пробелы и т.п.)
-    uint32_t src_pos = 0, dst_pos = 0;
-    while (src_pos < decode_info.buff_readed_rawbytes)
+    if (di.remain_chars == 0)
     {
-      if ((strbuff[src_pos] > 47 && strbuff[src_pos] < 58)			// 0-9
-      || (strbuff[src_pos] > 64 && strbuff[src_pos] < 91)			// A-Z
-      || (strbuff[src_pos] > 96 && strbuff[src_pos] < 123)		// a-z
-      || strbuff[src_pos] == 43									// +
-      || strbuff[src_pos] == 47									// /
-      )
-      {
-        strbuff[dst_pos++] = strbuff[src_pos++];
-      }
-      else
+      // хвост перед '=' в конце изображения: 2 или 3 символа дают 1 или 2 байта
+      if (quad_len > 1)
       {
-        src_pos++;
+        quad <<= 6 * (4 - quad_len);
+        di.pend[0] = quad >> 16;
+        di.pend[1] = quad >> 8;
+        di.pend_pos = 0;
+        di.pend_len = quad_len - 1;
+        quad_len = 0;
+        continue;
       }
-
-    }
-    decode_info.buff_readed_rawbytes = dst_pos;
-    dst_pos = 0;
-    src_pos = 0;
-    if (decode_info.buff_readed_rawbytes > 3)
-    {
-      rd = decode_info.buff_readed_rawbytes >> 2;
-      rd <<= 2;
-      decode_info.remain_rawbytes = decode_info.buff_readed_rawbytes % 4;
+      break;
     }
-    else
+
+    // очередной сектор текста
+    if (di.raw_pos >= di.raw_len)
     {
-      rd = decode_info.buff_readed_rawbytes;
-      decode_info.remain_rawbytes = 0;
+      int32_t rd = card.read(rawbuff, THUMB_RAWBUFF_SIZE);
+      if (rd <= 0 || rd > THUMB_RAWBUFF_SIZE)
+        break;
+      di.raw_len = rd;
+      di.raw_pos = 0;
     }
 
-    // декодируем из base64
-    uint8_t		len = 0, i = 0, v = 0;
-    uint8_t		in[4];
-    uint8_t		out[3];
-    while(src_pos < (uint32_t)rd)
+    const uint8_t *src = rawbuff + di.raw_pos;
+    const uint8_t *end = rawbuff + di.raw_len;
+    uint32_t      chars = di.remain_chars;
+
+    // основной цикл: целые четверки пишутся сразу в выходной буфер
+    while (src < end && chars)
     {
-      for(len = 0, i = 0; i < 4 && src_pos < (uint32_t)rd; i++)
+      v = b64_table[*src++];
+      if (v & B64_SKIP)
+        continue;
+      chars--;
+      if (v == B64_PAD)
+        continue;
+
+      quad = (quad << 6) | v;
+      if (++quad_len < 4)
+        continue;
+      quad_len = 0;
+
+      if (count + 3 <= size)
       {
-        v = 0;
-        v = strbuff[src_pos++];
-        decode_info.buff_readed_rawbytes--;
-        v = cd64[ v - 43 ];
-        if( v != 0 )
+        if (buff)
         {
-          v = ((v == '$') ? 0 : v - 61);
-        }
-        len++;
-        if( v != 0 )
-        {
-          in[i] = v - 1;
+          buff[count] = quad >> 16;
+          buff[count + 1] = quad >> 8;
+          buff[count + 2] = quad;
         }
+        count += 3;
+        if (count == size)
+          break;
       }
-      if(len > 0)
+      else
       {
-        base64_decode_block( in, out );
-        for( i = 0; i < len - 1; i++ )
-        {
-          binbuff[dst_pos] = out[i];
-          dst_pos++;
-        }
-        decode_info.buff_ready_decbytes += len - 1;
+        di.pend[0] = quad >> 16;
+        di.pend[1] = quad >> 8;
+        di.pend[2] = quad;
+        di.pend_pos = 0;
+        di.pend_len = 3;
+        break;
       }
     }
-    if (decode_info.remain_rawbytes > 0)
-    {
-      memcpy(strbuff, strbuff+src_pos, decode_info.remain_rawbytes);
-    }
+
+    di.raw_pos = src - rawbuff;
+    di.remain_chars = chars;
   }
 
+  di.quad = quad;
+  di.quad_len = quad_len;
+  di.imgfile_pos += count;
   return count;
 }
 
@@ -314,7 +662,10 @@ uint32_t    Thumbnails::base64_read(uint8_t* buff,	uint32_t size)
 
 void*    Thumbnails::PNGOpen(const char *filename, int32_t *size)
 {
-  *size = thumbnails.decode_info.img_base64_size / 4 * 3;
+  if (thumbnails.decode_info.raw_png)
+    *size = thumbnails.decode_info.img_base64_size;
+  else
+    *size = thumbnails.decode_info.img_base64_size / 4 * 3;
   return &thumbnails.decode_info;
 }
 
@@ -351,13 +702,8 @@ int32_t    Thumbnails::PNGSeek(PNGFILE *handle, int32_t position)
   }
   else
   {
-    card.setIndex(thumbnails.decode_info.srcfile_begin_pos);
+    thumbnails.base64_reset();
     length = position;
-    thumbnails.decode_info.buff_current_decpos = 0;
-    thumbnails.decode_info.buff_ready_decbytes = 0;
-    thumbnails.decode_info.buff_readed_rawbytes = 0;
-    thumbnails.decode_info.imgfile_pos = 0;
-    thumbnails.decode_info.remain_rawbytes = 0;
   }
 
   thumbnails.base64_read(NULL, length);
@@ -397,6 +743,18 @@ void    Thumbnails::PNGDraw(PNGDRAW *pDraw)
     }
     thumbnails.decode_info.old_draw_y++;
     tft.write_sequence(dpixline, thumbnails.decode_info.draw_width);
+
+    #if ENABLED(THUMBNAILS_CACHE)
+      if (thumbnails.cache_writing && thumbnails.cache_rows < thumbnails.cache_header.draw_height)
+      {
+        UINT wr = 0;
+        const UINT rowsize = thumbnails.decode_info.draw_width * 2;
+        if (f_write(&thumbnails.cache_file, dpixline, rowsize, &wr) == FR_OK && wr == rowsize)
+          thumbnails.cache_rows++;
+        else
+          thumbnails.CacheEnd(false);
+      }
+    #endif
   }
 
 }
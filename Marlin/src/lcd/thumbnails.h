@@ -11,6 +11,29 @@
 
 #define     THUMB_MAX_WIDTH     640
 #define     THUMB_MIN_WIDTH     100
+#define     THUMB_RAWBUFF_SIZE  512         // one SD sector of base64 text per read
+#define     THUMB_DRAW_LINES    8           // PNG lines decoded per UI idle tick
+
+#if ENABLED(THUMBNAILS_CACHE)
+  #define   THUMB_CACHE_DIR     "0:/.thumbs"
+  #define   THUMB_CACHE_MAGIC   0x31485452    // "RTH1"
+  #ifndef THUMBNAILS_CACHE_FILES
+    #define THUMBNAILS_CACHE_FILES  100
+  #endif
+
+  // Header of the cached thumbnail file, followed by draw_width*draw_height RGB565 pixels
+  typedef struct
+  {
+    uint32_t  magic;
+    uint32_t  fsize;        // Source file size, date and time
+    uint16_t  fdate;
+    uint16_t  ftime;
+    uint16_t  box_width;    // Size of the area the thumbnail was scaled for
+    uint16_t  box_height;
+    uint16_t  draw_width;
+    uint16_t  draw_height;
+  } THUMB_CACHE_HEADER;
+#endif
 
 typedef struct
 {
@@ -18,13 +41,21 @@ typedef struct
   uint32_t  img_height;
   uint32_t  img_base64_size;
   uint32_t  srcfile_begin_pos;
-  uint32_t  buff_ready_decbytes;
-  uint32_t  buff_current_decpos;
-  uint32_t  buff_readed_rawbytes;
-  uint32_t  imgfile_pos;
-  uint32_t  remain_rawbytes;
+  uint32_t  raw_pos;              // read position in rawbuff
+  uint32_t  raw_len;              // bytes of base64 text in rawbuff
+  uint32_t  remain_chars;         // base64 characters left in the image
+  uint32_t  imgfile_pos;          // decoded PNG bytes handed out so far
+  uint32_t  quad;                 // bits of the base64 quad being assembled
+  uint8_t   quad_len;             // characters in quad
+  uint8_t   pend[3];              // decoded bytes not yet handed out
+  uint8_t   pend_pos;
+  uint8_t   pend_len;
+  bool      raw_png;              // PNG stored as is, not in base64 (binary G-code)
   uint32_t  draw_width;
   uint32_t  draw_height;
+  uint16_t  draw_x;               // top left corner of the thumbnail on screen
+  uint16_t  draw_y;
+  bool      drawing;              // decode started and not finished yet
   float     scale;
   int32_t   old_draw_y;
 } DECODE_INFO;
@@ -38,13 +69,12 @@ class Thumbnails
   DECODE_INFO   decode_info;
   PNG           png;
   uint16_t     	linebuff[THUMB_MAX_WIDTH*2];
-  uint8_t       strbuff[256];
-  uint8_t       binbuff[256];
+  uint8_t       rawbuff[THUMB_RAWBUFF_SIZE];
   bool          is_thumb;
 
   int32_t       ReadLine(uint8_t* buff, uint32_t buffsize);
+  void          base64_reset();
   uint32_t      base64_read(uint8_t* buff, uint32_t size);
-  void          base64_decode_block(uint8_t *in, uint8_t *out);
 
   static void*  PNGOpen(const char *filename, int32_t *size);
   static void   PNGClose(void *handle);
@@ -52,13 +82,34 @@ class Thumbnails
   static int32_t  PNGSeek(PNGFILE *handle, int32_t position);
   static void     PNGDraw(PNGDRAW *pDraw);
 
+  #if ENABLED(THUMBNAILS_CACHE)
+  FIL                 cache_file;
+  THUMB_CACHE_HEADER  cache_header;
+  char                cache_fname[24];
+  bool                cache_key_valid;
+  bool                cache_writing;
+  uint16_t            cache_rows;
+  uint32_t            cache_stamp;
+
+  bool          CacheKey(char *fname, uint16_t w, uint16_t h);
+  uint32_t      CachePrune();
+  void          CacheBegin();
+  void          CacheEnd(bool decoded);
+  #endif
+
   public:
   Thumbnails();
         
   bool          Open(char *fname);
   void          Close();
-  void          DrawThumbnail(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  bool          DrawThumbnail(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void          DrawThumbnailStep();
+  void          Cancel();
+  bool          IsDrawing() { return decode_info.drawing; }
   void          DrawDefaultThumbnail(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  #if ENABLED(THUMBNAILS_CACHE)
+  bool          DrawCachedThumbnail(char *fname, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  #endif
 
 };
 
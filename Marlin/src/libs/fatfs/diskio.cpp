@@ -9,6 +9,7 @@
 
 
 #include "diskio.h"		/* FatFs lower layer API */
+#include "fatfs_shared.h"
 
 volatile uint8_t __attribute__ ((aligned (4))) buf_copy[512];
 
@@ -17,6 +18,56 @@ volatile uint8_t __attribute__ ((aligned (4))) buf_copy[512];
 #define DEV_FLASH	1	/* Example: Map MMC/SD card to physical drive 1 */
 
 
+#if HAS_SD_SECTOR_CACHE
+/*-----------------------------------------------------------------------*/
+/* LRU cache of the sectors FatFs reads into its window                  */
+/*-----------------------------------------------------------------------*/
+/* Only single sector reads into FS_sd.win are cached: FAT, directory,   */
+/* boot and FSINFO sectors. File data goes to the file buffers or the    */
+/* caller's buffer and bypasses the cache. Writes go to the card and     */
+/* refresh a cached copy of the same sector.                             */
+
+typedef struct {
+	uint8_t	data[512];
+	DWORD	sector;
+	DWORD	stamp;			/* Last use, 0: entry is empty */
+} SECTOR_CACHE_ENTRY;
+
+static SECTOR_CACHE_ENTRY __attribute__ ((aligned (4))) sector_cache[SD_SECTOR_CACHE_SIZE];
+static DWORD sector_cache_clock;
+SECTOR_CACHE_STATS sector_cache_stats;
+
+static SECTOR_CACHE_ENTRY* sector_cache_find (DWORD sector)
+{
+	for (uint8_t i = 0; i < SD_SECTOR_CACHE_SIZE; i++)
+		if (sector_cache[i].stamp && sector_cache[i].sector == sector) return &sector_cache[i];
+	return 0;
+}
+
+static SECTOR_CACHE_ENTRY* sector_cache_victim (void)
+{
+	SECTOR_CACHE_ENTRY *e = &sector_cache[0];
+	for (uint8_t i = 1; i < SD_SECTOR_CACHE_SIZE && e->stamp; i++)
+		if (sector_cache[i].stamp < e->stamp) e = &sector_cache[i];
+	return e;
+}
+
+static void sector_cache_clear (void)
+{
+	for (uint8_t i = 0; i < SD_SECTOR_CACHE_SIZE; i++) sector_cache[i].stamp = 0;
+}
+
+static void sector_cache_drop (DWORD sector, UINT count)
+{
+	for (uint8_t i = 0; i < SD_SECTOR_CACHE_SIZE; i++)
+		if (sector_cache[i].sector - sector < count) sector_cache[i].stamp = 0;
+}
+#define SECTOR_CACHE_DROP(S,N)	sector_cache_drop(S, N)
+#else
+#define SECTOR_CACHE_DROP(S,N)
+#endif
+
+
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
 /*-----------------------------------------------------------------------*/
@@ -49,6 +100,9 @@ DSTATUS disk_initialize (
 	int result;
 		
 	if(pdrv == DEV_SD){
+		#if HAS_SD_SECTOR_CACHE
+			sector_cache_clear();		/* Maybe another card */
+		#endif
 		result=SD_Init();
 		if(result != 0)
 		{
@@ -75,6 +129,37 @@ DRESULT disk_read (
 uint8_t res=0;
 	
 	if(pdrv == DEV_SD){
+
+		#if HAS_SD_SECTOR_CACHE
+		if(count == 1 && buff == FS_sd.win)
+		{
+			SECTOR_CACHE_ENTRY *e = sector_cache_find(sector);
+			if(e)
+			{
+				sector_cache_stats.hits++;
+			}
+			else
+			{
+				sector_cache_stats.misses++;
+				e = sector_cache_victim();
+				e->stamp = 0;
+				res=SD_transfer(e->data, (uint32_t) sector, 1, SD2UM);
+				if(res != 0)
+				{
+					res=SD_transfer(e->data, (uint32_t) sector, 1, SD2UM);
+					if(res != 0)
+					{
+						return RES_ERROR;
+					};
+				};
+				e->sector = sector;
+			}
+			e->stamp = ++sector_cache_clock;
+			memcpy(buff, e->data, 512);
+			return RES_OK;
+		}
+		sector_cache_stats.bypassed++;
+		#endif
 	
 		if(((uint32_t)buff % 4) != 0)
 		{
@@ -128,9 +213,26 @@ DRESULT disk_write (
 )
 {
 	uint8_t res;
+	#if HAS_SD_SECTOR_CACHE
+	const DWORD first = sector;
+	const UINT total = count;
+	#endif
 
 	if(pdrv == DEV_SD)
 	{
+		#if HAS_SD_SECTOR_CACHE
+		/* Write-through: cached copies take the new data, dropped again if the write fails */
+		for (UINT i = 0; i < count; i++)
+		{
+			SECTOR_CACHE_ENTRY *e = sector_cache_find(sector + i);
+			if(e)
+			{
+				memcpy(e->data, buff + i * 512, 512);
+				sector_cache_stats.updated++;
+			}
+		}
+		#endif
+
 		if(((uint32_t)buff % 4) != 0)
 		{
 			DEBUG("Buffer not aligned");
@@ -144,6 +246,7 @@ DRESULT disk_write (
 					res=SD_transfer((uint8_t *)buf_copy, (uint32_t) sector, 1, UM2SD);
 					if(res != 0)
 					{
+						SECTOR_CACHE_DROP(first, total);
 						return RES_ERROR;
 					};
 				};
@@ -161,6 +264,7 @@ DRESULT disk_write (
 				res=SD_transfer((uint8_t *)buff, (uint32_t) sector, count, UM2SD);
 				if(res != 0)
 				{
+					SECTOR_CACHE_DROP(first, total);
 					return RES_ERROR;
 				};
 			};
@@ -48,6 +48,18 @@ DRESULT disk_read (BYTE pdrv, BYTE* buff, DWORD sector, UINT count);
 DRESULT disk_write (BYTE pdrv, const BYTE* buff, DWORD sector, UINT count);
 DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void* buff);
 
+#if HAS_SD_SECTOR_CACHE
+/* Counters of the FAT/directory sector cache */
+typedef struct {
+	uint32_t	hits;		/* Window reads served from RAM */
+	uint32_t	misses;		/* Window reads that went to the card */
+	uint32_t	bypassed;	/* File data reads, not cached */
+	uint32_t	updated;	/* Cached sectors refreshed by a write */
+} SECTOR_CACHE_STATS;
+
+extern SECTOR_CACHE_STATS sector_cache_stats;
+#endif
+
 
 /* Disk Status Bits (DSTATUS) */
 
@@ -1218,6 +1218,7 @@ static FRESULT put_fat (	/* FR_OK(0):succeeded, !=0:error */
 
 
 	if (clst >= 2 && clst < fs->n_fatent) {	/* Check if in valid range */
+		fs->fat_gen++;					/* Tell FAT readers outside FatFs that the FAT changed */
 		switch (fs->fs_type) {
 		case FS_FAT12:
 			bc = (UINT)clst; bc += bc / 2;	/* bc: byte offset of the entry */
@@ -4140,6 +4141,28 @@ FRESULT f_sync (
 	LEAVE_FF(fs, res);
 }
 
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Synchronize the Volume                                                */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_syncvol (
+	const TCHAR* path	/* Logical drive number */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+
+
+	res = mount_volume(&path, &fs, 0);	/* Get logical drive */
+	if (res == FR_OK) {
+		res = sync_fs(fs);				/* Flush the window and the FSINFO sector if dirty */
+	}
+	LEAVE_FF(fs, res);
+}
+
 #endif /* !FF_FS_READONLY */
 
 
@@ -4655,6 +4678,28 @@ FRESULT f_readdir (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Move Directory Read Pointer                                           */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_seekdir (
+	DIR* dp,			/* Pointer to the open directory object */
+	DWORD ofs			/* Byte offset of the entry, as found in dp->dptr before an f_readdir() */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+
+
+	res = validate(&dp->obj, &fs);	/* Check validity of the directory object */
+	if (res == FR_OK) {
+		res = dir_sdi(dp, ofs);		/* Next f_readdir() starts at this entry */
+	}
+	LEAVE_FF(fs, res);
+}
+
+
+
 #if FF_USE_FIND
 /*-----------------------------------------------------------------------*/
 /* Find Next File                                                        */
@@ -5526,8 +5571,14 @@ FRESULT f_expand (
 	} else
 #endif
 	{
+#if FF_EXPAND_MAX_SECT
+		DWORD nscan = (DWORD)FF_EXPAND_MAX_SECT * (SS(fs) / 4);	/* FAT entries to examine before giving up */
+#endif
 		scl = clst = stcl; ncl = 0;
 		for (;;) {	/* Find a contiguous cluster block */
+#if FF_EXPAND_MAX_SECT
+			if (nscan-- == 0) { res = FR_TIMEOUT; break; }	/* Search took too long */
+#endif
 			n = get_fat(&fp->obj, clst);
 			if (++clst >= fs->n_fatent) clst = 2;
 			if (n == 1) { res = FR_INT_ERR; break; }
@@ -34,15 +34,21 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_FASTSEEK	0
+#define FF_USE_FASTSEEK	1
 /* This option switches fast seek function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_EXPAND	0
+#define FF_USE_EXPAND	1
 /* This option switches f_expand function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_CHMOD	0
+#define FF_EXPAND_MAX_SECT	SD_PREALLOCATE_SCAN_SECTORS
+/* f_expand() on a FAT volume gives up with FR_TIMEOUT when no contiguous free area is
+/  found within this many FAT sectors of entries, to bound the time it blocks.
+/  (0 or undefined:No limit) */
+
+
+#define FF_USE_CHMOD	1
 /* This option switches attribute manipulation functions, f_chmod() and f_utime().
 /  (0:Disable or 1:Enable) Also FF_FS_READONLY needs to be 0 to enable this option. */
 
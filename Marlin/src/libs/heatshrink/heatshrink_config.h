@@ -15,7 +15,9 @@
 #else
   // Required parameters for static configuration
   #define HEATSHRINK_STATIC_INPUT_BUFFER_SIZE 32
-  #define HEATSHRINK_STATIC_WINDOW_BITS 8
+  #ifndef HEATSHRINK_STATIC_WINDOW_BITS
+    #define HEATSHRINK_STATIC_WINDOW_BITS 8
+  #endif
   #define HEATSHRINK_STATIC_LOOKAHEAD_BITS 4
 #endif
 
@@ -24,6 +24,8 @@
 // forward references
 PNG_STATIC int PNGInit(PNGIMAGE *pPNG);
 PNG_STATIC int DecodePNG(PNGIMAGE *pImage, void *pUser, int iOptions);
+PNG_STATIC int DecodePNGBegin(PNGIMAGE *pImage, void *pUser, int iOptions);
+PNG_STATIC int DecodePNGLines(PNGIMAGE *pImage, int iLines);
 PNG_STATIC uint8_t PNGMakeMask(PNGDRAW *pDraw, uint8_t *pMask, uint8_t ucThreshold);
 // Include the C code which does the actual work
 #include "png.inl"
@@ -194,6 +196,31 @@ int PNG::decode(void *pUser, int iOptions)
     return DecodePNG(&_png, pUser, iOptions);
 } /* decode() */
 //
+// Decode the image a few lines at a time
+// decodeBegin() prepares the decoder and returns 0 (PNG_SUCCESS) or an error code
+// decodeLines() draws up to iLines lines and returns 1 while
+// there is more to decode, 0 when done (see getLastError())
+//
+int PNG::decodeBegin(void *pUser, int iOptions)
+{
+    return DecodePNGBegin(&_png, pUser, iOptions);
+} /* decodeBegin() */
+
+int PNG::decodeLines(int iLines)
+{
+    return DecodePNGLines(&_png, iLines);
+} /* decodeLines() */
+//
+// Stop a decode in progress
+//
+void PNG::decodeAbort()
+{
+    if (_png.Decode.iPhase != PNG_PHASE_IDLE) {
+        inflateEnd(&_png.Decode.d_stream);
+        _png.Decode.iPhase = PNG_PHASE_IDLE;
+    }
+} /* decodeAbort() */
+//
 // Convert a line of native pixels (all supported formats) into RGB565
 // can optionally mix in a background color - set to -1 to disable
 // Background color is in the form of a uint32_t -> 00BBGGRR (MSB on left)
@@ -135,6 +135,29 @@ typedef void * (PNG_OPEN_CALLBACK)(const char *szFilename, int32_t *pFileSize);
 typedef void (PNG_DRAW_CALLBACK)(PNGDRAW *);
 typedef void (PNG_CLOSE_CALLBACK)(void *pHandle);
 
+// decode phases of the resumable decoder
+enum {
+    PNG_PHASE_IDLE=0,   // not started, finished or aborted
+    PNG_PHASE_MARKER,   // parse the next chunk header
+    PNG_PHASE_IDAT,     // feed the next part of an IDAT chunk to zlib
+    PNG_PHASE_INFLATE,  // inflate and draw lines from the current input
+    PNG_PHASE_SKIP      // skip chunk data + CRC
+};
+
+//
+// state of a decode in progress, kept between decodeLines() calls
+//
+typedef struct png_decode_tag
+{
+    z_stream d_stream;
+    int iPhase;
+    int y, iLen, iMarker, err;
+    int bDone, iOffset, iFileOffset, iBytesRead;
+    int iOptions;
+    void *pUser;
+    uint8_t *pCurr, *pPrev;
+} PNGDECODE;
+
 //
 // our private structure to hold a JPEG image decode state
 //
@@ -155,6 +178,7 @@ typedef struct png_image_tag
     PNG_DRAW_CALLBACK *pfnDraw;
     PNG_CLOSE_CALLBACK *pfnClose;
     PNGFILE PNGFile;
+    PNGDECODE Decode;
     uint8_t ucZLIB[32768 + sizeof(inflate_state)]; // put this here to avoid needing malloc/free
     uint8_t ucPalette[1024];
     uint8_t ucPixels[PNG_MAX_BUFFERED_PIXELS * 2];
@@ -177,6 +201,9 @@ class PNG
     int open(const char *szFilename, PNG_OPEN_CALLBACK *pfnOpen, PNG_CLOSE_CALLBACK *pfnClose, PNG_READ_CALLBACK *pfnRead, PNG_SEEK_CALLBACK *pfnSeek, PNG_DRAW_CALLBACK *pfnDraw);
     void close();
     int decode(void *pUser, int iOptions);
+    int decodeBegin(void *pUser, int iOptions);
+    int decodeLines(int iLines);
+    void decodeAbort();
     int getWidth();
     int getHeight();
     int getBpp();
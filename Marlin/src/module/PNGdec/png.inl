@@ -633,36 +633,44 @@ PNG_STATIC int PNGInit(PNGIMAGE *pPNG)
 //
 PNG_STATIC int DecodePNG(PNGIMAGE *pPage, void *pUser, int iOptions)
 {
-    int err, y, iLen=0;
-    int bDone, iOffset, iFileOffset, iBytesRead;
-    int iMarker=0;
-    uint8_t *tmp, *pCurr, *pPrev;
-    z_stream d_stream; /* decompression stream */
+    if (DecodePNGBegin(pPage, pUser, iOptions) == PNG_SUCCESS)
+        DecodePNGLines(pPage, 0x7fffffff);
+    return pPage->iError;
+} /* DecodePNG() */
+//
+// Prepare a decode which is then done in parts by DecodePNGLines()
+//
+PNG_STATIC int DecodePNGBegin(PNGIMAGE *pPage, void *pUser, int iOptions)
+{
+    PNGDECODE *pDec = &pPage->Decode;
     uint8_t *s = pPage->ucFileBuf;
     struct inflate_state *state;
     
+    pDec->iPhase = PNG_PHASE_IDLE;
     // Either the image buffer must be allocated or a draw callback must be set before entering
     if (pPage->pImage == NULL && pPage->pfnDraw == NULL) {
         pPage->iError = PNG_NO_BUFFER;
-        return 0;
+        return pPage->iError;
     }
     // Use internal buffer to maintain the current and previous lines
-    pCurr = pPage->ucPixels;
-    pPrev = &pPage->ucPixels[pPage->iPitch+1];
+    pDec->pCurr = pPage->ucPixels;
+    pDec->pPrev = &pPage->ucPixels[pPage->iPitch+1];
+    pDec->pUser = pUser;
+    pDec->iOptions = iOptions;
     pPage->iError = PNG_SUCCESS;
     // Start decoding the image
-    bDone = FALSE;
+    pDec->bDone = FALSE;
     // Inflate the compressed image data
     // The allocation functions are disabled and zlib has been modified
     // to not use malloc/free and instead the buffer is part of the PNG class
-    d_stream.zalloc = (alloc_func)0;
-    d_stream.zfree = (free_func)0;
-    d_stream.opaque = (voidpf)0;
+    pDec->d_stream.zalloc = (alloc_func)0;
+    pDec->d_stream.zfree = (free_func)0;
+    pDec->d_stream.opaque = (voidpf)0;
     // Insert the memory pointer here to avoid having to use malloc() inside zlib
     state = (struct inflate_state FAR *)pPage->ucZLIB;
-    d_stream.state = (struct internal_state FAR *)state;
+    pDec->d_stream.state = (struct internal_state FAR *)state;
     state->window = &pPage->ucZLIB[sizeof(inflate_state)]; // point to 32k dictionary buffer
-    err = inflateInit(&d_stream);
+    pDec->err = inflateInit(&pDec->d_stream);
 #ifdef FUTURE
 //    if (inpage->cCompression == PIL_COMP_IPHONE_FLATE)
 //        err = mz_inflateInit2(&d_stream, -15); // undocumented option which ignores header and crcs
@@ -670,209 +678,210 @@ PNG_STATIC int DecodePNG(PNGIMAGE *pPage, void *pUser, int iOptions)
 //        err = mz_inflateInit2(&d_stream, 15);
 #endif // FUTURE
     
-    iFileOffset = 8; // skip PNG file signature
-    iOffset = 0; // internal buffer offset starts at 0
+    pDec->iFileOffset = 8; // skip PNG file signature
+    pDec->iOffset = 0; // internal buffer offset starts at 0
     // Read some data to start
-    (*pPage->pfnSeek)(&pPage->PNGFile, iFileOffset);
-    iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, s, PNG_FILE_BUF_SIZE);
-    if (iBytesRead < 1)
+    (*pPage->pfnSeek)(&pPage->PNGFile, pDec->iFileOffset);
+    pDec->iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, s, PNG_FILE_BUF_SIZE);
+    if (pDec->iBytesRead < 1)
     {
         pPage->iError = PNG_INVALID_FILE;
         return pPage->iError;
     }
-    iFileOffset += iBytesRead;
-    y = 0;
-    d_stream.avail_out = 0;
-    d_stream.next_out = pPage->pImage;
+    pDec->iFileOffset += pDec->iBytesRead;
+    pDec->y = 0;
+    pDec->iLen = 0;
+    pDec->d_stream.avail_out = 0;
+    pDec->d_stream.next_out = pPage->pImage;
+    pDec->iPhase = PNG_PHASE_MARKER;
+    return PNG_SUCCESS;
+} /* DecodePNGBegin() */
+//
+// Continue the decode started by DecodePNGBegin()
+// Stops after iLines lines have been decoded
+// returns 1 if there is more to decode, 0 when finished (the result is in iError)
+//
+PNG_STATIC int DecodePNGLines(PNGIMAGE *pPage, int iLines)
+{
+    PNGDECODE *pDec = &pPage->Decode;
+    z_stream *d_stream = &pDec->d_stream;
+    uint8_t *s = pPage->ucFileBuf;
+    uint8_t *tmp;
 
-    while (y < pPage->iHeight) { // continue until fully decoded
-        // parse the markers until the next data block
-    while (!bDone)
+    while (pDec->iPhase != PNG_PHASE_IDLE)
     {
-        iLen = MOTOLONG(&s[iOffset]); // chunk length
-        if (iLen < 0 || iLen + (iFileOffset - iBytesRead) > pPage->PNGFile.iSize) // invalid data
-        {
-            pPage->iError = PNG_DECODE_ERROR;
-            return 1;
-        }
-        iMarker = MOTOLONG(&s[iOffset+4]);
-        iOffset += 8; // point to the marker data
-        switch (iMarker)
+        switch (pDec->iPhase)
         {
-            case 0x44474b62: // 'bKGD' DEBUG
-                break;
-            case 0x67414d41: //'gAMA'
-                break;
-#ifdef FUTURE
-            case 0x6663544C: //'fcTL' frame control block for animated PNG (need to get size of this partial image)
-                pPage->iWidth = MOTOLONG(&pPage->pData[iOffset + 4]); // frame width
-                pPage->iHeight = MOTOLONG(&pPage->pData[iOffset + 8]); // frame height
-                bDone = TRUE;
-                break;
-#endif
-            case 0x504c5445: //'PLTE' palette colors
-                memset(&pPage->ucPalette[768], 0xff, 256); // assume all colors are opaque unless specified
-                memcpy(pPage->ucPalette, &s[iOffset], iLen);
-                if (iOptions & PNG_FAST_PALETTE) { // create a RGB565 palette
-                    int i, iColors = 1 << pPage->ucBpp;
-                    uint16_t usPixel, *d;
-                    uint8_t *s = pPage->ucPalette;
-                    d = (uint16_t *)&pPage->ucPixels[sizeof(pPage->ucPixels)-512];
-                    for (i=0; i<iColors; i++) {
-                    usPixel = (s[2] >> 3); // blue
-                    usPixel |= ((s[1] >> 2) << 5); // green
-                    usPixel |= ((s[0] >> 3) << 11); // red
-                    *d++ = usPixel;
-                    s += 3;
-                    }
-                }
+        case PNG_PHASE_MARKER: // parse the markers until the next data block
+            if (pDec->bDone) // fully decoded
+            {
+                inflateEnd(d_stream);
+                pDec->iPhase = PNG_PHASE_IDLE;
                 break;
-            case 0x74524e53: //'tRNS' transparency info
-                if (pPage->ucPixelType == PNG_PIXEL_INDEXED) // if palette exists
-                {
-                    memcpy(&pPage->ucPalette[768], &s[iOffset], iLen);
-                    pPage->iHasAlpha = 1;
-                }
-                else if (iLen == 2) // for grayscale images
-                {
-                    pPage->iTransparent = s[iOffset + 1]; // lower part of 2-byte value is transparent color index
-                    pPage->iHasAlpha = 1;
-                }
-                else if (iLen == 6) // transparent color for 24-bpp image
-                {
-                    pPage->iTransparent = s[iOffset + 5]; // lower part of 2-byte value is transparent color value
-                    pPage->iTransparent |= (s[iOffset + 3] << 8);
-                    pPage->iTransparent |= (s[iOffset + 1] << 16);
-                    pPage->iHasAlpha = 1;
-                }
+            }
+            pDec->iLen = MOTOLONG(&s[pDec->iOffset]); // chunk length
+            if (pDec->iLen < 0 || pDec->iLen + (pDec->iFileOffset - pDec->iBytesRead) > pPage->PNGFile.iSize) // invalid data
+            {
+                pPage->iError = PNG_DECODE_ERROR;
+                pDec->iPhase = PNG_PHASE_IDLE;
                 break;
-            case 0x49444154: //'IDAT' image data block
-                while (iLen) {
-                    if (iOffset >= iBytesRead) {
-                        // we ran out of data; get some more
-                        iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, pPage->ucFileBuf, (iLen > PNG_FILE_BUF_SIZE) ? PNG_FILE_BUF_SIZE : iLen);
-                        if (iBytesRead < 1)
-                        {
-                            pPage->iError = PNG_INVALID_FILE;
-                            return pPage->iError;
+            }
+            pDec->iMarker = MOTOLONG(&s[pDec->iOffset+4]);
+            pDec->iOffset += 8; // point to the marker data
+            pDec->iPhase = PNG_PHASE_SKIP;
+            switch (pDec->iMarker)
+            {
+                case 0x44474b62: // 'bKGD' DEBUG
+                    break;
+                case 0x67414d41: //'gAMA'
+                    break;
+                case 0x504c5445: //'PLTE' palette colors
+                    memset(&pPage->ucPalette[768], 0xff, 256); // assume all colors are opaque unless specified
+                    memcpy(pPage->ucPalette, &s[pDec->iOffset], pDec->iLen);
+                    if (pDec->iOptions & PNG_FAST_PALETTE) { // create a RGB565 palette
+                        int i, iColors = 1 << pPage->ucBpp;
+                        uint16_t usPixel, *d;
+                        uint8_t *s = pPage->ucPalette;
+                        d = (uint16_t *)&pPage->ucPixels[sizeof(pPage->ucPixels)-512];
+                        for (i=0; i<iColors; i++) {
+                        usPixel = (s[2] >> 3); // blue
+                        usPixel |= ((s[1] >> 2) << 5); // green
+                        usPixel |= ((s[0] >> 3) << 11); // red
+                        *d++ = usPixel;
+                        s += 3;
                         }
-                        iFileOffset += iBytesRead;
-                        iOffset = 0;
-                    } else {
-                        // number of bytes remaining in buffer
-                        iBytesRead -= iOffset;
                     }
-                    d_stream.next_in  = &pPage->ucFileBuf[iOffset];
-                    d_stream.avail_in = iBytesRead;
-                    iLen -= iBytesRead;
-                    if (iLen < 0) iLen = 0;
-                    iOffset += iBytesRead;
-            //        if (iMarker == 0x66644154) // data starts at offset 4 in APNG frame data block
-            //        {
-            //            d_stream.next_in += 4;
-            //            d_stream.avail_in -= 4;
-            //        }
-                    err = 0;
-                    while (err == Z_OK) {
-                        if (d_stream.avail_out == 0) { // reset for next line
-                            d_stream.avail_out = pPage->iPitch+1;
-                            d_stream.next_out = pCurr;
-                        } // otherwise it could be a continuation of an unfinished line
-                        err = inflate(&d_stream, Z_NO_FLUSH, iOptions & PNG_CHECK_CRC);
-                        if ((err == Z_OK || err == Z_STREAM_END) && d_stream.avail_out == 0) {// successfully decoded line
-                            DeFilter(pCurr, pPrev, pPage->iWidth, pPage->iPitch);
-                            if (pPage->pImage == NULL) { // no image buffer, send it line by line
-                                PNGDRAW pngd;
-                                pngd.pUser = pUser;
-                                pngd.iPitch = pPage->iPitch;
-                                pngd.iWidth = pPage->iWidth;
-                                pngd.pPalette = pPage->ucPalette;
-                                pngd.pFastPalette = (iOptions & PNG_FAST_PALETTE) ? (uint16_t *)&pPage->ucPixels[sizeof(pPage->ucPixels)-512] : NULL;
-                                pngd.pPixels = pCurr+1;
-                                pngd.iPixelType = pPage->ucPixelType;
-                                pngd.iBpp = pPage->ucBpp;
-                                pngd.y = y;
-                                (*pPage->pfnDraw)(&pngd);
-                            } else {
-                                // copy to destination bitmap
-                                memcpy(&pPage->pImage[y * pPage->iPitch], &pCurr[1], pPage->iPitch);
-                            }
-                            y++;
-                        // swap current and previous lines
-                        tmp = pCurr; pCurr = pPrev; pPrev = tmp;
-                        } else { // some error
-                            tmp = NULL;
-                        }
+                    break;
+                case 0x74524e53: //'tRNS' transparency info
+                    if (pPage->ucPixelType == PNG_PIXEL_INDEXED) // if palette exists
+                    {
+                        memcpy(&pPage->ucPalette[768], &s[pDec->iOffset], pDec->iLen);
+                        pPage->iHasAlpha = 1;
                     }
-                    if (err == Z_STREAM_END && d_stream.avail_out == 0) {
-                        // successful decode, stop here
-                        y = pPage->iHeight;
-                        bDone = TRUE;
-                    } else  if (err == Z_DATA_ERROR || err == Z_STREAM_ERROR) {
-                        iLen = 0; // quit now
-                        y = pPage->iHeight;
-                        pPage->iError = PNG_DECODE_ERROR;
-                        bDone = TRUE; // force loop to exit with error
-                    } else if (err == Z_BUF_ERROR) {
-                        y |= 0; // need more data
+                    else if (pDec->iLen == 2) // for grayscale images
+                    {
+                        pPage->iTransparent = s[pDec->iOffset + 1]; // lower part of 2-byte value is transparent color index
+                        pPage->iHasAlpha = 1;
                     }
-                } // while (iLen)
-                if (y != pPage->iHeight && iFileOffset < pPage->PNGFile.iSize) {
-                    // need to read more IDAT chunks
-                    iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, pPage->ucFileBuf,  PNG_FILE_BUF_SIZE);
-                    if (iBytesRead < 1)
+                    else if (pDec->iLen == 6) // transparent color for 24-bpp image
+                    {
+                        pPage->iTransparent = s[pDec->iOffset + 5]; // lower part of 2-byte value is transparent color value
+                        pPage->iTransparent |= (s[pDec->iOffset + 3] << 8);
+                        pPage->iTransparent |= (s[pDec->iOffset + 1] << 16);
+                        pPage->iHasAlpha = 1;
+                    }
+                    break;
+                case 0x49444154: //'IDAT' image data block
+                    pDec->iPhase = PNG_PHASE_IDAT;
+                    break;
+            } // switch
+            break;
+
+        case PNG_PHASE_IDAT: // next part of the image data block
+            if (pDec->iLen) {
+                if (pDec->iOffset >= pDec->iBytesRead) {
+                    // we ran out of data; get some more
+                    pDec->iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, pPage->ucFileBuf, (pDec->iLen > PNG_FILE_BUF_SIZE) ? PNG_FILE_BUF_SIZE : pDec->iLen);
+                    if (pDec->iBytesRead < 1)
                     {
                         pPage->iError = PNG_INVALID_FILE;
-                        return pPage->iError;
+                        pDec->iPhase = PNG_PHASE_IDLE;
+                        break;
                     }
-                    iFileOffset += iBytesRead;
-                    iOffset = 0;
+                    pDec->iFileOffset += pDec->iBytesRead;
+                    pDec->iOffset = 0;
+                } else {
+                    // number of bytes remaining in buffer
+                    pDec->iBytesRead -= pDec->iOffset;
                 }
-                break;
-                //               case 0x69545874: //'iTXt'
-                //               case 0x7a545874: //'zTXt'
-#ifdef FUTURE
-            case 0x74455874: //'tEXt'
-            {
-                char szTemp[256];
-                char *pDest = NULL;
-                memcpy(szTemp, &s[iOffset], 80); // get the label length (Title, Author, Description, Copyright, Creation Time, Software, Disclaimer, Warning, Source, Comment)
-                i = (int)strlen(szTemp) + 1; // start of actual text
-                if (strcmp(szTemp, "Comment") == 0 || strcmp(szTemp, "Description") == 0) pDest = &pPage->szComment[0];
-                else if (strcmp(szTemp, "Software") == 0) pDest = &pPage->szSoftware[0];
-                else if (strcmp(szTemp, "Author") == 0) pDest = &pPage->szArtist[0];
-                if (pDest != NULL)
-                {
-                    if ((iLen - i) < 128)
+                d_stream->next_in  = &pPage->ucFileBuf[pDec->iOffset];
+                d_stream->avail_in = pDec->iBytesRead;
+                pDec->iLen -= pDec->iBytesRead;
+                if (pDec->iLen < 0) pDec->iLen = 0;
+                pDec->iOffset += pDec->iBytesRead;
+                pDec->err = 0;
+                pDec->iPhase = PNG_PHASE_INFLATE;
+            } else {
+                if (pDec->y != pPage->iHeight && pDec->iFileOffset < pPage->PNGFile.iSize) {
+                    // need to read more IDAT chunks
+                    pDec->iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, pPage->ucFileBuf,  PNG_FILE_BUF_SIZE);
+                    if (pDec->iBytesRead < 1)
                     {
-                        memcpy(pPage->szComment, &pPage->pData[iOffset + i], iLen - i);
-                        pPage->szComment[iLen - i + 1] = 0;
+                        pPage->iError = PNG_INVALID_FILE;
+                        pDec->iPhase = PNG_PHASE_IDLE;
+                        break;
                     }
-                    else
-                    {
-                        memcpy(pPage->szComment, &pPage->pData[iOffset + i], 127);
-                        pPage->szComment[127] = '\0';
+                    pDec->iFileOffset += pDec->iBytesRead;
+                    pDec->iOffset = 0;
+                }
+                pDec->iPhase = PNG_PHASE_SKIP;
+            }
+            break;
+
+        case PNG_PHASE_INFLATE: // decode lines from the current input
+            while (pDec->err == Z_OK) {
+                if (iLines <= 0) // come back later for the rest
+                    return 1;
+                if (d_stream->avail_out == 0) { // reset for next line
+                    d_stream->avail_out = pPage->iPitch+1;
+                    d_stream->next_out = pDec->pCurr;
+                } // otherwise it could be a continuation of an unfinished line
+                pDec->err = inflate(d_stream, Z_NO_FLUSH, pDec->iOptions & PNG_CHECK_CRC);
+                if ((pDec->err == Z_OK || pDec->err == Z_STREAM_END) && d_stream->avail_out == 0) {// successfully decoded line
+                    DeFilter(pDec->pCurr, pDec->pPrev, pPage->iWidth, pPage->iPitch);
+                    if (pPage->pImage == NULL) { // no image buffer, send it line by line
+                        PNGDRAW pngd;
+                        pngd.pUser = pDec->pUser;
+                        pngd.iPitch = pPage->iPitch;
+                        pngd.iWidth = pPage->iWidth;
+                        pngd.pPalette = pPage->ucPalette;
+                        pngd.pFastPalette = (pDec->iOptions & PNG_FAST_PALETTE) ? (uint16_t *)&pPage->ucPixels[sizeof(pPage->ucPixels)-512] : NULL;
+                        pngd.pPixels = pDec->pCurr+1;
+                        pngd.iPixelType = pPage->ucPixelType;
+                        pngd.iBpp = pPage->ucBpp;
+                        pngd.y = pDec->y;
+                        (*pPage->pfnDraw)(&pngd);
+                    } else {
+                        // copy to destination bitmap
+                        memcpy(&pPage->pImage[pDec->y * pPage->iPitch], &pDec->pCurr[1], pPage->iPitch);
                     }
+                    pDec->y++;
+                    iLines--;
+                    // swap current and previous lines
+                    tmp = pDec->pCurr; pDec->pCurr = pDec->pPrev; pDec->pPrev = tmp;
                 }
             }
-                break;
-#endif
-        } // switch
-        iOffset += (iLen + 4); // skip data + CRC
-        if (iOffset > iBytesRead-8) { // need to read more data
-            iFileOffset += (iOffset - iBytesRead);
-            (*pPage->pfnSeek)(&pPage->PNGFile, iFileOffset);
-            iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, s, PNG_FILE_BUF_SIZE);
-            if (iBytesRead < 1)
-            {
-                pPage->iError = PNG_INVALID_FILE;
-                return pPage->iError;
+            if (pDec->err == Z_STREAM_END && d_stream->avail_out == 0) {
+                // successful decode, stop here
+                pDec->y = pPage->iHeight;
+                pDec->bDone = TRUE;
+            } else if (pDec->err == Z_DATA_ERROR || pDec->err == Z_STREAM_ERROR) {
+                pDec->iLen = 0; // quit now
+                pDec->y = pPage->iHeight;
+                pPage->iError = PNG_DECODE_ERROR;
+                pDec->bDone = TRUE; // force loop to exit with error
+            } // Z_BUF_ERROR: need more data
+            pDec->iPhase = PNG_PHASE_IDAT;
+            break;
+
+        case PNG_PHASE_SKIP: // skip data + CRC
+            pDec->iOffset += (pDec->iLen + 4);
+            if (pDec->iOffset > pDec->iBytesRead-8) { // need to read more data
+                pDec->iFileOffset += (pDec->iOffset - pDec->iBytesRead);
+                (*pPage->pfnSeek)(&pPage->PNGFile, pDec->iFileOffset);
+                pDec->iBytesRead = (*pPage->pfnRead)(&pPage->PNGFile, s, PNG_FILE_BUF_SIZE);
+                if (pDec->iBytesRead < 1)
+                {
+                    pPage->iError = PNG_INVALID_FILE;
+                    pDec->iPhase = PNG_PHASE_IDLE;
+                    break;
+                }
+                pDec->iFileOffset += pDec->iBytesRead;
+                pDec->iOffset = 0;
             }
-            iFileOffset += iBytesRead;
-            iOffset = 0;
-        }
-    } // while !bDone
-    } // while y < height
-    err = inflateEnd(&d_stream);
-    return pPage->iError;
-} /* DecodePNG() */
+            pDec->iPhase = PNG_PHASE_MARKER;
+            break;
+        } // switch
+    }
+    return 0;
+} /* DecodePNGLines() */
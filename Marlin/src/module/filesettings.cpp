@@ -433,8 +433,9 @@ bool FileSettings::SaveSettings(char *fname /*= NULL*/)
     {
       for (uint8_t ix = 0; ix < GRID_MAX_POINTS_X; ix++)
       {
+        const float z = bedlevel.z_values[ix][iy];
         sprintf(curline, "%0.3f%s ",
-                    isnan(bedlevel.z_values[ix][iy]) ? 0 : bedlevel.z_values[ix][iy],
+                    isnan(z) ? 0.0f : z,
                     (iy == GRID_MAX_POINTS_Y-1 && ix == GRID_MAX_POINTS_X-1) ? "" : ","
                 );
         len = strlen(curline);
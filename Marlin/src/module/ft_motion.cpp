@@ -27,6 +27,10 @@
 #include "ft_motion.h"
 #include "stepper.h" // Access stepper block queue function and abort status.
 
+#if ENABLED(FTM_LEVELING)
+  #include "../feature/bedlevel/bedlevel.h"
+#endif
+
 FxdTiCtrl fxdTiCtrl;
 
 #if !HAS_X_AXIS
@@ -92,6 +96,32 @@ uint32_t FxdTiCtrl::N1,                         // Number of data points in the
 
 uint32_t FxdTiCtrl::max_intervals;              // Total number of data points that will be generated from block.
 
+#if ENABLED(FTM_FIXED_POINT)
+  xyze_long_t FxdTiCtrl::startPosn_q,           // Start position of block. [ft_pos_t]
+              FxdTiCtrl::ratio_q;               // Axis move ratio of block. [ft_ratio_t]
+  ft_dist_t FxdTiCtrl::f_s_q,                   // Distance for each data point at the starting feedrate.
+            FxdTiCtrl::accel_q,                 // Half the change of speed for each data point in accel, squared.
+            FxdTiCtrl::decel_q,                 // Half the change of speed for each data point in decel, squared.
+            FxdTiCtrl::F_q,                     // Distance for each data point at the coasting feedrate.
+            FxdTiCtrl::s_1e_q,                  // Position after acceleration phase of block.
+            FxdTiCtrl::s_2e_q;                  // Position after acceleration and coasting phase of block.
+#endif
+
+#if ENABLED(FTM_LEVELING)
+  float FxdTiCtrl::level_fade;                  // Fade factor of the mesh. 0 if the block isn't leveled.
+  xy_pos_t FxdTiCtrl::level_start,              // XY at the start of the block. [mm]
+           FxdTiCtrl::level_per_mm;             // XY change for each mm along the block. [mm/mm]
+  float FxdTiCtrl::level_z_start,               // Mesh correction at the start of the block. [mm]
+        FxdTiCtrl::level_z_per_mm;              // Correction change for each mm, as leveled by the planner. [mm/mm]
+#endif
+
+#if ENABLED(ARC_BLOCKS)
+  arc_block_t FxdTiCtrl::arc;                   // Arc of the block, if any.
+  xy_pos_t FxdTiCtrl::arc_center;               // Center of the arc in the P-Q plane. [mm]
+  float FxdTiCtrl::arc_start_angle,             // Angle of the block start around the center. [rad]
+        FxdTiCtrl::arc_angle_per_mm;            // Sweep for each mm along the path. [rad/mm]
+#endif
+
 // Make vector variables.
 uint32_t FxdTiCtrl::makeVector_idx = 0,                     // Index of fixed time trajectory generation of the overall block.
          FxdTiCtrl::makeVector_idx_z1 = 0,                  // Storage for the previously calculated index above.
@@ -107,17 +137,21 @@ uint32_t FxdTiCtrl::interpIdx = 0,                    // Index of current data p
 #if HAS_X_AXIS
   FxdTiCtrl::shaping_t FxdTiCtrl::shaping = {
     0, 0,
-    x:{ { 0.0f }, { 0.0f }, { 0 } },                  // d_zi, Ai, Ni
+    x:{ { 0 }, { 0.0f } OPTARG(FTM_FIXED_POINT, { 0 }), { 0 } },   // d_zi, Ai, Aq, Ni
     #if HAS_Y_AXIS
-      y:{ { 0.0f }, { 0.0f }, { 0 } }                 // d_zi, Ai, Ni
+      y:{ { 0 }, { 0.0f } OPTARG(FTM_FIXED_POINT, { 0 }), { 0 } }  // d_zi, Ai, Aq, Ni
     #endif
   };
 #endif
 
 #if HAS_EXTRUDERS
   // Linear advance variables.
-  float FxdTiCtrl::e_raw_z1 = 0.0f;             // (ms) Unit delay of raw extruder position.
-  float FxdTiCtrl::e_advanced_z1 = 0.0f;        // (ms) Unit delay of advanced extruder position.
+  #if ENABLED(FTM_FIXED_POINT)
+    ft_dist_t FxdTiCtrl::e_lead_q = 0;          // Extruder lead added by linear advance. [ft_dist_t]
+  #else
+    float FxdTiCtrl::e_raw_z1 = 0.0f;           // (ms) Unit delay of raw extruder position.
+    float FxdTiCtrl::e_advanced_z1 = 0.0f;      // (ms) Unit delay of advanced extruder position.
+  #endif
 #endif
 
 //-----------------------------------------------------------------//
@@ -141,8 +175,11 @@ void FxdTiCtrl::runoutBlock() {
 
   startPosn = endPosn_prevBlock;
   ratio.reset();
+  TERN_(ARC_BLOCKS, arc.sweep = 0);
+  TERN_(FTM_LEVELING, level_fade = 0);
 
   accel_P = decel_P = 0.f;
+  TERN_(FTM_FIXED_POINT, loadFixedData());
 
   static constexpr uint32_t shaper_intervals = (FTM_BATCH_SIZE) * ceil((FTM_ZMAX) / (FTM_BATCH_SIZE)),
                             min_max_intervals = (FTM_BATCH_SIZE) * ceil((FTM_WINDOW_SIZE) / (FTM_BATCH_SIZE));
@@ -182,7 +219,7 @@ void FxdTiCtrl::loop() {
       else blockDataIsRunout = false;
     }
     while (!blockProcDn && !batchRdy && (makeVector_idx - makeVector_idx_z1 < (FTM_POINTS_PER_LOOP)))
-      makeVector();
+      makeVector((FTM_POINTS_PER_LOOP) - (makeVector_idx - makeVector_idx_z1));
   }
 
   // FBS / post processing.
@@ -230,14 +267,19 @@ void FxdTiCtrl::loop() {
 
   } // if (batchRdy && !batchRdyForInterp)
 
-  // Interpolation.
+  // Interpolation, in runs of as many data points as the stepper command buffer can take.
+  uint32_t items;
   while ( batchRdyForInterp
-          && ( stepperCmdBuffItems() < ((FTM_STEPPERCMD_BUFF_SIZE) - (FTM_STEPS_PER_UNIT_TIME)) )
+          && ( (items = stepperCmdBuffItems()) < ((FTM_STEPPERCMD_BUFF_SIZE) - (FTM_STEPS_PER_UNIT_TIME)) )
           && ( (interpIdx - interpIdx_z1) < (FTM_STEPS_PER_LOOP) )
   ) {
-    convertToSteps(interpIdx);
+    const uint32_t n = _MIN( (FTM_BATCH_SIZE) - interpIdx,
+                             ((FTM_STEPPERCMD_BUFF_SIZE) - (FTM_STEPS_PER_UNIT_TIME) - 1 - items) / (FTM_STEPS_PER_UNIT_TIME) + 1,
+                             (FTM_STEPS_PER_LOOP) - (interpIdx - interpIdx_z1) );
+    convertToSteps(interpIdx, n);
 
-    if (++interpIdx == FTM_BATCH_SIZE) {
+    interpIdx += n;
+    if (interpIdx == FTM_BATCH_SIZE) {
       batchRdyForInterp = false;
       interpIdx = 0;
     }
@@ -320,8 +362,16 @@ void FxdTiCtrl::loop() {
         ZERO(x.Ai);
         max_i = 0;
     }
+    #if ENABLED(FTM_FIXED_POINT)
+      // Round the gains so they sum to exactly 1.0 and a standstill stays put.
+      ZERO(x.Aq);
+      ft_gain_t rest = 0;
+      for (uint32_t i = 1U; i <= max_i; i++) rest += (x.Aq[i] = ftm_fixed(x.Ai[i], FTM_GAIN_BITS));
+      if (max_i) x.Aq[0] = _BV32(FTM_GAIN_BITS) - rest;
+    #endif
     #if HAS_Y_AXIS
       memcpy(y.Ai, x.Ai, sizeof(x.Ai)); // For now, zeta and vtol are shared across x and y.
+      TERN_(FTM_FIXED_POINT, memcpy(y.Aq, x.Aq, sizeof(x.Aq)));
     #endif
   }
 
@@ -362,6 +412,29 @@ void FxdTiCtrl::loop() {
     }
   }
 
+  // Shape a run of data points in place. zi is the delay vector index of the first point.
+  void FxdTiCtrl::AxisShaping::shapeRun(ft_pos_t * const t, const uint32_t n, uint32_t zi, const uint32_t max_i) {
+    for (uint32_t j = 0; j < n; j++) {
+      d_zi[zi] = t[j];
+      #if ENABLED(FTM_FIXED_POINT)
+        int64_t v = int64_t(Aq[0]) * t[j] + _BV32(FTM_GAIN_BITS - 1); // Rounded to nearest
+        for (uint32_t i = 1U; i <= max_i; i++) {
+          const uint32_t udiff = zi - Ni[i];
+          v += int64_t(Aq[i]) * d_zi[Ni[i] > zi ? (FTM_ZMAX) + udiff : udiff];
+        }
+        t[j] = ft_pos_t(v >> (FTM_GAIN_BITS));
+      #else
+        float v = t[j] * Ai[0];
+        for (uint32_t i = 1U; i <= max_i; i++) {
+          const uint32_t udiff = zi - Ni[i];
+          v += Ai[i] * d_zi[Ni[i] > zi ? (FTM_ZMAX) + udiff : udiff];
+        }
+        t[j] = v;
+      #endif
+      if (++zi == (FTM_ZMAX)) zi = 0;
+    }
+  }
+
   void FxdTiCtrl::updateShapingN(const_float_t xf OPTARG(HAS_Y_AXIS, const_float_t yf), const_float_t zeta/*=FTM_SHAPING_ZETA*/) {
     const float df = sqrt(1.0f - sq(zeta));
     shaping.x.updateShapingN(xf, df);
@@ -402,7 +475,9 @@ void FxdTiCtrl::reset() {
     shaping.zi_idx = 0;
   #endif
 
-  TERN_(HAS_EXTRUDERS, e_raw_z1 = e_advanced_z1 = 0.0f);
+  #if HAS_EXTRUDERS
+    TERN(FTM_FIXED_POINT, e_lead_q = 0, e_raw_z1 = e_advanced_z1 = 0.0f);
+  #endif
 }
 
 // Private functions.
@@ -458,6 +533,34 @@ void FxdTiCtrl::loadBlockData(block_t * const current_block) {
 
   ratio = moveDist * oneOverLength;
 
+  #if ENABLED(ARC_BLOCKS)
+    // The steps of an arc block are its chord. Trace the plane axes around the center instead.
+    arc = planner.meta(current_block).arc;
+    if (arc.sweep) {
+      #if CORE_IS_XY
+        // Core motors see the same circle scaled by SQRT(2), mirrored for COREXY
+        arc.offset = arc_to_steppers(arc.offset);
+        arc.radius *= M_SQRT2;
+        arc.sweep = CORESIGN(-arc.sweep);
+      #endif
+      arc_center.set(startPosn[arc.axis_p] + arc.offset.a, startPosn[arc.axis_q] + arc.offset.b);
+      arc_start_angle = ATAN2(-arc.offset.b, -arc.offset.a);
+      arc_angle_per_mm = arc.sweep * oneOverLength;
+    }
+  #endif
+
+  #if ENABLED(FTM_LEVELING)
+    // The planner leveled the ends of the block. Follow the mesh in between.
+    const level_block_t &level = planner.meta(current_block).level;
+    level_fade = level.fade;
+    if (level_fade) {
+      level_start = level.start;
+      level_per_mm = (level.end - level.start) * oneOverLength;
+      level_z_start = level_fade * bedlevel.get_z_correction(level.start);
+      level_z_per_mm = (level_fade * bedlevel.get_z_correction(level.end) - level_z_start) * oneOverLength;
+    }
+  #endif
+
   const float spm = totalLength / current_block->step_event_count;  // (steps/mm) Distance for each step
               f_s = spm * current_block->initial_rate;  // (steps/s) Start feedrate
   const float f_e = spm * current_block->final_rate;    // (steps/s) End feedrate
@@ -516,166 +619,254 @@ void FxdTiCtrl::loadBlockData(block_t * const current_block) {
   max_intervals = N1 + N2 + N3;
 
   endPosn_prevBlock += moveDist;
+
+  TERN_(FTM_FIXED_POINT, loadFixedData());
 }
 
-// Generate data points of the trajectory.
-void FxdTiCtrl::makeVector() {
-  float accel_k = 0.0f;                                   // (mm/s^2) Acceleration K factor
-  float tau = (makeVector_idx + 1) * (FTM_TS);            // (s) Time since start of block
-  float dist = 0.0f;                                      // (mm) Distance traveled
+#if ENABLED(FTM_FIXED_POINT)
 
-  if (makeVector_idx < N1) {
-    // Acceleration phase
-    dist = (f_s * tau) + (0.5f * accel_P * sq(tau));      // (mm) Distance traveled for acceleration phase
-    accel_k = accel_P;                                    // (mm/s^2) Acceleration K factor from Accel phase
-  }
-  else if (makeVector_idx >= N1 && makeVector_idx < (N1 + N2)) {
-    // Coasting phase
-    dist = s_1e + F_P * (tau - N1 * (FTM_TS));            // (mm) Distance traveled for coasting phase
-    //accel_k = 0.0f;
-  }
-  else {
-    // Deceleration phase
-    const float tau_ = tau - (N1 + N2) * (FTM_TS);        // (s) Time since start of decel phase
-    dist = s_2e + F_P * tau_ + 0.5f * decel_P * sq(tau_); // (mm) Distance traveled for deceleration phase
-    accel_k = decel_P;                                    // (mm/s^2) Acceleration K factor from Decel phase
+  // Convert the trapezoid data of the block to fixed point, scaled for one data point.
+  void FxdTiCtrl::loadFixedData() {
+    LOOP_LOGICAL_AXES(i) {
+      startPosn_q[i] = ftm_to_pos(startPosn[i]);
+      ratio_q[i] = ftm_fixed(ratio[i], FTM_RATIO_BITS);
+    }
+    f_s_q = ftm_fixed(f_s * (FTM_TS), FTM_DIST_BITS);
+    accel_q = ftm_fixed(0.5f * accel_P * sq(FTM_TS), FTM_DIST_BITS);
+    decel_q = ftm_fixed(0.5f * decel_P * sq(FTM_TS), FTM_DIST_BITS);
+    F_q = ftm_fixed(F_P * (FTM_TS), FTM_DIST_BITS);
+    s_1e_q = ftm_fixed(s_1e, FTM_DIST_BITS);
+    s_2e_q = ftm_fixed(s_2e, FTM_DIST_BITS);
   }
 
-  NUM_AXIS_CODE(
-    traj.x[makeVector_batchIdx] = startPosn.x + ratio.x * dist,
-    traj.y[makeVector_batchIdx] = startPosn.y + ratio.y * dist,
-    traj.z[makeVector_batchIdx] = startPosn.z + ratio.z * dist,
-    traj.i[makeVector_batchIdx] = startPosn.i + ratio.i * dist,
-    traj.j[makeVector_batchIdx] = startPosn.j + ratio.j * dist,
-    traj.k[makeVector_batchIdx] = startPosn.k + ratio.k * dist,
-    traj.u[makeVector_batchIdx] = startPosn.u + ratio.u * dist,
-    traj.v[makeVector_batchIdx] = startPosn.v + ratio.v * dist,
-    traj.w[makeVector_batchIdx] = startPosn.w + ratio.w * dist
-  );
+  // Move an axis by its ratio of the distance along the block.
+  FORCE_INLINE ft_pos_t ftm_move(const ft_pos_t p0, const ft_ratio_t r, const ft_pos_t d) {
+    return p0 + ft_pos_t((int64_t(r) * d) >> (FTM_RATIO_BITS));
+  }
 
-  #if HAS_EXTRUDERS
-    const float new_raw_z1 = startPosn.e + ratio.e * dist;
-    if (cfg.linearAdvEna) {
-      float dedt_adj = (new_raw_z1 - e_raw_z1) * (FTM_FS);
-      if (ratio.e > 0.0f) dedt_adj += accel_k * cfg.linearAdvK;
+  // Reduce a distance along the block to a trajectory position.
+  FORCE_INLINE ft_pos_t ftm_dist_to_pos(const ft_dist_t d) { return ft_pos_t(d >> (FTM_DIST_BITS - FTM_POS_BITS)); }
 
-      e_advanced_z1 += dedt_adj * (FTM_TS);
-      traj.e[makeVector_batchIdx] = e_advanced_z1;
+#endif
 
-      e_raw_z1 = new_raw_z1;
+// Generate a run of data points of the trajectory, limited by the budget, the batch, and the block.
+// Each stage works over the whole run, one axis at a time, before the next stage starts.
+void FxdTiCtrl::makeVector(const uint32_t budget) {
+  static ft_pos_t dist[FTM_BATCH_SIZE];                   // (mm) Distance traveled at each point of the run
+
+  const uint32_t b0 = makeVector_batchIdx,                // First point of the run in the window
+                 n = _MIN(budget, (FTM_WINDOW_SIZE) - b0, max_intervals > makeVector_idx ? max_intervals - makeVector_idx : 1U);
+
+  // Distance along the block, one loop per phase
+  uint32_t i = 0, idx = makeVector_idx;
+  #if ENABLED(FTM_FIXED_POINT)
+    for (; i < n && idx < N1; i++, idx++) {
+      // Acceleration phase
+      const int64_t k = idx + 1;                          // Points since start of block
+      dist[i] = ftm_dist_to_pos(f_s_q * k + accel_q * k * k);
+    }
+    for (; i < n && idx < N1 + N2; i++, idx++) {
+      // Coasting phase
+      const int64_t k = idx + 1 - N1;                     // Points since start of coasting phase
+      dist[i] = ftm_dist_to_pos(s_1e_q + F_q * k);
     }
-    else {
-      traj.e[makeVector_batchIdx] = new_raw_z1;
-      // Alternatively: ed[makeVector_batchIdx] = startPosn.e + (ratio.e * dist) / (N1 + N2 + N3);
+    for (; i < n; i++, idx++) {
+      // Deceleration phase
+      const int64_t k = idx + 1 - N1 - N2;                // Points since start of decel phase
+      dist[i] = ftm_dist_to_pos(s_2e_q + F_q * k + decel_q * k * k);
+    }
+  #else
+    for (; i < n && idx < N1; i++, idx++) {
+      // Acceleration phase
+      const float tau = (idx + 1) * (FTM_TS);             // (s) Time since start of block
+      dist[i] = (f_s * tau) + (0.5f * accel_P * sq(tau));
+    }
+    for (; i < n && idx < N1 + N2; i++, idx++) {
+      // Coasting phase
+      const float tau = (idx + 1 - N1) * (FTM_TS);        // (s) Time since start of coasting phase
+      dist[i] = s_1e + F_P * tau;
+    }
+    for (; i < n; i++, idx++) {
+      // Deceleration phase
+      const float tau = (idx + 1 - N1 - N2) * (FTM_TS);   // (s) Time since start of decel phase
+      dist[i] = s_2e + F_P * tau + 0.5f * decel_P * sq(tau);
     }
   #endif
 
-  // Update shaping parameters if needed.
-  #if HAS_DYNAMIC_FREQ_MM
-    static float zd_z1 = 0.0f;
+  // Axis positions
+  #if ENABLED(FTM_FIXED_POINT)
+    #define _TRAJ_RUN(A) do{ \
+      const ft_pos_t p0 = startPosn_q.A; \
+      const ft_ratio_t r = ratio_q.A; \
+      ft_pos_t * const t = &traj.A[b0]; \
+      for (uint32_t i = 0; i < n; i++) t[i] = ftm_move(p0, r, dist[i]); \
+    }while(0)
+  #else
+    #define _TRAJ_RUN(A) do{ \
+      const float p0 = startPosn.A; \
+      const float r = ratio.A; \
+      float * const t = &traj.A[b0]; \
+      for (uint32_t i = 0; i < n; i++) t[i] = p0 + r * dist[i]; \
+    }while(0)
+  #endif
+  NUM_AXIS_CODE(
+    _TRAJ_RUN(x), _TRAJ_RUN(y), _TRAJ_RUN(z),
+    _TRAJ_RUN(i), _TRAJ_RUN(j), _TRAJ_RUN(k),
+    _TRAJ_RUN(u), _TRAJ_RUN(v), _TRAJ_RUN(w)
+  );
+  #undef _TRAJ_RUN
+
+  #if ENABLED(ARC_BLOCKS)
+    // Arcs need the trig functions, so they stay in float
+    if (arc.sweep) {
+      ft_pos_t * const tp = &traj.data[arc.axis_p][b0], * const tq = &traj.data[arc.axis_q][b0];
+      for (uint32_t i = 0; i < n; i++) {
+        const float theta = arc_start_angle + arc_angle_per_mm * ftm_to_float(dist[i]);
+        tp[i] = ftm_to_pos(arc_center.x + arc.radius * cos(theta));
+        tq[i] = ftm_to_pos(arc_center.y + arc.radius * sin(theta));
+      }
+    }
   #endif
-  switch (cfg.dynFreqMode) {
-
-    #if HAS_DYNAMIC_FREQ_MM
-      case dynFreqMode_Z_BASED:
-        if (traj.z[makeVector_batchIdx] != zd_z1) { // Only update if Z changed.
-          const float xf = cfg.baseFreq[X_AXIS] + cfg.dynFreqK[X_AXIS] * traj.z[makeVector_batchIdx],
-                      yf = cfg.baseFreq[Y_AXIS] + cfg.dynFreqK[Y_AXIS] * traj.z[makeVector_batchIdx];
-          updateShapingN(_MAX(xf, FTM_MIN_SHAPE_FREQ), _MAX(yf, FTM_MIN_SHAPE_FREQ));
-          zd_z1 = traj.z[makeVector_batchIdx];
-        }
-        break;
-    #endif
 
-    #if HAS_DYNAMIC_FREQ_G
-      case dynFreqMode_MASS_BASED:
-        // Update constantly. The optimization done for Z value makes
-        // less sense for E, as E is expected to constantly change.
-        updateShapingN(      cfg.baseFreq[X_AXIS] + cfg.dynFreqK[X_AXIS] * traj.e[makeVector_batchIdx]
-          OPTARG(HAS_Y_AXIS, cfg.baseFreq[Y_AXIS] + cfg.dynFreqK[Y_AXIS] * traj.e[makeVector_batchIdx]) );
-        break;
-    #endif
+  #if ENABLED(FTM_LEVELING)
+    // Add the mesh correction beyond the straight line between the leveled ends
+    if (level_fade) {
+      ft_pos_t * const tz = &traj.z[b0];
+      for (uint32_t i = 0; i < n; i++) {
+        const float d = ftm_to_float(dist[i]);
+        const float z_mesh = level_fade * bedlevel.get_z_correction(level_start + level_per_mm * d);
+        tz[i] += ftm_to_pos(z_mesh - (level_z_start + level_z_per_mm * d));
+      }
+    }
+  #endif
 
-    default: break;
-  }
+  #if HAS_EXTRUDERS && ENABLED(FTM_FIXED_POINT)
+    {
+      const ft_pos_t e0 = startPosn_q.e;
+      const ft_ratio_t re = ratio_q.e;
+      ft_pos_t * const te = &traj.e[b0];
+      if (cfg.linearAdvEna) {
+        // The lead grows by K times the change of speed, and only while extruding
+        const ft_dist_t la_accel = re > 0 ? ftm_fixed(accel_P * cfg.linearAdvK * (FTM_TS), FTM_DIST_BITS) : 0,
+                        la_decel = re > 0 ? ftm_fixed(decel_P * cfg.linearAdvK * (FTM_TS), FTM_DIST_BITS) : 0;
+        for (uint32_t i = 0; i < n; i++) {
+          const uint32_t idx = makeVector_idx + i;
+          e_lead_q += idx < N1 ? la_accel : idx < N1 + N2 ? 0 : la_decel;
+          te[i] = ftm_move(e0, re, dist[i]) + ftm_dist_to_pos(e_lead_q);
+        }
+      }
+      else
+        for (uint32_t i = 0; i < n; i++) te[i] = ftm_move(e0, re, dist[i]);
+    }
+  #elif HAS_EXTRUDERS
+    {
+      const float e0 = startPosn.e, re = ratio.e;
+      float * const te = &traj.e[b0];
+      if (cfg.linearAdvEna) {
+        for (uint32_t i = 0; i < n; i++) {
+          const uint32_t idx = makeVector_idx + i;
+          const float accel_k = idx < N1 ? accel_P : idx < N1 + N2 ? 0.0f : decel_P, // (mm/s^2) Acceleration K factor of the phase
+                      new_raw_z1 = e0 + re * dist[i];
+          float dedt_adj = (new_raw_z1 - e_raw_z1) * (FTM_FS);
+          if (re > 0.0f) dedt_adj += accel_k * cfg.linearAdvK;
+
+          e_advanced_z1 += dedt_adj * (FTM_TS);
+          te[i] = e_advanced_z1;
+
+          e_raw_z1 = new_raw_z1;
+        }
+      }
+      else {
+        for (uint32_t i = 0; i < n; i++) te[i] = e0 + re * dist[i];
+        // Alternatively: ed[makeVector_batchIdx] = startPosn.e + (ratio.e * dist) / (N1 + N2 + N3);
+      }
+    }
+  #endif
 
-  // Apply shaping if in mode.
   #if HAS_X_AXIS
-    if (cfg.modeHasShaper()) {
-      shaping.x.d_zi[shaping.zi_idx] = traj.x[makeVector_batchIdx];
-      traj.x[makeVector_batchIdx] *= shaping.x.Ai[0];
-      #if HAS_Y_AXIS
-        shaping.y.d_zi[shaping.zi_idx] = traj.y[makeVector_batchIdx];
-        traj.y[makeVector_batchIdx] *= shaping.y.Ai[0];
-      #endif
-      for (uint32_t i = 1U; i <= shaping.max_i; i++) {
-        const uint32_t udiffx = shaping.zi_idx - shaping.x.Ni[i];
-        traj.x[makeVector_batchIdx] += shaping.x.Ai[i] * shaping.x.d_zi[shaping.x.Ni[i] > shaping.zi_idx ? (FTM_ZMAX) + udiffx : udiffx];
-        #if HAS_Y_AXIS
-          const uint32_t udiffy = shaping.zi_idx - shaping.y.Ni[i];
-          traj.y[makeVector_batchIdx] += shaping.y.Ai[i] * shaping.y.d_zi[shaping.y.Ni[i] > shaping.zi_idx ? (FTM_ZMAX) + udiffy : udiffy];
-        #endif
+    if (cfg.dynFreqMode != dynFreqMode_DISABLED) {
+      // Dynamic frequencies change the shaping from one point to the next
+      for (uint32_t i = 0; i < n; i++) {
+        const uint32_t b = b0 + i;
+        switch (cfg.dynFreqMode) {
+
+          #if HAS_DYNAMIC_FREQ_MM
+            case dynFreqMode_Z_BASED: {
+              static ft_pos_t zd_z1 = 0;
+              if (traj.z[b] != zd_z1) { // Only update if Z changed.
+                const float xf = cfg.baseFreq[X_AXIS] + cfg.dynFreqK[X_AXIS] * ftm_to_float(traj.z[b]),
+                            yf = cfg.baseFreq[Y_AXIS] + cfg.dynFreqK[Y_AXIS] * ftm_to_float(traj.z[b]);
+                updateShapingN(_MAX(xf, FTM_MIN_SHAPE_FREQ), _MAX(yf, FTM_MIN_SHAPE_FREQ));
+                zd_z1 = traj.z[b];
+              }
+            } break;
+          #endif
+
+          #if HAS_DYNAMIC_FREQ_G
+            case dynFreqMode_MASS_BASED:
+              // Update constantly. The optimization done for Z value makes
+              // less sense for E, as E is expected to constantly change.
+              updateShapingN(      cfg.baseFreq[X_AXIS] + cfg.dynFreqK[X_AXIS] * ftm_to_float(traj.e[b])
+                OPTARG(HAS_Y_AXIS, cfg.baseFreq[Y_AXIS] + cfg.dynFreqK[Y_AXIS] * ftm_to_float(traj.e[b])) );
+              break;
+          #endif
+
+          default: break;
+        }
+
+        if (cfg.modeHasShaper()) {
+          shaping.x.shapeRun(&traj.x[b], 1, shaping.zi_idx, shaping.max_i);
+          TERN_(HAS_Y_AXIS, shaping.y.shapeRun(&traj.y[b], 1, shaping.zi_idx, shaping.max_i));
+          if (++shaping.zi_idx == (FTM_ZMAX)) shaping.zi_idx = 0;
+        }
       }
-      if (++shaping.zi_idx == (FTM_ZMAX)) shaping.zi_idx = 0;
+    }
+    else if (cfg.modeHasShaper()) {
+      // Apply shaping to the whole run, one axis at a time
+      shaping.x.shapeRun(&traj.x[b0], n, shaping.zi_idx, shaping.max_i);
+      TERN_(HAS_Y_AXIS, shaping.y.shapeRun(&traj.y[b0], n, shaping.zi_idx, shaping.max_i));
+      shaping.zi_idx = (shaping.zi_idx + n) % (FTM_ZMAX);
     }
   #endif
 
   // Filled up the queue with regular and shaped steps
-  if (++makeVector_batchIdx == (FTM_WINDOW_SIZE)) {
+  makeVector_batchIdx += n;
+  if (makeVector_batchIdx == (FTM_WINDOW_SIZE)) {
     makeVector_batchIdx = (FTM_WINDOW_SIZE - FTM_BATCH_SIZE);
     batchRdy = true;
   }
 
-  if (++makeVector_idx == max_intervals) {
+  makeVector_idx += n;
+  if (makeVector_idx >= max_intervals) {
     blockProcDn = true;
     blockProcRdy = false;
     makeVector_idx = 0;
   }
 }
 
-// Interpolates single data point to stepper commands.
-void FxdTiCtrl::convertToSteps(const uint32_t idx) {
-  xyze_long_t err_P = { 0 };
-
-  //#define STEPS_ROUNDING
-  #if ENABLED(STEPS_ROUNDING)
-    const xyze_float_t steps_tar = LOGICAL_AXIS_ARRAY(
-      trajMod.e[idx] * planner.settings.axis_steps_per_mm[E_AXIS_N(current_block->extruder)] + (trajMod.e[idx] < 0.0f ? -0.5f : 0.5f), // May be eliminated if guaranteed positive.
-      trajMod.x[idx] * planner.settings.axis_steps_per_mm[X_AXIS] + (trajMod.x[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.y[idx] * planner.settings.axis_steps_per_mm[Y_AXIS] + (trajMod.y[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.z[idx] * planner.settings.axis_steps_per_mm[Z_AXIS] + (trajMod.z[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.i[idx] * planner.settings.axis_steps_per_mm[I_AXIS] + (trajMod.i[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.j[idx] * planner.settings.axis_steps_per_mm[J_AXIS] + (trajMod.j[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.k[idx] * planner.settings.axis_steps_per_mm[K_AXIS] + (trajMod.k[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.u[idx] * planner.settings.axis_steps_per_mm[U_AXIS] + (trajMod.u[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.v[idx] * planner.settings.axis_steps_per_mm[V_AXIS] + (trajMod.v[idx] < 0.0f ? -0.5f : 0.5f),
-      trajMod.w[idx] * planner.settings.axis_steps_per_mm[W_AXIS] + (trajMod.w[idx] < 0.0f ? -0.5f : 0.5f),
-    );
-    xyze_long_t delta = xyze_long_t(steps_tar) - steps;
-    //const xyze_long_t delta = LOGICAL_AXIS_ARRAY(
-    //  int32_t(steps_tar.e) - steps.e,
-    //  int32_t(steps_tar.x) - steps.x,
-    //  int32_t(steps_tar.y) - steps.y,
-    //  int32_t(steps_tar.z) - steps.z,
-    //  int32_t(steps_tar.i) - steps.i,
-    //  int32_t(steps_tar.j) - steps.j,
-    //  int32_t(steps_tar.k) - steps.k,
-    //  int32_t(steps_tar.u) - steps.u,
-    //  int32_t(steps_tar.v) - steps.v,
-    //  int32_t(steps_tar.w) - steps.w
-    //);
-  #else
-    xyze_long_t delta = LOGICAL_AXIS_ARRAY(
-      int32_t(trajMod.e[idx] * planner.settings.axis_steps_per_mm[E_AXIS_N(current_block->extruder)]) - steps.e,
-      int32_t(trajMod.x[idx] * planner.settings.axis_steps_per_mm[X_AXIS]) - steps.x,
-      int32_t(trajMod.y[idx] * planner.settings.axis_steps_per_mm[Y_AXIS]) - steps.y,
-      int32_t(trajMod.z[idx] * planner.settings.axis_steps_per_mm[Z_AXIS]) - steps.z,
-      int32_t(trajMod.i[idx] * planner.settings.axis_steps_per_mm[I_AXIS]) - steps.i,
-      int32_t(trajMod.j[idx] * planner.settings.axis_steps_per_mm[J_AXIS]) - steps.j,
-      int32_t(trajMod.k[idx] * planner.settings.axis_steps_per_mm[K_AXIS]) - steps.k,
-      int32_t(trajMod.u[idx] * planner.settings.axis_steps_per_mm[U_AXIS]) - steps.u,
-      int32_t(trajMod.v[idx] * planner.settings.axis_steps_per_mm[V_AXIS]) - steps.v,
-      int32_t(trajMod.w[idx] * planner.settings.axis_steps_per_mm[W_AXIS]) - steps.w
+// Interpolates a run of data points to stepper commands.
+void FxdTiCtrl::convertToSteps(const uint32_t idx, const uint32_t count) {
+
+  // Steps per mm are constant over the run, so fetch them once
+  const xyze_float_t spm = LOGICAL_AXIS_ARRAY(
+    planner.settings.axis_steps_per_mm[E_AXIS_N(current_block->extruder)],
+    planner.settings.axis_steps_per_mm[X_AXIS],
+    planner.settings.axis_steps_per_mm[Y_AXIS],
+    planner.settings.axis_steps_per_mm[Z_AXIS],
+    planner.settings.axis_steps_per_mm[I_AXIS],
+    planner.settings.axis_steps_per_mm[J_AXIS],
+    planner.settings.axis_steps_per_mm[K_AXIS],
+    planner.settings.axis_steps_per_mm[U_AXIS],
+    planner.settings.axis_steps_per_mm[V_AXIS],
+    planner.settings.axis_steps_per_mm[W_AXIS]
+  );
+
+  #if ENABLED(FTM_FIXED_POINT)
+    const XYZEval<int64_t> spm_q = LOGICAL_AXIS_ARRAY(
+      ftm_fixed(spm.e, FTM_SPM_BITS),
+      ftm_fixed(spm.x, FTM_SPM_BITS), ftm_fixed(spm.y, FTM_SPM_BITS), ftm_fixed(spm.z, FTM_SPM_BITS),
+      ftm_fixed(spm.i, FTM_SPM_BITS), ftm_fixed(spm.j, FTM_SPM_BITS), ftm_fixed(spm.k, FTM_SPM_BITS),
+      ftm_fixed(spm.u, FTM_SPM_BITS), ftm_fixed(spm.v, FTM_SPM_BITS), ftm_fixed(spm.w, FTM_SPM_BITS)
     );
   #endif
 
@@ -703,33 +894,72 @@ void FxdTiCtrl::convertToSteps(const uint32_t idx) {
       }
     };
 
-  for (uint32_t i = 0U; i < (FTM_STEPS_PER_UNIT_TIME); i++) {
+  for (uint32_t n = idx; n < idx + count; n++) {
+
+    //#define STEPS_ROUNDING
+    #if ENABLED(FTM_FIXED_POINT)
+      #define _STEPS_SHIFT ((FTM_POS_BITS) + (FTM_SPM_BITS))
+      #if ENABLED(STEPS_ROUNDING)
+        #define _STEPS_TAR(A) ((int64_t(trajMod.A[n]) * spm_q.A + (1LL << (_STEPS_SHIFT - 1))) >> _STEPS_SHIFT)
+      #else
+        // Truncate toward zero, like the float cast below
+        #define _STEPS_TAR(A) ftm_trunc(int64_t(trajMod.A[n]) * spm_q.A, _STEPS_SHIFT)
+      #endif
+    #elif ENABLED(STEPS_ROUNDING)
+      #define _STEPS_TAR(A) (trajMod.A[n] * spm.A + (trajMod.A[n] < 0.0f ? -0.5f : 0.5f))
+    #else
+      #define _STEPS_TAR(A) (trajMod.A[n] * spm.A)
+    #endif
+    const xyze_long_t delta = LOGICAL_AXIS_ARRAY(
+      int32_t(_STEPS_TAR(e)) - steps.e,
+      int32_t(_STEPS_TAR(x)) - steps.x,
+      int32_t(_STEPS_TAR(y)) - steps.y,
+      int32_t(_STEPS_TAR(z)) - steps.z,
+      int32_t(_STEPS_TAR(i)) - steps.i,
+      int32_t(_STEPS_TAR(j)) - steps.j,
+      int32_t(_STEPS_TAR(k)) - steps.k,
+      int32_t(_STEPS_TAR(u)) - steps.u,
+      int32_t(_STEPS_TAR(v)) - steps.v,
+      int32_t(_STEPS_TAR(w)) - steps.w
+    );
+    #undef _STEPS_TAR
+    #undef _STEPS_SHIFT
+
+    // An axis with no delta never steps, so only the moving axes are visited
+    const bool LOGICAL_AXIS_LIST(
+      move_e = delta.e, move_x = delta.x, move_y = delta.y, move_z = delta.z,
+      move_i = delta.i, move_j = delta.j, move_k = delta.k,
+      move_u = delta.u, move_v = delta.v, move_w = delta.w
+    );
+
+    xyze_long_t err_P = { 0 };
 
-    // TODO: (?) Since the *delta variables will not change,
-    // the comparison may be done once before iterating at
-    // expense of storage and lines of code.
+    for (uint32_t i = 0U; i < (FTM_STEPS_PER_UNIT_TIME); i++) {
 
-    // Init all step/dir bits to 0 (defaulting to reverse/negative motion)
-    stepperCmdBuff[stepperCmdBuff_produceIdx] = 0;
+      // Init all step/dir bits to 0 (defaulting to reverse/negative motion)
+      ft_command_t &cmd = stepperCmdBuff[stepperCmdBuff_produceIdx];
+      cmd = 0;
 
-    // Set up step/dir bits for all axes
-    LOGICAL_AXIS_CODE(
-      COMMAND_SET(delta.e, err_P.e, steps.e, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_E), _BV(FT_BIT_STEP_E)),
-      COMMAND_SET(delta.x, err_P.x, steps.x, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_X), _BV(FT_BIT_STEP_X)),
-      COMMAND_SET(delta.y, err_P.y, steps.y, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_Y), _BV(FT_BIT_STEP_Y)),
-      COMMAND_SET(delta.z, err_P.z, steps.z, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_Z), _BV(FT_BIT_STEP_Z)),
-      COMMAND_SET(delta.i, err_P.i, steps.i, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_I), _BV(FT_BIT_STEP_I)),
-      COMMAND_SET(delta.j, err_P.j, steps.j, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_J), _BV(FT_BIT_STEP_J)),
-      COMMAND_SET(delta.k, err_P.k, steps.k, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_K), _BV(FT_BIT_STEP_K)),
-      COMMAND_SET(delta.u, err_P.u, steps.u, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_U), _BV(FT_BIT_STEP_U)),
-      COMMAND_SET(delta.v, err_P.v, steps.v, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_V), _BV(FT_BIT_STEP_V)),
-      COMMAND_SET(delta.w, err_P.w, steps.w, stepperCmdBuff[stepperCmdBuff_produceIdx], _BV(FT_BIT_DIR_W), _BV(FT_BIT_STEP_W)),
-    );
+      // Set up step/dir bits for all moving axes
+      LOGICAL_AXIS_CODE(
+        if (move_e) COMMAND_SET(delta.e, err_P.e, steps.e, cmd, _BV(FT_BIT_DIR_E), _BV(FT_BIT_STEP_E)),
+        if (move_x) COMMAND_SET(delta.x, err_P.x, steps.x, cmd, _BV(FT_BIT_DIR_X), _BV(FT_BIT_STEP_X)),
+        if (move_y) COMMAND_SET(delta.y, err_P.y, steps.y, cmd, _BV(FT_BIT_DIR_Y), _BV(FT_BIT_STEP_Y)),
+        if (move_z) COMMAND_SET(delta.z, err_P.z, steps.z, cmd, _BV(FT_BIT_DIR_Z), _BV(FT_BIT_STEP_Z)),
+        if (move_i) COMMAND_SET(delta.i, err_P.i, steps.i, cmd, _BV(FT_BIT_DIR_I), _BV(FT_BIT_STEP_I)),
+        if (move_j) COMMAND_SET(delta.j, err_P.j, steps.j, cmd, _BV(FT_BIT_DIR_J), _BV(FT_BIT_STEP_J)),
+        if (move_k) COMMAND_SET(delta.k, err_P.k, steps.k, cmd, _BV(FT_BIT_DIR_K), _BV(FT_BIT_STEP_K)),
+        if (move_u) COMMAND_SET(delta.u, err_P.u, steps.u, cmd, _BV(FT_BIT_DIR_U), _BV(FT_BIT_STEP_U)),
+        if (move_v) COMMAND_SET(delta.v, err_P.v, steps.v, cmd, _BV(FT_BIT_DIR_V), _BV(FT_BIT_STEP_V)),
+        if (move_w) COMMAND_SET(delta.w, err_P.w, steps.w, cmd, _BV(FT_BIT_DIR_W), _BV(FT_BIT_STEP_W)),
+      );
+
+      if (++stepperCmdBuff_produceIdx == FTM_STEPPERCMD_BUFF_SIZE)
+        stepperCmdBuff_produceIdx = 0;
 
-    if (++stepperCmdBuff_produceIdx == FTM_STEPPERCMD_BUFF_SIZE)
-      stepperCmdBuff_produceIdx = 0;
+    } // FTM_STEPS_PER_UNIT_TIME loop
 
-  } // FTM_STEPS_PER_UNIT_TIME loop
+  } // Data point loop
 }
 
 #endif // FT_MOTION
@@ -144,6 +144,31 @@ class FxdTiCtrl {
     static uint32_t N1, N2, N3;
     static uint32_t max_intervals;
 
+    #if ENABLED(FTM_FIXED_POINT)
+      // Trapezoid data in fixed point, per data point
+      static xyze_long_t startPosn_q;       // (ft_pos_t) Start position of block
+      static xyze_long_t ratio_q;           // (ft_ratio_t) Axis move ratio of block
+      static ft_dist_t f_s_q,               // Distance for each point at the start feedrate
+                       accel_q, decel_q,    // Half the change of speed for each point, squared
+                       F_q,                 // Distance for each point at the coasting feedrate
+                       s_1e_q, s_2e_q;      // Distance after accel and after coasting
+    #endif
+
+    #if ENABLED(FTM_LEVELING)
+      static float level_fade;              // Fade factor of the mesh. 0 if the block isn't leveled.
+      static xy_pos_t level_start,          // (mm) XY at the start of the block
+                      level_per_mm;         // (mm/mm) XY change for each mm along the block
+      static float level_z_start,           // (mm) Mesh correction at the start of the block
+                   level_z_per_mm;          // (mm/mm) Correction change for each mm, as leveled by the planner
+    #endif
+
+    #if ENABLED(ARC_BLOCKS)
+      static arc_block_t arc;               // Arc of the block, if any
+      static xy_pos_t arc_center;           // (mm) Center of the arc in the P-Q plane
+      static float arc_start_angle,         // (rad) Angle of the block start around the center
+                   arc_angle_per_mm;        // (rad/mm) Sweep for each mm along the path
+    #endif
+
     // Make vector variables.
     static uint32_t makeVector_idx,
                     makeVector_idx_z1,
@@ -158,11 +183,15 @@ class FxdTiCtrl {
     #if HAS_X_AXIS
 
       typedef struct AxisShaping {
-        float d_zi[FTM_ZMAX] = { 0.0f };  // Data point delay vector.
+        ft_pos_t d_zi[FTM_ZMAX] = { 0 };  // Data point delay vector.
         float Ai[5];                      // Shaping gain vector.
+        #if ENABLED(FTM_FIXED_POINT)
+          ft_gain_t Aq[5];                // Shaping gain vector in fixed point.
+        #endif
         uint32_t Ni[5];                   // Shaping time index vector.
 
         void updateShapingN(const_float_t f, const_float_t df);
+        void shapeRun(ft_pos_t * const t, const uint32_t n, uint32_t zi, const uint32_t max_i);
 
       } axis_shaping_t;
 
@@ -184,14 +213,21 @@ class FxdTiCtrl {
 
     // Linear advance variables.
     #if HAS_EXTRUDERS
-      static float e_raw_z1, e_advanced_z1;
+      #if ENABLED(FTM_FIXED_POINT)
+        static ft_dist_t e_lead_q;
+      #else
+        static float e_raw_z1, e_advanced_z1;
+      #endif
     #endif
 
     // Private methods
     static uint32_t stepperCmdBuffItems();
     static void loadBlockData(block_t * const current_block);
-    static void makeVector();
-    static void convertToSteps(const uint32_t idx);
+    #if ENABLED(FTM_FIXED_POINT)
+      static void loadFixedData();
+    #endif
+    static void makeVector(const uint32_t budget);
+    static void convertToSteps(const uint32_t idx, const uint32_t count);
 
 }; // class fxdTiCtrl
 
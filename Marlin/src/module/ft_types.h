@@ -48,8 +48,46 @@ enum stepDirState_t : uint8_t {
   stepDirState_NEG     = 2U
 };
 
-typedef struct XYZEarray<float, FTM_WINDOW_SIZE> xyze_trajectory_t;
-typedef struct XYZEarray<float, FTM_BATCH_SIZE> xyze_trajectoryMod_t;
+#if ENABLED(FTM_FIXED_POINT)
+
+  /**
+   * Fixed-point formats for boards without an FPU
+   *
+   *  ft_pos_t   Trajectory positions. Signed mm with FTM_POS_BITS fraction bits.
+   *  ft_gain_t  Shaper gains. Signed Q1.30, so the gains of a shaper sum to 1.0.
+   *  ft_ratio_t Axis move ratios. Signed Q11.20, since the stepper moves of an
+   *             axis may exceed the block length (e.g., CoreXY or extrusion).
+   *  ft_dist_t  Distance along the block. 64-bit mm with 32 fraction bits.
+   *  Steps/mm   64-bit with FTM_SPM_BITS fraction bits.
+   */
+  typedef int32_t ft_pos_t;
+  typedef int32_t ft_gain_t;
+  typedef int32_t ft_ratio_t;
+  typedef int64_t ft_dist_t;
+
+  #define FTM_POS_BITS    12
+  #define FTM_GAIN_BITS   30
+  #define FTM_RATIO_BITS  20
+  #define FTM_DIST_BITS   32
+  #define FTM_SPM_BITS    20
+
+  FORCE_INLINE int64_t ftm_fixed(const float v, const uint8_t bits) { return llroundf(ldexpf(v, bits)); }
+  FORCE_INLINE ft_pos_t ftm_to_pos(const float v) { return ft_pos_t(ftm_fixed(v, FTM_POS_BITS)); }
+  FORCE_INLINE float ftm_to_float(const ft_pos_t v) { return ldexpf(v, -(FTM_POS_BITS)); }
+  FORCE_INLINE int64_t ftm_trunc(const int64_t v, const uint8_t bits) { return (v < 0 ? v + ((1LL << bits) - 1) : v) >> bits; }
+
+#else
+
+  typedef float ft_pos_t;
+  typedef float ft_gain_t;
+
+  FORCE_INLINE ft_pos_t ftm_to_pos(const float v) { return v; }
+  FORCE_INLINE float ftm_to_float(const ft_pos_t v) { return v; }
+
+#endif
+
+typedef struct XYZEarray<ft_pos_t, FTM_WINDOW_SIZE> xyze_trajectory_t;
+typedef struct XYZEarray<ft_pos_t, FTM_BATCH_SIZE> xyze_trajectoryMod_t;
 
 typedef struct XYZEval<stepDirState_t> xyze_stepDir_t;
 
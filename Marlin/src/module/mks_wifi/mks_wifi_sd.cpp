@@ -14,16 +14,17 @@
 #include "mks_wifi_ui.h"
 #endif
 
-volatile uint8_t *file_buff=shared_mem;
-volatile uint8_t *file_buff_pos;
+volatile uint8_t *esp_ring=shared_mem;
+volatile uint8_t *file_buff=shared_mem+ESP_RING_SIZE;
 volatile uint16_t file_data_size;
 
-volatile uint8_t *dma_buff[] = {file_buff+FILE_BUFFER_SIZE,file_buff+FILE_BUFFER_SIZE+ESP_PACKET_SIZE};
-volatile uint8_t dma_buff_index=0;
-volatile uint8_t *buff;
+//Счетчики пакетов: принятых DMA (в прерывании) и разобранных (в цикле записи)
+volatile uint32_t ring_head;
+volatile uint32_t ring_tail;
 
-volatile uint8_t buffer_ready;
-volatile uint8_t dma_stopped;
+volatile uint8_t dma_stopped;  //1 - передача от ESP приостановлена, 2 - ошибка
+
+#define RING_SLOT(N)   (esp_ring + ((N) % ESP_RING_SLOTS) * ESP_PACKET_SIZE)
 
 FIL upload_file;
 
@@ -63,6 +64,7 @@ void mks_wifi_sd_deinit(void){
 void sd_delete_file(char *filename){
    mks_wifi_sd_init();
    f_unlink(filename);
+   TERN_(HAS_SD_DIR_INDEX, card.invalidate_dir_index());
 //   mks_wifi_sd_deinit();
 }
 
@@ -119,9 +121,12 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
    uint16_t in_sector;
    uint16_t last_sector;
 
-   volatile uint32_t dma_timeout;
+   millis_t dma_timeout_ms, next_task_ms;
    uint16_t data_size;
-   int16_t save_bed,save_e0;
+   bool last_packet, resume, timed_out;
+   #if ENABLED(SD_PREALLOCATE_UPLOADS)
+      bool preallocated;
+   #endif
 
    uint32_t data_to_write=0;
    uint8_t *data_packet;
@@ -129,14 +134,6 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
    FRESULT res = FR_OK;
    FIL upload_file;
 
-   save_bed = thermalManager.degTargetBed();
-   save_e0=thermalManager.degTargetHotend(0);
-   
-   DEBUG("Saved target temp E0 %d Bed %d",save_e0,save_bed);
-
-   thermalManager.setTargetBed(0);
-   thermalManager.setTargetHotend(0,0);
-   thermalManager.task();
  	//Установить имя файла. Смещение на 3 байта, чтобы добавить путь к диску
    file_name[0]='0';
    file_name[1]=':';
@@ -168,6 +165,14 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
       return;
    }
 
+   #if ENABLED(SD_PREALLOCATE_UPLOADS)
+      //Занять под файл сразу непрерывную область, FAT не меняется при записи
+      //Поиск ограничен SD_PREALLOCATE_SCAN_SECTORS, иначе обычная запись
+      TERN_(USE_WATCHDOG, hal.watchdog_refresh());
+      preallocated = (file_size > 0) && (f_expand((FIL *)&upload_file,file_size,1) == FR_OK);
+      DEBUG("Preallocate %d bytes: %d",file_size,preallocated);
+   #endif
+
    #if ENABLED(TFT_480x320) || ENABLED(TFT_480x320_SPI)
       mks_upload_screen(file_name+3, file_size);
       #if ENABLED(SHOW_PROGRESS)
@@ -175,32 +180,31 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
       #endif
    #endif   
 
-   dma_buff_index=0;
+   // Take over the shared memory for the packet and file buffers
+   TERN_(SD_FAST_SEEK, card.drop_link_map());
+   shared_mem_owner = SHARED_MEM_WIFI_UPLOAD;
+
+   ring_head = 0;
+   ring_tail = 0;
+   dma_stopped = 0;
    file_inc_size=0; //Счетчик принятых данных, для записи в файл
    file_size_writen = 0; //Счетчик записанных в файл данных
    file_data_size = 0;
-   dma_timeout = DMA_TIMEOUT; //Тайм-аут, на случай если передача зависла.
    last_sector = 0;
-   buffer_ready = 0;
    #if ENABLED(SHOW_PROGRESS)
       old_file_size_writen = 0;
    #endif
 
    #ifdef STM32F1
-   //Отключение тактирования не используемых блоков
-   RCC->APB1ENR &= ~(RCC_APB1ENR_TIM5EN|RCC_APB1ENR_TIM4EN);
-   RCC->APB1ENR &= ~(RCC_APB1ENR_SPI2EN|RCC_APB1ENR_USART3EN);
-   RCC->APB2ENR &= ~RCC_APB2ENR_TIM1EN;
-   RCC->AHBENR &= ~(RCC_AHBENR_FSMCEN);
-
    //Максимальная частота в режиме out
    GPIOC->CRL |= GPIO_CRL_MODE7;
    GPIOC->CRL &= ~GPIO_CRL_CNF7;
 
+   //Кольцевой режим на все кольцо, каждая половина - один пакет
    DMA1_Channel5->CCR = DMA_CONF;
    DMA1_Channel5->CPAR = (uint32_t)&USART1->DR;
-   DMA1_Channel5->CMAR = (uint32_t)dma_buff[dma_buff_index];
-   DMA1_Channel5->CNDTR = ESP_PACKET_SIZE;
+   DMA1_Channel5->CMAR = (uint32_t)RING_SLOT(0);
+   DMA1_Channel5->CNDTR = ESP_RING_SIZE;
    DMA1->IFCR = DMA_IFCR_CGIF5|DMA_IFCR_CTEIF5|DMA_IFCR_CHTIF5|DMA_IFCR_CTCIF5;
    DMA1_Channel5->CCR = DMA_CONF|DMA_CCR_EN;
 
@@ -219,8 +223,10 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
    DMA2_Stream5->CR = 0;
    DMA2->HIFCR=DMA_S5_CLEAR;
    
+   //Двойной буфер: первые два слота кольца, дальше адреса переставляются в прерывании
    DMA2_Stream5->PAR = (uint32_t)&USART1->DR;
-   DMA2_Stream5->M0AR = (uint32_t)dma_buff[dma_buff_index];
+   DMA2_Stream5->M0AR = (uint32_t)RING_SLOT(0);
+   DMA2_Stream5->M1AR = (uint32_t)RING_SLOT(1);
    DMA2_Stream5->NDTR = ESP_PACKET_SIZE;
    
    DMA2_Stream5->CR = DMA_CONF|DMA_SxCR_EN;
@@ -240,163 +246,145 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
    (void)USART1->DR;
    
    TERN_(USE_WATCHDOG, hal.watchdog_refresh());
-   DEBUG("DMA1 buff: %0X", dma_buff[0]);
-   DEBUG("DMA2 buff: %0X", dma_buff[1]);
+   DEBUG("Ring: %0X, %d packets", esp_ring, ESP_RING_SLOTS);
    DEBUG("File buff: %0X size %d (%0X)", file_buff, FILE_BUFFER_SIZE, FILE_BUFFER_SIZE);
 
-   //На время передачи отключение systick
-   SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
-
-   OUT_WRITE(FAN1_PIN, HIGH);
-   OUT_WRITE(HEATER_0_PIN, LOW);
-   OUT_WRITE(HEATER_BED_PIN, LOW);
-
-   #if HOTENDS == 2
-      OUT_WRITE(HEATER_1_PIN,LOW);
-   #endif
+   //DMA принимает без участия процессора, поэтому нагрев и таймеры не отключаются,
+   //температура обслуживается прямо в цикле записи
+   dma_timeout_ms = millis() + DMA_TIMEOUT_MS;
+   next_task_ms = 0;
 
-   data_packet = 0;
+   timed_out = false;
 
-   while(--dma_timeout > 0)
+   while(1)
    {
+      if(ELAPSED(millis(), next_task_ms)){
+         next_task_ms = millis() + 50;
+         thermalManager.task();
+         TERN_(USE_WATCHDOG, hal.watchdog_refresh());
+      }
 
-      if(buffer_ready > 0){
-         
-         if(data_packet != buff){
-            data_packet = (uint8_t *)buff;
-         }else{
-            DEBUG("Change");
-           if(dma_buff_index){
-               data_packet = (uint8_t *)dma_buff[1];
-            }else{
-               data_packet = (uint8_t *)dma_buff[0];
-            }
-         }
-
-
-         if(*data_packet != ESP_PROTOC_HEAD){
-            ERROR("Wrong packet head");
-            break;
-         }
+      if(dma_stopped == 2){
+         break;
+      }
 
-         if(data_packet[1] != ESP_TYPE_FILE_FRAGMENT){
-            ERROR("Not file fragment head");
+      //Тайм-аут считается только пока нет принятых пакетов, на случай если передача зависла
+      if(ring_tail == ring_head){
+         if(ELAPSED(millis(), dma_timeout_ms)){
+            timed_out = true;
             break;
          }
+         continue;
+      }
 
-         in_sector = (*(data_packet+5) << 8) | *(data_packet+4);
-         
-         if((in_sector - last_sector) > 1){
-            ERROR("IN Sec: %d Prev sec: %d",in_sector,last_sector);
-            dma_stopped = 2;
-            break;
-         }else{
-            last_sector=in_sector;
-         }
+      data_packet = (uint8_t *)RING_SLOT(ring_tail);
 
-         data_size = (*(data_packet+3) << 8) | *(data_packet+2);
-         data_size -= 4; //4 байта с номером сегмента и флагами
+      if(*data_packet != ESP_PROTOC_HEAD){
+         ERROR("Wrong packet head");
+         break;
+      }
 
-         memcpy((uint8_t *)file_buff+file_data_size,(uint8_t*)(data_packet+8),data_size);
-         file_data_size+=data_size;
+      if(data_packet[1] != ESP_TYPE_FILE_FRAGMENT){
+         ERROR("Not file fragment head");
+         break;
+      }
 
-         //Если буфер полон и писать некуда, запись в файл
-         if((file_data_size + ESP_PACKET_SIZE) > FILE_BUFFER_SIZE){
-            data_to_write = file_data_size / 512;
-            data_to_write = data_to_write * 512;
+      in_sector = (*(data_packet+5) << 8) | *(data_packet+4);
+      
+      if((in_sector - last_sector) > 1){
+         ERROR("IN Sec: %d Prev sec: %d",in_sector,last_sector);
+         dma_stopped = 2;
+         break;
+      }else{
+         last_sector=in_sector;
+      }
 
-            file_inc_size += data_to_write; 
-            DEBUG("%d [%d]Save %d bytes (%d of %d) ",buffer_ready,in_sector,data_to_write,file_inc_size,file_size);
-            
-            res=f_write((FIL *)&upload_file,(uint8_t*)file_buff,data_to_write,&bytes_writen);
-            if(res){
-               ERROR("Write err %d",res);
-               break;
-            }
+      data_size = (*(data_packet+3) << 8) | *(data_packet+2);
+      data_size -= 4; //4 байта с номером сегмента и флагами
 
-            file_size_writen+=bytes_writen;
-            file_data_size -= data_to_write;
-            
-            memcpy((uint8_t *)file_buff,(uint8_t *)(file_buff+data_to_write),file_data_size);
-         }
-         #if ENABLED(SHOW_PROGRESS)
-         else
-         {
-            if ((file_size_writen - old_file_size_writen) > 100000)
-            {
-	            SERIAL_ECHOPGM("file_size_writen", file_size_writen/1000);	
-               mks_update_status(file_name+3, file_size_writen, file_size);
-               old_file_size_writen = file_size_writen;
-            }
-         }
-         #endif
+      //Последний пакет с данными
+      last_packet = (*(data_packet+7) == 0x80);
+      if(in_sector == 0 && data_size == file_size){
+         DEBUG("1-packet file");
+         last_packet = true;
+      }
 
-         if(in_sector == 0){
-            if(data_size == file_size){
-               DEBUG("1-packet file");
-               *(data_packet+7) = 0x80;
-            }
-         }
+      memcpy((uint8_t *)file_buff+file_data_size,(uint8_t*)(data_packet+8),data_size);
+      file_data_size+=data_size;
+
+      //Слот свободен, DMA может принимать в него, пока идет запись на карту
+      hal.isr_off();
+      ++ring_tail;
+      resume = (dma_stopped == 1) && (ring_head - ring_tail + 2 <= ESP_RING_SLOTS);
+      if(resume){
+         (void)USART1->SR;
+         GPIOC->BSRR = GPIO_BSRR_BR7;
+         dma_stopped=0;
+      }
+      hal.isr_on();
+      if(resume){
+         DEBUG("Start");
+      }
 
-         if(*(data_packet+7) == 0x80){ //Последний пакет с данными
-            WRITE(MKS_WIFI_IO4, HIGH); //Остановить передачу от ESP
-            DEBUG("Last packet");
-
-            if(file_data_size != 0 )
-            {
-               // Fixing bug with adding g-codes to the end of the file
-               if ((file_inc_size + file_data_size) > file_size)
-                  file_data_size -= (file_inc_size + file_data_size) - file_size;
-
-               file_inc_size += file_data_size; 
-
-               DEBUG("Save last %d bytes from buffer (%d of %d) ",file_data_size,file_inc_size,file_size);
-               res=f_write((FIL *)&upload_file,(uint8_t*)file_buff,file_data_size,&bytes_writen);
-               if(res){
-                  ERROR("Write err %d",res);
-                 break;
-               }
-               file_size_writen+=bytes_writen;
-            }
+      //Если буфер полон и писать некуда, запись в файл целыми секторами
+      if((file_data_size + ESP_PACKET_SIZE) > FILE_BUFFER_SIZE){
+         data_to_write = file_data_size / 512;
+         data_to_write = data_to_write * 512;
 
+         file_inc_size += data_to_write; 
+         DEBUG("%d [%d]Save %d bytes (%d of %d) ",ring_head - ring_tail,in_sector,data_to_write,file_inc_size,file_size);
+         
+         res=f_write((FIL *)&upload_file,(uint8_t*)file_buff,data_to_write,&bytes_writen);
+         if(res){
+            ERROR("Write err %d",res);
             break;
          }
 
-         if(buffer_ready > 0){
-            --buffer_ready;
-         };
-
-         if((buffer_ready == 0) && (dma_stopped == 1)){
-               DEBUG("Start");
-               (void)USART1->SR;
-               GPIOC->BSRR = GPIO_BSRR_BR7;
-               dma_stopped=0;
+         file_size_writen+=bytes_writen;
+         file_data_size -= data_to_write;
+         
+         memcpy((uint8_t *)file_buff,(uint8_t *)(file_buff+data_to_write),file_data_size);
+      }
+      #if ENABLED(SHOW_PROGRESS)
+      else
+      {
+         if ((file_size_writen - old_file_size_writen) > 100000)
+         {
+            SERIAL_ECHOPGM("file_size_writen", file_size_writen/1000);	
+            mks_update_status(file_name+3, file_size_writen, file_size);
+            old_file_size_writen = file_size_writen;
          }
+      }
+      #endif
 
-         if(dma_stopped == 2){
-            break;
+      if(last_packet){
+         WRITE(MKS_WIFI_IO4, HIGH); //Остановить передачу от ESP
+         DEBUG("Last packet");
+
+         if(file_data_size != 0 )
+         {
+            // Fixing bug with adding g-codes to the end of the file
+            if ((file_inc_size + file_data_size) > file_size)
+               file_data_size -= (file_inc_size + file_data_size) - file_size;
+
+            file_inc_size += file_data_size; 
+
+            DEBUG("Save last %d bytes from buffer (%d of %d) ",file_data_size,file_inc_size,file_size);
+            res=f_write((FIL *)&upload_file,(uint8_t*)file_buff,file_data_size,&bytes_writen);
+            if(res){
+               ERROR("Write err %d",res);
+              break;
+            }
+            file_size_writen+=bytes_writen;
          }
 
-         dma_timeout = DMA_TIMEOUT;
-      }else{
-         TERN_(USE_WATCHDOG, hal.watchdog_refresh());
+         break;
       }
-   }
-   
-   #ifdef STM32F1
-   //Включение обратно переферии
-   SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
-   RCC->APB1ENR |= (RCC_APB1ENR_TIM5EN|RCC_APB1ENR_TIM4EN);
-   RCC->APB1ENR |= (RCC_APB1ENR_SPI2EN|RCC_APB1ENR_USART3EN);
-   RCC->APB2ENR |= RCC_APB2ENR_TIM1EN;
-   RCC->AHBENR |= (RCC_AHBENR_FSMCEN);
-   #endif
 
-   #ifdef STM32F4
-   SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
-   #endif
+      dma_timeout_ms = millis() + DMA_TIMEOUT_MS;
+   }
    
-   if((dma_timeout == 0) || (dma_stopped == 2)) {
+   if(timed_out || (dma_stopped == 2)) {
       #ifdef STM32F1
       DEBUG("DMA timeout, NDTR: %d",DMA1_Channel5->CNDTR);
       #endif
@@ -428,7 +416,15 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
 
    TERN_(USE_WATCHDOG, hal.watchdog_refresh());
    
+   #if ENABLED(SD_PREALLOCATE_UPLOADS)
+      //Файл был создан сразу полного размера, обрезать до записанного
+      if(preallocated && file_size_writen < file_size){
+         f_truncate((FIL *)&upload_file);
+      }
+   #endif
    f_close((FIL *)&upload_file);
+   shared_mem_owner = SHARED_MEM_FREE;
+   TERN_(HAS_SD_DIR_INDEX, card.invalidate_dir_index());
    DEBUG("File closed");
 
    if( (file_size == file_inc_size) && (file_size == file_size_writen) ){
@@ -482,10 +478,20 @@ void mks_wifi_start_file_upload(ESP_PROTOC_FRAME *packet)
 
 
    TERN_(USE_WATCHDOG, hal.watchdog_refresh());
-   thermalManager.setTargetBed(save_bed);
-   thermalManager.setTargetHotend(save_e0,0);
-   DEBUG("Restore thermal settings E0:%d Bed:%d",save_bed,save_e0);
+}
 
+//Вызывается из прерывания DMA после каждого принятого пакета
+static inline void ring_packet_done(void){
+      ++ring_head;
+      //Свободен только слот, в который сейчас идет прием - остановить передачу от esp
+      if((ring_head - ring_tail) >= (ESP_RING_SLOTS - 1)){
+         GPIOC->BSRR = GPIO_BSRR_BS7;
+         dma_stopped=1;
+      }
+      //ESP не остановилась, DMA уже пишет в самый старый неразобранный слот
+      if((ring_head - ring_tail) >= ESP_RING_SLOTS){
+         dma_stopped=2;
+      }
 }
 
 #ifdef STM32F1
@@ -497,23 +503,10 @@ extern "C" void DMA1_Channel5_IRQHandler(void){
          DMA1->IFCR = DMA_CLEAR;
          return;
       }
-      
-      if(buffer_ready > 0){ 
-         GPIOC->BSRR = GPIO_BSRR_BS7;  //остановить передачу от esp
-         dma_stopped=1;
-      };
 
+      //Половина кольца - первый слот, конец - второй, DMA продолжает прием сам
       DMA1->IFCR = DMA_CLEAR;
-      //Указатель на полученный буфер
-      buff=dma_buff[dma_buff_index];
-      //переключить индекс
-      dma_buff_index = (dma_buff_index) ? 0 : 1;
-
-      DMA1_Channel5->CCR = DMA_CONF;
-      DMA1_Channel5->CMAR = (uint32_t)dma_buff[dma_buff_index];
-      DMA1_Channel5->CNDTR = ESP_PACKET_SIZE;
-      DMA1_Channel5->CCR = DMA_CONF|DMA_CCR_EN;
-      ++buffer_ready;
+      ring_packet_done();
 }
 #endif
 
@@ -526,25 +519,15 @@ extern "C" void DMA2_Stream5_IRQHandler(void){
          DMA2->HIFCR=DMA_S5_CLEAR;
          return;
       }
-      
-      if(buffer_ready > 0){ 
-         GPIOC->BSRR = GPIO_BSRR_BS7;  //остановить передачу от esp
-         dma_stopped=1;
-      };
 
       DMA2->HIFCR=DMA_S5_CLEAR;
-      //Указатель на полученный буфер
-      buff=dma_buff[dma_buff_index];
-      //переключить индекс
-      dma_buff_index = (dma_buff_index) ? 0 : 1;
+      ring_packet_done();
 
-
-      DMA2_Stream5->CR = DMA_CONF;
-      DMA2_Stream5->M0AR = (uint32_t)dma_buff[dma_buff_index];
-      DMA2_Stream5->NDTR = ESP_PACKET_SIZE;
-      DMA2_Stream5->CR = DMA_CONF|DMA_SxCR_EN;
-
-      ++buffer_ready;
+      //DMA уже принимает в другой буфер, освободившийся адрес - на следующий слот кольца
+      if(DMA2_Stream5->CR & DMA_SxCR_CT){
+         DMA2_Stream5->M0AR = (uint32_t)RING_SLOT(ring_head + 1);
+      }else{
+         DMA2_Stream5->M1AR = (uint32_t)RING_SLOT(ring_head + 1);
+      }
 }
 #endif
-
@@ -6,11 +6,11 @@
 
 
 
-#define DMA_TIMEOUT 0x1ffffff
+#define DMA_TIMEOUT_MS      3000        // Upload is aborted when no packet arrives for this long
 #define ESP_PACKET_SIZE     1024
 
 #ifdef STM32F1
-#define DMA_CONF    (uint32_t)(DMA_CCR_PL|DMA_CCR_MINC|DMA_CCR_TEIE|DMA_CCR_TCIE)
+#define DMA_CONF    (uint32_t)(DMA_CCR_PL|DMA_CCR_MINC|DMA_CCR_CIRC|DMA_CCR_TEIE|DMA_CCR_HTIE|DMA_CCR_TCIE)
 #define DMA_CLEAR   (uint32_t)(DMA_IFCR_CGIF5|DMA_IFCR_CTEIF5|DMA_IFCR_CHTIF5|DMA_IFCR_CTCIF5)
 #endif
 
@@ -18,7 +18,7 @@
 #define DMA_CONF			((uint32_t)( (0x04 << DMA_SxCR_CHSEL_Pos) | \
 										 (0x00 << DMA_SxCR_MBURST_Pos)| \
 										 (0x00 << DMA_SxCR_PBURST_Pos)| \
-										 (0x00 << DMA_SxCR_DBM_Pos)   | \
+										 (0x01 << DMA_SxCR_DBM_Pos)   | \
 										 (0x00 << DMA_SxCR_PL_Pos)	  | \
 										 (0x00 << DMA_SxCR_PINCOS_Pos)| \
 										 (0x00 << DMA_SxCR_MSIZE_Pos) | \
@@ -33,15 +33,17 @@
 #define DMA_S5_CLEAR            (uint32_t)(DMA_HIFCR_CTCIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5 | DMA_HIFCR_CHTIF5)
 #endif
 
-//Под буфер для DMA два последних КБ из буфера
-//#define ESP_FILE_BUFF_COUNT (SHARED_MEM_1KB_COUNT-2)
+//Кольцо пакетов для DMA в начале shared_mem. DMA не останавливается между пакетами:
+//на F1 кольцевой режим на два пакета (прерывания на половине и в конце),
+//на F4 режим двойного буфера, свободный адрес переставляется на следующий слот кольца
 #ifdef STM32F1
-	#define ESP_FILE_BUFF_COUNT 2
+	#define ESP_RING_SLOTS 2
 #else
-	#define ESP_FILE_BUFF_COUNT 4
+	#define ESP_RING_SLOTS 3
 #endif
-//Под буфер для записи в файл все оставшееся с начала
-#define FILE_BUFFER_SIZE  ESP_PACKET_SIZE*ESP_FILE_BUFF_COUNT
+#define ESP_RING_SIZE     (ESP_PACKET_SIZE*ESP_RING_SLOTS)
+//Под буфер для записи в файл целыми секторами все оставшееся
+#define FILE_BUFFER_SIZE  (SHARED_MEM_SIZE - ESP_RING_SIZE)
 
 void mks_wifi_sd_ls(void);
 
@@ -1379,7 +1379,9 @@ float get_move_distance(const xyze_pos_t &diff OPTARG(HAS_ROTATIONAL_AXES, bool
   inline bool line_to_destination_cartesian() {
     const float scaled_fr_mm_s = MMS_SCALED(feedrate_mm_s);
     #if HAS_MESH
-      if (planner.leveling_active && planner.leveling_active_at_z(destination.z)) {
+      if (planner.leveling_active && planner.leveling_active_at_z(destination.z)
+        && !TERN0(FTM_LEVELING, fxdTiCtrl.cfg.mode)  // FT_MOTION follows the mesh within each block
+      ) {
         #if ENABLED(AUTO_BED_LEVELING_UBL)
           #if UBL_SEGMENTED
             return bedlevel.line_to_destination_segmented(scaled_fr_mm_s);
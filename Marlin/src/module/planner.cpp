@@ -126,6 +126,7 @@ Planner planner;
  * A ring buffer of moves described in steps
  */
 block_t Planner::block_buffer[BLOCK_BUFFER_SIZE];
+block_meta_t Planner::block_meta[BLOCK_BUFFER_SIZE];
 volatile uint8_t Planner::block_buffer_head,    // Index of the next block to be pushed
                  Planner::block_buffer_nonbusy, // Index of the first non-busy block
                  Planner::block_buffer_planned, // Index of the optimally planned block
@@ -725,8 +726,6 @@ void Planner::init() {
   #endif
 #endif
 
-#define MINIMAL_STEP_RATE 120
-
 /**
  * Get the current block for processing
  * and mark the block as busy.
@@ -758,7 +757,7 @@ block_t* Planner::get_current_block() {
     if (block->flag.recalculate) return nullptr;
 
     // We can't be sure how long an active block will take, so don't count it.
-    TERN_(HAS_WIRED_LCD, block_buffer_runtime_us -= block->segment_time_us);
+    TERN_(HAS_WIRED_LCD, block_buffer_runtime_us -= meta(block).segment_time_us);
 
     // As this block is busy, advance the nonbusy block pointer
     block_buffer_nonbusy = next_block_index(block_buffer_tail);
@@ -1349,12 +1348,12 @@ void Planner::check_axes_activity() {
   if (has_blocks_queued()) {
 
     #if ANY(HAS_TAIL_FAN_SPEED, BARICUDA)
-      block_t *block = &block_buffer[block_buffer_tail];
+      const block_meta_t &tail_meta = block_meta[block_buffer_tail];
     #endif
 
     #if HAS_TAIL_FAN_SPEED
       FANS_LOOP(i) {
-        const uint8_t spd = thermalManager.scaledFanSpeed(i, block->fan_speed[i]);
+        const uint8_t spd = thermalManager.scaledFanSpeed(i, tail_meta.fan_speed[i]);
         if (tail_fan_speed[i] != spd) {
           fans_need_update = true;
           tail_fan_speed[i] = spd;
@@ -1363,8 +1362,8 @@ void Planner::check_axes_activity() {
     #endif
 
     #if ENABLED(BARICUDA)
-      TERN_(HAS_HEATER_1, tail_valve_pressure = block->valve_pressure);
-      TERN_(HAS_HEATER_2, tail_e_to_p_pressure = block->e_to_p_pressure);
+      TERN_(HAS_HEATER_1, tail_valve_pressure = tail_meta.valve_pressure);
+      TERN_(HAS_HEATER_2, tail_e_to_p_pressure = tail_meta.e_to_p_pressure);
     #endif
 
     #if HAS_DISABLE_AXES
@@ -1374,7 +1373,7 @@ void Planner::check_axes_activity() {
           if (TERN0(DISABLE_E, bnext->steps.e)) axis_active.e = true,
           if (TERN0(DISABLE_X, bnext->steps.x)) axis_active.x = true,
           if (TERN0(DISABLE_Y, bnext->steps.y)) axis_active.y = true,
-          if (TERN0(DISABLE_Z, bnext->steps.z)) axis_active.z = true,
+          if (TERN0(DISABLE_Z, block_moves_z(bnext))) axis_active.z = true,
           if (TERN0(DISABLE_I, bnext->steps.i)) axis_active.i = true,
           if (TERN0(DISABLE_J, bnext->steps.j)) axis_active.j = true,
           if (TERN0(DISABLE_K, bnext->steps.k)) axis_active.k = true,
@@ -1738,6 +1737,7 @@ bool Planner::busy() {
       || TERN0(EXTERNAL_CLOSED_LOOP_CONTROLLER, CLOSED_LOOP_WAITING())
       || TERN0(HAS_ZV_SHAPING, stepper.input_shaping_busy())
       || TERN0(FT_MOTION, fxdTiCtrl_busy)
+      || TERN0(STEP_STREAM, stepper.stream_busy())
   );
 }
 
@@ -2136,8 +2136,20 @@ bool Planner::_populate_block(
     )
   ) {
     block->millimeters = TERN0(HAS_EXTRUDERS, ABS(dist_mm.e));
+    TERN_(ARC_BLOCKS, meta(block).arc.sweep = 0);   // Too short to trace as an arc
+    TERN_(FTM_LEVELING, meta(block).level.fade = 0);
   }
   else {
+    TERN_(ARC_BLOCKS, meta(block).arc = hints.arc);
+    #if ENABLED(FTM_LEVELING)
+      // Let FT_MOTION follow the mesh between the leveled ends of an XY move
+      level_block_t &level = meta(block).level;
+      level.fade = (fxdTiCtrl.cfg.mode && leveling_active && (dist.x || dist.y)) ? fade_scaling_factor_for_z(target.z * mm_per_step[Z_AXIS]) : 0;
+      if (level.fade) {
+        level.start.set(position.x * mm_per_step[X_AXIS], position.y * mm_per_step[Y_AXIS]);
+        level.end.set(target.x * mm_per_step[X_AXIS], target.y * mm_per_step[Y_AXIS]);
+      }
+    #endif
     if (hints.millimeters)
       block->millimeters = hints.millimeters;
     else {
@@ -2191,12 +2203,12 @@ bool Planner::_populate_block(
   TERN_(MIXING_EXTRUDER, mixer.populate_block(block->b_color));
 
   #if HAS_FAN
-    FANS_LOOP(i) block->fan_speed[i] = thermalManager.fan_speed[i];
+    FANS_LOOP(i) meta(block).fan_speed[i] = thermalManager.fan_speed[i];
   #endif
 
   #if ENABLED(BARICUDA)
-    block->valve_pressure = baricuda_valve_pressure;
-    block->e_to_p_pressure = baricuda_e_to_p_pressure;
+    meta(block).valve_pressure = baricuda_valve_pressure;
+    meta(block).e_to_p_pressure = baricuda_e_to_p_pressure;
   #endif
 
   E_TERN_(block->extruder = extruder);
@@ -2215,14 +2227,14 @@ bool Planner::_populate_block(
     )) powerManager.power_on();
   #endif
 
-  // Enable active axes
+  // Enable active axes. FT_MOTION has no Z late enable, so a leveled block enables Z here.
   #if ANY(CORE_IS_XY, MARKFORGED_XY, MARKFORGED_YX)
     if (block->steps.a || block->steps.b) {
       stepper.enable_axis(X_AXIS);
       stepper.enable_axis(Y_AXIS);
     }
-    #if HAS_Z_AXIS && DISABLED(Z_LATE_ENABLE)
-      if (block->steps.z) stepper.enable_axis(Z_AXIS);
+    #if HAS_Z_AXIS
+      if (TERN(Z_LATE_ENABLE, TERN0(FTM_LEVELING, meta(block).level.fade), block_moves_z(block))) stepper.enable_axis(Z_AXIS);
     #endif
   #elif CORE_IS_XZ
     if (block->steps.a || block->steps.c) {
@@ -2240,7 +2252,7 @@ bool Planner::_populate_block(
     NUM_AXIS_CODE(
       if (block->steps.x) stepper.enable_axis(X_AXIS),
       if (block->steps.y) stepper.enable_axis(Y_AXIS),
-      if (TERN(Z_LATE_ENABLE, 0, block->steps.z)) stepper.enable_axis(Z_AXIS),
+      if (TERN(Z_LATE_ENABLE, TERN0(FTM_LEVELING, meta(block).level.fade), block_moves_z(block))) stepper.enable_axis(Z_AXIS),
       if (block->steps.i) stepper.enable_axis(I_AXIS),
       if (block->steps.j) stepper.enable_axis(J_AXIS),
       if (block->steps.k) stepper.enable_axis(K_AXIS),
@@ -2342,7 +2354,7 @@ bool Planner::_populate_block(
     const bool was_enabled = stepper.suspend();
 
     block_buffer_runtime_us += segment_time_us;
-    block->segment_time_us = segment_time_us;
+    meta(block).segment_time_us = segment_time_us;
 
     if (was_enabled) stepper.wake_up();
   #endif
@@ -2407,6 +2419,20 @@ bool Planner::_populate_block(
     }
   #endif
 
+  #if ENABLED(ARC_BLOCKS)
+    // The plane axes of an arc take turns carrying all of its speed and acceleration
+    // (SQRT(2) times as much for Core motors). Limit the block as plan_arc() limits segments.
+    const arc_block_t &arc = meta(block).arc;
+    const float arc_plane_share = arc.sweep ? arc.radius * ABS(arc.sweep) * inverse_millimeters : 0,
+                arc_limiting_accel = arc.sweep ? _MIN(settings.max_acceleration_mm_per_s2[arc.axis_p], settings.max_acceleration_mm_per_s2[arc.axis_q]) * TERN(IS_CORE, M_SQRT1_2, 1) : 0;
+    if (arc.sweep) {
+      const float limiting_speed = _MIN(settings.max_feedrate_mm_s[arc.axis_p] * TERN(IS_CORE, M_SQRT1_2, 1),
+                                        settings.max_feedrate_mm_s[arc.axis_q] * TERN(IS_CORE, M_SQRT1_2, 1),
+                                        SQRT(arc_limiting_accel * arc.radius));
+      NOMORE(speed_factor, limiting_speed / (block->nominal_speed * arc_plane_share));
+    }
+  #endif
+
   #ifdef XY_FREQUENCY_LIMIT
 
     static AxisBits old_direction_bits; // = 0
@@ -2446,6 +2472,21 @@ bool Planner::_populate_block(
     block->nominal_speed *= speed_factor;
   }
 
+  #if ENABLED(ARC_BLOCKS)
+    // An arc enters and leaves along its tangents, not along the chord
+    xyze_float_t arc_exit_speed;
+    if (arc.sweep) {
+      const float plane_speed = block->nominal_speed * arc_plane_share;
+      const xy_float_t t_in = arc_to_steppers(arc_tangent(arc, 0, plane_speed)),
+                       t_out = arc_to_steppers(arc_tangent(arc, arc.sweep, plane_speed));
+      current_speed[arc.axis_p] = t_in.x;
+      current_speed[arc.axis_q] = t_in.y;
+      arc_exit_speed = current_speed;
+      arc_exit_speed[arc.axis_p] = t_out.x;
+      arc_exit_speed[arc.axis_q] = t_out.y;
+    }
+  #endif
+
   // Compute and limit the acceleration rate for the trapezoid generator.
   const float steps_per_mm = block->step_event_count * inverse_millimeters;
   uint32_t accel;
@@ -2531,6 +2572,11 @@ bool Planner::_populate_block(
         LIMIT_ACCEL_FLOAT(U_AXIS, 0), LIMIT_ACCEL_FLOAT(V_AXIS, 0), LIMIT_ACCEL_FLOAT(W_AXIS, 0)
       );
     }
+
+    #if ENABLED(ARC_BLOCKS)
+      // Either plane axis may take the whole plane acceleration somewhere along the arc
+      if (arc.sweep) NOMORE(accel, CEIL(arc_limiting_accel / arc_plane_share * steps_per_mm));
+    #endif
   }
   block->acceleration_steps_per_s2 = accel;
   block->acceleration = accel / steps_per_mm;
@@ -2619,6 +2665,24 @@ bool Planner::_populate_block(
     else
       unit_vec *= inverse_millimeters;      // Use pre-calculated (1 / SQRT(x^2 + y^2 + z^2))
 
+    #if ENABLED(ARC_BLOCKS)
+      // An arc meets its neighbors along its tangents. Keep the plane share of the chord,
+      // then normalize, since inverse_millimeters is taken from the arc and not the chord.
+      xyze_float_t arc_exit_vec;
+      if (arc.sweep) {
+        const float plane = HYPOT(unit_vec[arc.axis_p], unit_vec[arc.axis_q]) * TERN(IS_CORE, M_SQRT1_2, 1);
+        const xy_float_t t_in = arc_to_steppers(arc_tangent(arc, 0, plane)),
+                         t_out = arc_to_steppers(arc_tangent(arc, arc.sweep, plane));
+        unit_vec[arc.axis_p] = t_in.x;
+        unit_vec[arc.axis_q] = t_in.y;
+        arc_exit_vec = unit_vec;
+        arc_exit_vec[arc.axis_p] = t_out.x;
+        arc_exit_vec[arc.axis_q] = t_out.y;
+        normalize_junction_vector(unit_vec);
+        normalize_junction_vector(arc_exit_vec);
+      }
+    #endif
+
     // Skip first block or when previous_nominal_speed is used as a flag for homing and offset cycles.
     if (moves_queued && !UNEAR_ZERO(previous_nominal_speed)) {
       // Compute cosine of angle between previous and current path. (prev_unit_vec is negative)
@@ -2756,7 +2820,7 @@ bool Planner::_populate_block(
     else // Init entry speed to zero. Assume it starts from rest. Planner will correct this later.
       vmax_junction_sqr = 0;
 
-    prev_unit_vec = unit_vec;
+    prev_unit_vec = TERN_(ARC_BLOCKS, arc.sweep ? arc_exit_vec :) unit_vec;
 
   #endif
 
@@ -2877,14 +2941,14 @@ bool Planner::_populate_block(
   block->flag.set_nominal(sq(block->nominal_speed) <= v_allowable_sqr);
 
   // Update previous path unit_vector and nominal speed
-  previous_speed = current_speed;
+  previous_speed = TERN_(ARC_BLOCKS, arc.sweep ? arc_exit_speed :) current_speed;
   previous_nominal_speed = block->nominal_speed;
 
   position = target;  // Update the position
 
   #if ENABLED(POWER_LOSS_RECOVERY)
-    block->sdpos = recovery.command_sdpos();
-    block->start_position = position_float.asLogical();
+    meta(block).sdpos = recovery.command_sdpos();
+    meta(block).start_position = position_float.asLogical();
   #endif
 
   TERN_(HAS_POSITION_FLOAT, position_float = target_float);
@@ -2909,6 +2973,7 @@ void Planner::buffer_sync_block(const BlockFlagBit sync_flag /*=BLOCK_BIT_SYNC_P
 
   // Clear block
   block->reset();
+  meta(block).reset();
   block->flag.apply(sync_flag);
 
   block->position = position;
@@ -2916,7 +2981,7 @@ void Planner::buffer_sync_block(const BlockFlagBit sync_flag /*=BLOCK_BIT_SYNC_P
     LOOP_NUM_AXES(axis) block->position[axis] += backlash.get_applied_steps((AxisEnum)axis);
   #endif
   #if ALL(HAS_FAN, LASER_SYNCHRONOUS_M106_M107)
-    FANS_LOOP(i) block->fan_speed[i] = thermalManager.fan_speed[i];
+    FANS_LOOP(i) meta(block).fan_speed[i] = thermalManager.fan_speed[i];
   #endif
 
   /**
@@ -3198,7 +3263,7 @@ bool Planner::buffer_line(const xyze_pos_t &cart, const_feedRate_t fr_mm_s
     block->flag.reset(BLOCK_BIT_PAGE);
 
     #if HAS_FAN
-      FANS_LOOP(i) block->fan_speed[i] = thermalManager.fan_speed[i];
+      FANS_LOOP(i) meta(block).fan_speed[i] = thermalManager.fan_speed[i];
     #endif
 
     E_TERN_(block->extruder = extruder);
@@ -281,6 +281,68 @@ typedef struct PlannerBlock {
     cutter_power_t cutter_power; // Power level for Spindle, Laser, etc.
 #endif
 
+#if ENABLED(LASER_FEATURE)
+    block_laser_t laser;
+#endif
+
+    void reset()
+    {
+      memset((char *)this, 0, sizeof(*this));
+    }
+
+  } block_t;
+
+#if ENABLED(ARC_BLOCKS)
+  /**
+   * A circular arc in the P-Q plane, queued as one planner block.
+   * The block steps still hold the chord. The ft_motion stage traces
+   * the plane axes around the center, moving the other axes linearly.
+   */
+  typedef struct {
+    float sweep;                      // (rad) Signed arc angle, CCW positive. 0 for a straight block.
+    float radius;
+    ab_float_t offset;                // Center relative to the start of the block
+    AxisEnum axis_p, axis_q;          // Plane axes
+  } arc_block_t;
+
+  // Tangent of an arc at the given angle from its start, with the given length
+  inline xy_float_t arc_tangent(const arc_block_t &arc, const_float_t angle, const_float_t length) {
+    // Radius vector from the center, rotated like plan_arc() does it
+    const float c = cos(angle), s = sin(angle),
+                rp = -arc.offset.a * c + arc.offset.b * s,
+                rq = -arc.offset.a * s - arc.offset.b * c,
+                k = (arc.sweep < 0 ? -length : length) / arc.radius;
+    return { -rq * k, rp * k };
+  }
+
+  // A vector in the arc plane as stepper axis components
+  FORCE_INLINE xy_float_t arc_to_steppers(const xy_float_t &v) {
+    #if CORE_IS_XY
+      return { v.x + CORESIGN(v.y), v.x - CORESIGN(v.y) };  // Scaled by SQRT(2), mirrored for COREXY
+    #else
+      return v;
+    #endif
+  }
+#endif
+
+#if ENABLED(FTM_LEVELING)
+  /**
+   * The planner levels the ends of a block. Under FT_MOTION the trajectory
+   * follows the mesh between them, so moves don't need to be segmented.
+   */
+  typedef struct {
+    xy_pos_t start, end;              // (mm) Ends of the block in XY
+    float fade;                       // Fade factor of the mesh. 0 when not leveled.
+  } level_block_t;
+#endif
+
+/**
+ * Block data that is only needed when the block starts or leaves the buffer.
+ * It lives in Planner::block_meta[] beside block_buffer[] (same index), so the
+ * stepper ISR works with a smaller block_t. Get it with planner.meta(block).
+ */
+typedef struct PlannerBlockMeta {
+
 #if HAS_FAN
     uint8_t fan_speed[FAN_COUNT];
 #endif
@@ -298,8 +360,12 @@ typedef struct PlannerBlock {
     xyze_pos_t start_position;
 #endif
 
-#if ENABLED(LASER_FEATURE)
-    block_laser_t laser;
+#if ENABLED(ARC_BLOCKS)
+    arc_block_t arc;
+#endif
+
+#if ENABLED(FTM_LEVELING)
+    level_block_t level;
 #endif
 
     void reset()
@@ -307,7 +373,7 @@ typedef struct PlannerBlock {
       memset((char *)this, 0, sizeof(*this));
     }
 
-  } block_t;
+  } block_meta_t;
 
 #if ANY(LIN_ADVANCE, FEEDRATE_SCALING, GRADIENT_MIX, LCD_SHOW_E_TOTAL, POWER_LOSS_RECOVERY)
   #define HAS_POSITION_FLOAT 1
@@ -315,6 +381,8 @@ typedef struct PlannerBlock {
 
 #define BLOCK_MOD(n) ((n)&(BLOCK_BUFFER_SIZE-1))
 
+#define MINIMAL_STEP_RATE 120 // (steps/s) Slowest initial and final rate of a block
+
 #if ENABLED(LASER_FEATURE)
   typedef struct {
     /**
@@ -400,6 +468,9 @@ struct PlannerHints {
                                       // i.e., at or below the exit speed of the segment that the planner
                                       // would calculate if it knew the as-yet-unbuffered path
   #endif
+  #if ENABLED(ARC_BLOCKS)
+    arc_block_t arc{0};               // Arc geometry, if this move is a native arc block
+  #endif
 
   #if HAS_ROTATIONAL_AXES
     bool cartesian_move = true;       // True if linear motion of the tool centerpoint relative to the workpiece occurs.
@@ -426,6 +497,7 @@ class Planner {
      *  Reader of tail is Stepper::isr(). Always consider tail busy / read-only
      */
     static block_t block_buffer[BLOCK_BUFFER_SIZE];
+    static block_meta_t block_meta[BLOCK_BUFFER_SIZE]; // Cold data of block_buffer[], same index
     static volatile uint8_t block_buffer_head,      // Index of the next block to be pushed
                             block_buffer_nonbusy,   // Index of the first non busy block
                             block_buffer_planned,   // Index of the optimally planned block
@@ -792,6 +864,16 @@ class Planner {
     // Check if movement queue is full
     FORCE_INLINE static bool is_full() { return block_buffer_tail == next_block_index(block_buffer_head); }
 
+    // Cold data of a block in block_buffer[]
+    FORCE_INLINE static block_meta_t& meta(const block_t * const block) { return block_meta[block - block_buffer]; }
+
+    #if HAS_Z_AXIS
+      // Z moves with Z steps, and with FTM_LEVELING in any leveled XY block
+      FORCE_INLINE static bool block_moves_z(const block_t * const block) {
+        return block->steps.z || TERN0(FTM_LEVELING, meta(block).level.fade);
+      }
+    #endif
+
     // Get count of movement slots free
     FORCE_INLINE static uint8_t moves_free() { return BLOCK_BUFFER_SIZE - 1 - movesplanned(); }
 
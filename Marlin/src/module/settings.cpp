@@ -36,7 +36,7 @@
  */
 
 // Change EEPROM version if the structure changes
-#define EEPROM_VERSION "V88"
+#define EEPROM_VERSION "V90"
 #define EEPROM_OFFSET 100
 
 // Check the integrity of data offsets.
@@ -278,8 +278,9 @@ typedef struct SettingsDataStruct {
   float mbl_z_offset;                                   // bedlevel.z_offset
   uint8_t mesh_num_x, mesh_num_y;                       // GRID_MAX_POINTS_X, GRID_MAX_POINTS_Y
   uint16_t mesh_check;                                  // Hash to check against X/Y
-  float mbl_z_values[TERN(MESH_BED_LEVELING, GRID_MAX_POINTS_X, 3)]   // bedlevel.z_values
-                    [TERN(MESH_BED_LEVELING, GRID_MAX_POINTS_Y, 3)];
+  TERN(MESH_BED_LEVELING, mesh_z_t, float)             // bedlevel.z_values
+    mbl_z_values[TERN(MESH_BED_LEVELING, GRID_MAX_POINTS_X, 3)]
+                [TERN(MESH_BED_LEVELING, GRID_MAX_POINTS_Y, 3)];
 
   //
   // HAS_BED_PROBE
@@ -626,10 +627,12 @@ typedef struct SettingsDataStruct {
   #if ENABLED(INPUT_SHAPING_X)
     float shaping_x_frequency,                          // M593 X F
           shaping_x_zeta;                               // M593 X D
+    uint8_t shaping_x_type;                             // M593 X T
   #endif
   #if ENABLED(INPUT_SHAPING_Y)
     float shaping_y_frequency,                          // M593 Y F
           shaping_y_zeta;                               // M593 Y D
+    uint8_t shaping_y_type;                             // M593 Y T
   #endif
 
   planner_axinvert_t      invert_axes;
@@ -1036,7 +1039,7 @@ void MarlinSettings::postprocess() {
       #endif
 
       #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
-        EEPROM_WRITE(bedlevel.z_values);              // 9-256 floats
+        EEPROM_WRITE(bedlevel.z_values);              // 9-256 mesh values
       #else
         dummyf = 0;
         for (uint16_t q = grid_max_x * grid_max_y; q--;) EEPROM_WRITE(dummyf);
@@ -1757,10 +1760,12 @@ void MarlinSettings::postprocess() {
       #if ENABLED(INPUT_SHAPING_X)
         EEPROM_WRITE(stepper.get_shaping_frequency(X_AXIS));
         EEPROM_WRITE(stepper.get_shaping_damping_ratio(X_AXIS));
+        EEPROM_WRITE(uint8_t(stepper.get_shaping_type(X_AXIS)));
       #endif
       #if ENABLED(INPUT_SHAPING_Y)
         EEPROM_WRITE(stepper.get_shaping_frequency(Y_AXIS));
         EEPROM_WRITE(stepper.get_shaping_damping_ratio(Y_AXIS));
+        EEPROM_WRITE(uint8_t(stepper.get_shaping_type(Y_AXIS)));
       #endif
     #endif
 
@@ -2016,7 +2021,8 @@ void MarlinSettings::postprocess() {
           else {
             // EEPROM data is stale
             if (!validating) bedlevel.reset();
-            for (uint16_t q = mesh_num_x * mesh_num_y; q--;) EEPROM_READ(dummyf);
+            mesh_z_t dummyz;
+            for (uint16_t q = mesh_num_x * mesh_num_y; q--;) EEPROM_READ(dummyz);
           }
         #else
           // MBL is disabled - skip the stored data
@@ -2073,18 +2079,21 @@ void MarlinSettings::postprocess() {
           if (grid_max_x == (GRID_MAX_POINTS_X) && grid_max_y == (GRID_MAX_POINTS_Y)) {
             if (!validating) set_bed_leveling_enabled(false);
             bedlevel.set_grid(spacing, start);
-            EEPROM_READ(bedlevel.z_values);                 // 9 to 256 floats
+            EEPROM_READ(bedlevel.z_values);                 // 9 to 256 mesh values
           }
           else if (grid_max_x > (GRID_MAX_POINTS_X) || grid_max_y > (GRID_MAX_POINTS_Y)) {
             eeprom_error = ERR_EEPROM_CORRUPT;
             break;
           }
-          else // EEPROM data is stale
-        #endif // AUTO_BED_LEVELING_BILINEAR
-          {
-            // Skip past disabled (or stale) Bilinear Grid data
-            for (uint16_t q = grid_max_x * grid_max_y; q--;) EEPROM_READ(dummyf);
+          else {
+            // Skip past stale Bilinear Grid data
+            mesh_z_t dummyz;
+            for (uint16_t q = grid_max_x * grid_max_y; q--;) EEPROM_READ(dummyz);
           }
+        #else
+          // Skip past disabled Bilinear Grid data
+          for (uint16_t q = grid_max_x * grid_max_y; q--;) EEPROM_READ(dummyf);
+        #endif
       }
 
       //
@@ -2856,7 +2865,10 @@ void MarlinSettings::postprocess() {
       #if ENABLED(INPUT_SHAPING_X)
       {
         float _data[2];
+        uint8_t _type;
         EEPROM_READ(_data);
+        EEPROM_READ(_type);
+        stepper.set_shaping_type(X_AXIS, shaping_type_t(_type));
         stepper.set_shaping_frequency(X_AXIS, _data[0]);
         stepper.set_shaping_damping_ratio(X_AXIS, _data[1]);
       }
@@ -2865,7 +2877,10 @@ void MarlinSettings::postprocess() {
       #if ENABLED(INPUT_SHAPING_Y)
       {
         float _data[2];
+        uint8_t _type;
         EEPROM_READ(_data);
+        EEPROM_READ(_type);
+        stepper.set_shaping_type(Y_AXIS, shaping_type_t(_type));
         stepper.set_shaping_frequency(Y_AXIS, _data[0]);
         stepper.set_shaping_damping_ratio(Y_AXIS, _data[1]);
       }
@@ -3788,10 +3803,12 @@ void MarlinSettings::reset() {
   //
   #if HAS_ZV_SHAPING
     #if ENABLED(INPUT_SHAPING_X)
+      stepper.set_shaping_type(X_AXIS, shaping_type_t(SHAPING_TYPE_X));
       stepper.set_shaping_frequency(X_AXIS, SHAPING_FREQ_X);
       stepper.set_shaping_damping_ratio(X_AXIS, SHAPING_ZETA_X);
     #endif
     #if ENABLED(INPUT_SHAPING_Y)
+      stepper.set_shaping_type(Y_AXIS, shaping_type_t(SHAPING_TYPE_Y));
       stepper.set_shaping_frequency(Y_AXIS, SHAPING_FREQ_Y);
       stepper.set_shaping_damping_ratio(Y_AXIS, SHAPING_ZETA_Y);
     #endif
@@ -4110,19 +4127,21 @@ void MarlinSettings::reset() {
 
     TERN_(MPCTEMP, gcode.M306_report(forReplay));
 
-    CONFIG_ECHO_HEADING("Touch calibration values");
-    tft_string.set("#define TOUCH_CALIBRATION_X ");
-    tft_string.add(i32tostr6rj(touch_calibration.calibration.x));
-    SERIAL_ECHOLN((char*)(tft_string.string()));
-    tft_string.set("#define TOUCH_CALIBRATION_Y ");
-    tft_string.add(i32tostr6rj(touch_calibration.calibration.y));
-    SERIAL_ECHOLN((char*)(tft_string.string()));
-    tft_string.set("#define TOUCH_OFFSET_X      ");
-    tft_string.add(i32tostr6rj(touch_calibration.calibration.offset_x));
-    SERIAL_ECHOLN((char*)(tft_string.string()));
-    tft_string.set("#define TOUCH_OFFSET_Y      ");
-    tft_string.add(i32tostr6rj(touch_calibration.calibration.offset_y));
-    SERIAL_ECHOLN((char*)(tft_string.string()));
+    #if ENABLED(TOUCH_SCREEN_CALIBRATION)
+      CONFIG_ECHO_HEADING("Touch calibration values");
+      tft_string.set("#define TOUCH_CALIBRATION_X ");
+      tft_string.add(i32tostr6rj(touch_calibration.calibration.x));
+      SERIAL_ECHOLN((char*)(tft_string.string()));
+      tft_string.set("#define TOUCH_CALIBRATION_Y ");
+      tft_string.add(i32tostr6rj(touch_calibration.calibration.y));
+      SERIAL_ECHOLN((char*)(tft_string.string()));
+      tft_string.set("#define TOUCH_OFFSET_X      ");
+      tft_string.add(i32tostr6rj(touch_calibration.calibration.offset_x));
+      SERIAL_ECHOLN((char*)(tft_string.string()));
+      tft_string.set("#define TOUCH_OFFSET_Y      ");
+      tft_string.add(i32tostr6rj(touch_calibration.calibration.offset_y));
+      SERIAL_ECHOLN((char*)(tft_string.string()));
+    #endif
   }
 
 #endif // !DISABLE_M503
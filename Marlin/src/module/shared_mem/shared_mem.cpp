@@ -1,4 +1,5 @@
 #include "shared_mem.h"
 
 volatile uint8_t __attribute__ ((aligned (4))) shared_mem[SHARED_MEM_SIZE];
+volatile uint8_t shared_mem_owner = SHARED_MEM_FREE;
 
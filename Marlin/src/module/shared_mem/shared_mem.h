@@ -15,6 +15,12 @@
   #define SHARED_MEM_SIZE         SHARED_MEM_1KB_COUNT*1024
 #endif
 
+// Current user of the shared memory. Only one user at a time may own it.
+#define SHARED_MEM_FREE           0
+#define SHARED_MEM_FILE_LINKMAP   1   // Cluster link map of the printed file (CardReader)
+#define SHARED_MEM_WIFI_UPLOAD    2   // File buffers of the MKS WiFi upload
+
 extern volatile uint8_t shared_mem[SHARED_MEM_SIZE];
+extern volatile uint8_t shared_mem_owner;
 
 #endif
\ No newline at end of file
@@ -258,18 +258,12 @@ uint32_t Stepper::advance_divisor = 0,
   uint16_t            ShapingQueue::tail = 0;
 
   #if ENABLED(INPUT_SHAPING_X)
-    shaping_time_t  ShapingQueue::delay_x;
-    shaping_time_t  ShapingQueue::peek_x_val = shaping_time_t(-1);
-    uint16_t        ShapingQueue::head_x = 0;
-    uint16_t        ShapingQueue::_free_count_x = shaping_echoes - 1;
-    ShapeParams     Stepper::shaping_x;
+    shaping_echo_heads_t ShapingQueue::echoes_x = { 1, { shaping_time_t(-1) }, { shaping_time_t(-1) }, shaping_time_t(-1), { 0 }, shaping_echoes - 1 };
+    ShapeParams          Stepper::shaping_x;
   #endif
   #if ENABLED(INPUT_SHAPING_Y)
-    shaping_time_t  ShapingQueue::delay_y;
-    shaping_time_t  ShapingQueue::peek_y_val = shaping_time_t(-1);
-    uint16_t        ShapingQueue::head_y = 0;
-    uint16_t        ShapingQueue::_free_count_y = shaping_echoes - 1;
-    ShapeParams     Stepper::shaping_y;
+    shaping_echo_heads_t ShapingQueue::echoes_y = { 1, { shaping_time_t(-1) }, { shaping_time_t(-1) }, shaping_time_t(-1), { 0 }, shaping_echoes - 1 };
+    ShapeParams          Stepper::shaping_y;
   #endif
 #endif
 
@@ -281,6 +275,20 @@ uint32_t Stepper::advance_divisor = 0,
   page_step_state_t Stepper::page_step_state;
 #endif
 
+#if ENABLED(STEP_STREAM)
+  step_event_t Stepper::stream_buff[STEP_STREAM_SIZE];
+  volatile uint16_t Stepper::stream_head, Stepper::stream_tail; // = 0
+  uint32_t Stepper::stream_rate, Stepper::stream_accel,
+           Stepper::stream_slowdowns, Stepper::stream_stalls; // = 0
+  #if ENABLED(POWER_LOSS_RECOVERY)
+    stream_resume_t Stepper::stream_resume[BLOCK_BUFFER_SIZE];
+    volatile uint8_t Stepper::stream_resume_head, Stepper::stream_resume_tail; // = 0
+  #endif
+  #if HAS_FILAMENT_RUNOUT_DISTANCE
+    int32_t Stepper::stream_e_start;
+  #endif
+#endif
+
 hal_timer_t Stepper::ticks_nominal = 0;
 #if DISABLED(S_CURVE_ACCELERATION)
   uint32_t Stepper::acc_step_rate; // needed for deceleration start point
@@ -1526,7 +1534,21 @@ void Stepper::isr() {
 
     #endif
 
-    if (!using_fxtictrl) {
+    #if ENABLED(STEP_STREAM)
+
+      // Step events were pre-computed by stream_fill(), so just pop and pulse
+      constexpr bool using_step_stream = true;
+      if (!nextMainISR) nextMainISR = stream_isr();
+      interval = _MIN(nextMainISR, uint32_t(HAL_TIMER_TYPE_MAX));
+      nextMainISR -= interval;
+
+    #else
+
+      constexpr bool using_step_stream = false;
+
+    #endif
+
+    if (!using_fxtictrl && !using_step_stream) {
 
       TERN_(HAS_ZV_SHAPING, shaping_isr());               // Do Shaper stepping, if needed
 
@@ -1646,7 +1668,7 @@ void Stepper::isr() {
       next_isr_ticks = min_ticks;
 
       // When forced out of the ISR, increase multi-stepping
-      #if MULTISTEPPING_LIMIT > 1
+      #if MULTISTEPPING_LIMIT > 1 && DISABLED(STEP_STREAM)
         if (steps_per_isr < MULTISTEPPING_LIMIT) {
           steps_per_isr <<= 1;
           // ticks_nominal will need to be recalculated if we are in cruise phase
@@ -1963,11 +1985,11 @@ void Stepper::pulse_phase_isr() {
         // do the first part of the secondary bresenham
         #if ENABLED(INPUT_SHAPING_X)
           if (x_step)
-            PULSE_PREP_SHAPING(X, shaping_x.delta_error, shaping_x.forward ? shaping_x.factor1 : -shaping_x.factor1);
+            PULSE_PREP_SHAPING(X, shaping_x.delta_error, shaping_x.forward ? shaping_x.factor[0] : -shaping_x.factor[0]);
         #endif
         #if ENABLED(INPUT_SHAPING_Y)
           if (y_step)
-            PULSE_PREP_SHAPING(Y, shaping_y.delta_error, shaping_y.forward ? shaping_y.factor1 : -shaping_y.factor1);
+            PULSE_PREP_SHAPING(Y, shaping_y.delta_error, shaping_y.forward ? shaping_y.factor[0] : -shaping_y.factor[0]);
         #endif
       #endif
     }
@@ -2071,24 +2093,31 @@ void Stepper::pulse_phase_isr() {
 
   void Stepper::shaping_isr() {
     AxisFlags step_needed{0};
+    int8_t echo_x = -1, echo_y = -1;
 
     // Clear the echoes that are ready to process. If the buffers are too full and risk overflow, also apply echoes early.
-    TERN_(INPUT_SHAPING_X, step_needed.x = !ShapingQueue::peek_x() || ShapingQueue::free_count_x() < steps_per_isr);
-    TERN_(INPUT_SHAPING_Y, step_needed.y = !ShapingQueue::peek_y() || ShapingQueue::free_count_y() < steps_per_isr);
+    #define _SHAPING_DUE() do{ \
+      TERN_(INPUT_SHAPING_X, echo_x = ShapingQueue::due_x(steps_per_isr); step_needed.x = echo_x >= 0); \
+      TERN_(INPUT_SHAPING_Y, echo_y = ShapingQueue::due_y(steps_per_isr); step_needed.y = echo_y >= 0); \
+    }while(0)
+
+    _SHAPING_DUE();
 
     if (bool(step_needed)) while (true) {
       #if ENABLED(INPUT_SHAPING_X)
         if (step_needed.x) {
-          const bool forward = ShapingQueue::dequeue_x();
-          PULSE_PREP_SHAPING(X, shaping_x.delta_error, (forward ? shaping_x.factor2 : -shaping_x.factor2));
+          const bool forward = ShapingQueue::dequeue_x(echo_x);
+          const int16_t factor = shaping_x.factor[echo_x + 1];
+          PULSE_PREP_SHAPING(X, shaping_x.delta_error, (forward ? factor : -factor));
           PULSE_START(X);
         }
       #endif
 
       #if ENABLED(INPUT_SHAPING_Y)
         if (step_needed.y) {
-          const bool forward = ShapingQueue::dequeue_y();
-          PULSE_PREP_SHAPING(Y, shaping_y.delta_error, (forward ? shaping_y.factor2 : -shaping_y.factor2));
+          const bool forward = ShapingQueue::dequeue_y(echo_y);
+          const int16_t factor = shaping_y.factor[echo_y + 1];
+          PULSE_PREP_SHAPING(Y, shaping_y.delta_error, (forward ? factor : -factor));
           PULSE_START(Y);
         }
       #endif
@@ -2109,14 +2138,15 @@ void Stepper::pulse_phase_isr() {
         #endif
       }
 
-      TERN_(INPUT_SHAPING_X, step_needed.x = !ShapingQueue::peek_x() || ShapingQueue::free_count_x() < steps_per_isr);
-      TERN_(INPUT_SHAPING_Y, step_needed.y = !ShapingQueue::peek_y() || ShapingQueue::free_count_y() < steps_per_isr);
+      _SHAPING_DUE();
 
       if (!bool(step_needed)) break;
 
       START_TIMED_PULSE();
       AWAIT_LOW_PULSE();
     }
+
+    #undef _SHAPING_DUE
   }
 
 #endif // HAS_ZV_SHAPING
@@ -2216,6 +2246,94 @@ hal_timer_t Stepper::calc_multistep_timer_interval(uint32_t step_rate) {
   return calc_timer_interval(step_rate);
 }
 
+/**
+ * Get the axes that will move for the given block, for proper endstop handling.
+ * Core kinematics move the head along an axis only for some step combinations.
+ */
+FORCE_INLINE static AxisBits moving_axes(const block_t * const block) {
+  #if IS_CORE
+    // Define conditions for checking endstops
+    #define S_(N) block->steps[CORE_AXIS_##N]
+    #define D_(N) block->direction_bits[CORE_AXIS_##N]
+  #endif
+
+  #if CORE_IS_XY || CORE_IS_XZ
+    /**
+     * Head direction in -X axis for CoreXY and CoreXZ bots.
+     *
+     * If steps differ, both axes are moving.
+     * If DeltaA == -DeltaB, the movement is only in the 2nd axis (Y or Z, handled below)
+     * If DeltaA ==  DeltaB, the movement is only in the 1st axis (X)
+     */
+    #if ANY(COREXY, COREXZ)
+      #define X_CMP(A,B) ((A)==(B))
+    #else
+      #define X_CMP(A,B) ((A)!=(B))
+    #endif
+    #define X_MOVE_TEST ( S_(1) != S_(2) || (S_(1) > 0 && X_CMP(D_(1),D_(2))) )
+  #elif ENABLED(MARKFORGED_XY)
+    #define X_MOVE_TEST (block->steps.a != block->steps.b)
+  #else
+    #define X_MOVE_TEST !!block->steps.a
+  #endif
+
+  #if CORE_IS_XY || CORE_IS_YZ
+    /**
+     * Head direction in -Y axis for CoreXY / CoreYZ bots.
+     *
+     * If steps differ, both axes are moving
+     * If DeltaA ==  DeltaB, the movement is only in the 1st axis (X or Y)
+     * If DeltaA == -DeltaB, the movement is only in the 2nd axis (Y or Z)
+     */
+    #if ANY(COREYX, COREYZ)
+      #define Y_CMP(A,B) ((A)==(B))
+    #else
+      #define Y_CMP(A,B) ((A)!=(B))
+    #endif
+    #define Y_MOVE_TEST ( S_(1) != S_(2) || (S_(1) > 0 && Y_CMP(D_(1),D_(2))) )
+  #elif ENABLED(MARKFORGED_YX)
+    #define Y_MOVE_TEST (block->steps.a != block->steps.b)
+  #else
+    #define Y_MOVE_TEST !!block->steps.b
+  #endif
+
+  #if CORE_IS_XZ || CORE_IS_YZ
+    /**
+     * Head direction in -Z axis for CoreXZ or CoreYZ bots.
+     *
+     * If steps differ, both axes are moving
+     * If DeltaA ==  DeltaB, the movement is only in the 1st axis (X or Y, already handled above)
+     * If DeltaA == -DeltaB, the movement is only in the 2nd axis (Z)
+     */
+    #if ANY(COREZX, COREZY)
+      #define Z_CMP(A,B) ((A)==(B))
+    #else
+      #define Z_CMP(A,B) ((A)!=(B))
+    #endif
+    #define Z_MOVE_TEST ( S_(1) != S_(2) || (S_(1) > 0 && Z_CMP(D_(1),D_(2))) )
+  #else
+    #define Z_MOVE_TEST !!block->steps.c
+  #endif
+
+  AxisBits didmove;
+  NUM_AXIS_CODE(
+    if (X_MOVE_TEST)            didmove.a = true,
+    if (Y_MOVE_TEST)            didmove.b = true,
+    if (Z_MOVE_TEST)            didmove.c = true,
+    if (block->steps.i)         didmove.i = true,
+    if (block->steps.j)         didmove.j = true,
+    if (block->steps.k)         didmove.k = true,
+    if (block->steps.u)         didmove.u = true,
+    if (block->steps.v)         didmove.v = true,
+    if (block->steps.w)         didmove.w = true
+  );
+  //if (block->steps.e) didmove.e = true;
+  //if (block->steps.a) didmove.x = true;
+  //if (block->steps.b) didmove.y = true;
+  //if (block->steps.c) didmove.z = true;
+  return didmove;
+}
+
 /**
  * This last phase of the stepper interrupt processes and properly
  * schedules planner blocks. This is executed after the step pulses
@@ -2473,7 +2591,7 @@ hal_timer_t Stepper::block_phase_isr() {
           }
         #endif
 
-        TERN_(LASER_SYNCHRONOUS_M106_M107, if (current_block->is_fan_sync()) planner.sync_fan_speeds(current_block->fan_speed));
+        TERN_(LASER_SYNCHRONOUS_M106_M107, if (current_block->is_fan_sync()) planner.sync_fan_speeds(planner.meta(current_block).fan_speed));
 
         if (!(current_block->is_fan_sync() || current_block->is_pwr_sync())) _set_position(current_block->position);
 
@@ -2492,8 +2610,9 @@ hal_timer_t Stepper::block_phase_isr() {
       #endif
 
       #if ENABLED(POWER_LOSS_RECOVERY)
-        recovery.info.sdpos = current_block->sdpos;
-        recovery.info.current_position = current_block->start_position;
+        const block_meta_t &meta = planner.meta(current_block);
+        recovery.info.sdpos = meta.sdpos;
+        recovery.info.current_position = meta.start_position;
       #endif
 
       #if ENABLED(DIRECT_STEPPING)
@@ -2514,88 +2633,7 @@ hal_timer_t Stepper::block_phase_isr() {
       #endif
 
       // Flag all moving axes for proper endstop handling
-
-      #if IS_CORE
-        // Define conditions for checking endstops
-        #define S_(N) current_block->steps[CORE_AXIS_##N]
-        #define D_(N) current_block->direction_bits[CORE_AXIS_##N]
-      #endif
-
-      #if CORE_IS_XY || CORE_IS_XZ
-        /**
-         * Head direction in -X axis for CoreXY and CoreXZ bots.
-         *
-         * If steps differ, both axes are moving.
-         * If DeltaA == -DeltaB, the movement is only in the 2nd axis (Y or Z, handled below)
-         * If DeltaA ==  DeltaB, the movement is only in the 1st axis (X)
-         */
-        #if ANY(COREXY, COREXZ)
-          #define X_CMP(A,B) ((A)==(B))
-        #else
-          #define X_CMP(A,B) ((A)!=(B))
-        #endif
-        #define X_MOVE_TEST ( S_(1) != S_(2) || (S_(1) > 0 && X_CMP(D_(1),D_(2))) )
-      #elif ENABLED(MARKFORGED_XY)
-        #define X_MOVE_TEST (current_block->steps.a != current_block->steps.b)
-      #else
-        #define X_MOVE_TEST !!current_block->steps.a
-      #endif
-
-      #if CORE_IS_XY || CORE_IS_YZ
-        /**
-         * Head direction in -Y axis for CoreXY / CoreYZ bots.
-         *
-         * If steps differ, both axes are moving
-         * If DeltaA ==  DeltaB, the movement is only in the 1st axis (X or Y)
-         * If DeltaA == -DeltaB, the movement is only in the 2nd axis (Y or Z)
-         */
-        #if ANY(COREYX, COREYZ)
-          #define Y_CMP(A,B) ((A)==(B))
-        #else
-          #define Y_CMP(A,B) ((A)!=(B))
-        #endif
-        #define Y_MOVE_TEST ( S_(1) != S_(2) || (S_(1) > 0 && Y_CMP(D_(1),D_(2))) )
-      #elif ENABLED(MARKFORGED_YX)
-        #define Y_MOVE_TEST (current_block->steps.a != current_block->steps.b)
-      #else
-        #define Y_MOVE_TEST !!current_block->steps.b
-      #endif
-
-      #if CORE_IS_XZ || CORE_IS_YZ
-        /**
-         * Head direction in -Z axis for CoreXZ or CoreYZ bots.
-         *
-         * If steps differ, both axes are moving
-         * If DeltaA ==  DeltaB, the movement is only in the 1st axis (X or Y, already handled above)
-         * If DeltaA == -DeltaB, the movement is only in the 2nd axis (Z)
-         */
-        #if ANY(COREZX, COREZY)
-          #define Z_CMP(A,B) ((A)==(B))
-        #else
-          #define Z_CMP(A,B) ((A)!=(B))
-        #endif
-        #define Z_MOVE_TEST ( S_(1) != S_(2) || (S_(1) > 0 && Z_CMP(D_(1),D_(2))) )
-      #else
-        #define Z_MOVE_TEST !!current_block->steps.c
-      #endif
-
-      AxisBits didmove;
-      NUM_AXIS_CODE(
-        if (X_MOVE_TEST)            didmove.a = true,
-        if (Y_MOVE_TEST)            didmove.b = true,
-        if (Z_MOVE_TEST)            didmove.c = true,
-        if (current_block->steps.i) didmove.i = true,
-        if (current_block->steps.j) didmove.j = true,
-        if (current_block->steps.k) didmove.k = true,
-        if (current_block->steps.u) didmove.u = true,
-        if (current_block->steps.v) didmove.v = true,
-        if (current_block->steps.w) didmove.w = true
-      );
-      //if (current_block->steps.e) didmove.e = true;
-      //if (current_block->steps.a) didmove.x = true;
-      //if (current_block->steps.b) didmove.y = true;
-      //if (current_block->steps.c) didmove.z = true;
-      axis_did_move = didmove;
+      axis_did_move = moving_axes(current_block);
 
       // No acceleration / deceleration time elapsed so far
       acceleration_time = deceleration_time = 0;
@@ -3104,30 +3142,78 @@ void Stepper::init() {
 
 #if HAS_ZV_SHAPING
 
+  // Impulses of each shaper, the first at time 0
+  constexpr uint8_t shaper_impulses[NUM_SHAPERS] = { 2, 3, 4, 3, 3 };
+
+  // Delays of the echoes in half periods of the shaping frequency
+  constexpr float shaper_delays[NUM_SHAPERS][3] = {
+    { 1 },              // ZV
+    { 1, 2 },           // EI
+    { 1, 2, 3 },        // 2HEI
+    { 1, 2 },           // ZVD
+    { 0.75f, 1.5f }     // MZV
+  };
+
+  uint8_t Stepper::get_shaping_impulses(const shaping_type_t type) { return shaper_impulses[type]; }
+
   /**
-   * Calculate a fixed point factor to apply to the signal and its echo
+   * Calculate fixed point factors to apply to the signal and its echoes
    * when shaping an axis.
    */
   void Stepper::set_shaping_damping_ratio(const AxisEnum axis, const_float_t zeta) {
-    // From the damping ratio, get a factor that can be applied to advance_dividend for fixed-point maths.
-    // For ZV, we use amplitudes 1/(1+K) and K/(1+K) where K = exp(-zeta * π / sqrt(1.0f - zeta * zeta))
-    // which can be converted to 1:7 fixed point with an excellent fit with a 3rd-order polynomial.
-    float factor2;
-    if (zeta <= 0.0f) factor2 = 64.0f;
-    else if (zeta >= 1.0f) factor2 = 0.0f;
+    const shaping_type_t type = TERN(INPUT_SHAPING_X, TERN_(INPUT_SHAPING_Y, axis == Y_AXIS ? shaping_y.type :) shaping_x.type, shaping_y.type);
+    uint8_t factor[SHAPING_MAX_IMPULSES] = { 0 };
+
+    if (type == SHAPER_ZV) {
+      // From the damping ratio, get a factor that can be applied to advance_dividend for fixed-point maths.
+      // For ZV, we use amplitudes 1/(1+K) and K/(1+K) where K = exp(-zeta * π / sqrt(1.0f - zeta * zeta))
+      // which can be converted to 1:7 fixed point with an excellent fit with a 3rd-order polynomial.
+      float factor2;
+      if (zeta <= 0.0f) factor2 = 64.0f;
+      else if (zeta >= 1.0f) factor2 = 0.0f;
+      else {
+        factor2 = 64.44056192 + -99.02008832 * zeta;
+        const float zeta2 = sq(zeta);
+        factor2 += -7.58095488 * zeta2;
+        const float zeta3 = zeta2 * zeta;
+        factor2 += 43.073216 * zeta3;
+        factor2 = floor(factor2);
+      }
+      factor[1] = factor2;
+    }
     else {
-      factor2 = 64.44056192 + -99.02008832 * zeta;
-      const float zeta2 = sq(zeta);
-      factor2 += -7.58095488 * zeta2;
-      const float zeta3 = zeta2 * zeta;
-      factor2 += 43.073216 * zeta3;
-      factor2 = floor(factor2);
+      // Amplitudes as in FxdTiCtrl::updateShapingA, from K and the vibration tolerance
+      const float K = zeta < 1.0f ? exp(-zeta * M_PI / sqrt(1.0f - sq(zeta))) : 0.0f,
+                  K2 = sq(K), V = SHAPING_V_TOL;
+      float A[4] = { 0 };
+      switch (type) {
+        default: break;
+        case SHAPER_ZVD: A[0] = 1.0f; A[1] = 2.0f * K; A[2] = K2; break;
+        case SHAPER_MZV: A[0] = 1.0f; A[1] = M_SQRT2 * K; A[2] = K2; break;
+        case SHAPER_EI:  A[0] = 0.25f * (1.0f + V); A[1] = 0.5f * (1.0f - V) * K; A[2] = A[0] * K2; break;
+        case SHAPER_2HEI: {
+          const float V2 = sq(V), X = pow(V2 * (sqrt(1.0f - V2) + 1.0f), 1.0f / 3.0f);
+          A[0] = (3.0f * sq(X) + 2.0f * X + 3.0f * V2) / (16.0f * X);
+          A[1] = (0.5f - A[0]) * K;
+          A[2] = A[1] * K;
+          A[3] = A[0] * K2 * K;
+        } break;
+      }
+      const uint8_t impulses = _MIN(shaper_impulses[type], SHAPING_MAX_IMPULSES);
+      float sum = 0.0f;
+      for (uint8_t i = 0; i < impulses; i++) sum += A[i];
+      for (uint8_t i = 1; i < impulses; i++) factor[i] = LROUND(A[i] * 128.0f / sum);
     }
 
+    // The first impulse takes the rest, so every step adds up to exactly one step
+    uint8_t echoes = 0;
+    for (uint8_t i = 1; i < SHAPING_MAX_IMPULSES; i++) echoes += factor[i];
+    factor[0] = 128 - echoes;
+
     const bool was_on = hal.isr_state();
     hal.isr_off();
-    TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) { shaping_x.factor2 = factor2; shaping_x.factor1 = 128 - factor2; shaping_x.zeta = zeta; })
-    TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) { shaping_y.factor2 = factor2; shaping_y.factor1 = 128 - factor2; shaping_y.zeta = zeta; })
+    TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) { COPY(shaping_x.factor, factor); shaping_x.zeta = zeta; })
+    TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) { COPY(shaping_y.factor, factor); shaping_y.zeta = zeta; })
     if (was_on) hal.isr_on();
   }
 
@@ -3141,13 +3227,18 @@ void Stepper::init() {
     // enabling or disabling shaping whilst moving can result in lost steps
     planner.synchronize();
 
+    const shaping_type_t type = TERN(INPUT_SHAPING_X, TERN_(INPUT_SHAPING_Y, axis == Y_AXIS ? shaping_y.type :) shaping_x.type, shaping_y.type);
+    const uint8_t echoes = shaper_impulses[type] - 1;
+    shaping_time_t delays[shaping_max_echoes];
+    for (uint8_t k = 0; k < echoes; k++)
+      delays[k] = freq ? float(uint32_t(STEPPER_TIMER_RATE) / 2) * shaper_delays[type][k] / freq : shaping_time_t(-1);
+
     const bool was_on = hal.isr_state();
     hal.isr_off();
 
-    const shaping_time_t delay = freq ? float(uint32_t(STEPPER_TIMER_RATE) / 2) / freq : shaping_time_t(-1);
     #if ENABLED(INPUT_SHAPING_X)
       if (axis == X_AXIS) {
-        ShapingQueue::set_delay(X_AXIS, delay);
+        ShapingQueue::set_delays(X_AXIS, echoes, delays);
         shaping_x.frequency = freq;
         shaping_x.enabled = !!freq;
         shaping_x.delta_error = 0;
@@ -3156,7 +3247,7 @@ void Stepper::init() {
     #endif
     #if ENABLED(INPUT_SHAPING_Y)
       if (axis == Y_AXIS) {
-        ShapingQueue::set_delay(Y_AXIS, delay);
+        ShapingQueue::set_delays(Y_AXIS, echoes, delays);
         shaping_y.frequency = freq;
         shaping_y.enabled = !!freq;
         shaping_y.delta_error = 0;
@@ -3173,6 +3264,22 @@ void Stepper::init() {
     return -1;
   }
 
+  // Switch shapers with an empty queue and recompute the amplitudes and delays
+  void Stepper::set_shaping_type(const AxisEnum axis, const shaping_type_t type) {
+    if (type >= NUM_SHAPERS || shaper_impulses[type] > SHAPING_MAX_IMPULSES) return;
+    planner.synchronize();
+    TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) shaping_x.type = type);
+    TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) shaping_y.type = type);
+    set_shaping_damping_ratio(axis, get_shaping_damping_ratio(axis));
+    set_shaping_frequency(axis, get_shaping_frequency(axis));
+  }
+
+  shaping_type_t Stepper::get_shaping_type(const AxisEnum axis) {
+    TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) return shaping_x.type);
+    TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) return shaping_y.type);
+    return SHAPER_ZV;
+  }
+
 #endif // HAS_ZV_SHAPING
 
 /**
@@ -3535,7 +3642,8 @@ void Stepper::report_positions() {
     AxisBits didmove;
     static abce_ulong_t debounce{0};
     auto debounce_axis = [&](const AxisEnum axis) {
-      if (current_block->steps[axis]) debounce[axis] = (AXIS_DID_MOVE_DEB) * 400; // divide by 0.0025f */
+      if (TERN_(HAS_Z_AXIS, axis == Z_AXIS ? planner.block_moves_z(current_block) :) current_block->steps[axis])
+        debounce[axis] = (AXIS_DID_MOVE_DEB) * 400; // divide by 0.0025f */
       if (debounce[axis]) { didmove.bset(axis); debounce[axis]--; }
     };
     #define _DEBOUNCE(N) debounce_axis(AxisEnum(N));
@@ -3547,6 +3655,389 @@ void Stepper::report_positions() {
 
 #endif // FT_MOTION
 
+#if ENABLED(STEP_STREAM)
+
+  // A SW memory barrier, so a step event is completely written before stream_isr() can see it
+  #define stream_barrier() __asm__ __volatile__("": : :"memory")
+
+  /**
+   * Advance the trapezoid generator of current_block past one step event and return
+   * the interval to the next step event. This is the math of block_phase_isr(), minus
+   * multi-stepping and oversampling, since the ISR no longer limits the step rate.
+   */
+  hal_timer_t Stepper::stream_next_interval() {
+
+    // Are we in acceleration phase ?
+    if (step_events_completed <= accelerate_until) {
+      #if ENABLED(S_CURVE_ACCELERATION)
+        const uint32_t acc_step_rate = acceleration_time < current_block->acceleration_time
+                                       ? _eval_bezier_curve(acceleration_time)
+                                       : current_block->cruise_rate;
+      #else
+        acc_step_rate = STEP_MULTIPLY(acceleration_time, current_block->acceleration_rate) + current_block->initial_rate;
+        NOMORE(acc_step_rate, current_block->nominal_rate);
+      #endif
+      const hal_timer_t interval = calc_timer_interval(acc_step_rate);
+      acceleration_time += interval;
+      return interval;
+    }
+
+    // Are we in deceleration phase ?
+    if (step_events_completed > decelerate_after) {
+      uint32_t step_rate;
+      #if ENABLED(S_CURVE_ACCELERATION)
+        if (!bezier_2nd_half) {
+          // Initialize the Bézier speed curve. The first point starts at cruise rate.
+          _calc_bezier_curve_coeffs(current_block->cruise_rate, current_block->final_rate, current_block->deceleration_time_inverse);
+          bezier_2nd_half = true;
+          step_rate = current_block->cruise_rate;
+        }
+        else {
+          step_rate = deceleration_time < current_block->deceleration_time
+            ? _eval_bezier_curve(deceleration_time)
+            : current_block->final_rate;
+        }
+      #else
+        step_rate = STEP_MULTIPLY(deceleration_time, current_block->acceleration_rate);
+        if (step_rate < acc_step_rate) { // Still decelerating?
+          step_rate = acc_step_rate - step_rate;
+          NOLESS(step_rate, current_block->final_rate);
+        }
+        else
+          step_rate = current_block->final_rate;
+      #endif
+      const hal_timer_t interval = calc_timer_interval(step_rate);
+      deceleration_time += interval;
+      return interval;
+    }
+
+    // Must be in cruise phase otherwise
+    if (ticks_nominal == 0) ticks_nominal = calc_timer_interval(current_block->nominal_rate);
+    return ticks_nominal;
+  }
+
+  /**
+   * Producer of the step stream, called from idle(). Take blocks from the planner and
+   * turn them into step events until the ring is full. A block is released back to the
+   * planner as soon as all its step events are in the ring, so Planner::busy() also
+   * waits for the ring to empty. Runout and power-loss state follow the ISR, not this.
+   *
+   * NOTE: A quick stop drops every event in the ring, including those of any following
+   *       blocks already converted. Homing and probing synchronize after each move, so
+   *       the endstops only ever abort the last block.
+   */
+  void Stepper::stream_fill() {
+
+    // Handle a quick stop: stream_isr() drops events until the ring is empty,
+    // then forget the block being converted and signal the abort is finished.
+    if (abort_current_block) {
+      if (stream_busy()) return;
+      if (current_block) {
+        current_block = nullptr;
+        planner.release_current_block();
+      }
+      abort_current_block = false;
+    }
+
+    for (;;) {
+      uint16_t next = stream_head + 1;
+      if (next == STEP_STREAM_SIZE) next = 0;
+      if (next == stream_tail) return;            // Ring is full
+
+      step_event_t &ev = stream_buff[stream_head];
+
+      if (!current_block) {
+        // Wait for a free resume point, as there's one for each block in the ring
+        #if ENABLED(POWER_LOSS_RECOVERY)
+          const uint8_t resume_next = BLOCK_MOD(stream_resume_head + 1);
+          if (resume_next == stream_resume_tail) return;
+        #endif
+
+        if (!(current_block = planner.get_current_block())) return;
+
+        if (!current_block->is_sync()) {
+          // Start of a new block. The marker makes the ISR set up directions and endstops.
+          ev.flags = STEP_EVENT_BLOCK;
+          ev.step = moving_axes(current_block);
+          ev.dir = current_block->direction_bits;
+          E_TERN_(ev.extruder = current_block->extruder);
+
+          #if HAS_CUTTER
+            if (cutter.cutter_mode == CUTTER_MODE_STANDARD) cutter.apply_power(current_block->cutter_power);
+          #endif
+
+          // The ISR saves the resume point when it gets to the marker
+          #if ENABLED(POWER_LOSS_RECOVERY)
+            const block_meta_t &meta = planner.meta(current_block);
+            stream_resume_t &resume = stream_resume[stream_resume_head];
+            resume.sdpos = meta.sdpos;
+            resume.start_position = meta.start_position;
+            stream_barrier();
+            stream_resume_head = resume_next;
+          #endif
+
+          TERN_(Z_LATE_ENABLE, if (current_block->steps.z) enable_axis(Z_AXIS));
+
+          // Initialize the Bresenham line tracer and the trapezoid generator
+          step_event_count = current_block->step_event_count;
+          delta_error = -int32_t(step_event_count);
+          advance_dividend = (current_block->steps << 1).asLong();
+          advance_divisor = step_event_count << 1;
+          step_events_completed = 0;
+          accelerate_until = current_block->accelerate_until;
+          decelerate_after = current_block->decelerate_after;
+          acceleration_time = deceleration_time = 0;
+          ticks_nominal = 0;
+
+          #if ENABLED(S_CURVE_ACCELERATION)
+            _calc_bezier_curve_coeffs(current_block->initial_rate, current_block->cruise_rate, current_block->acceleration_time_inverse);
+            bezier_2nd_half = false;
+          #else
+            acc_step_rate = current_block->initial_rate;
+          #endif
+
+          // The first step follows the marker after the initial interval
+          ev.interval = calc_timer_interval(current_block->initial_rate);
+          acceleration_time += ev.interval;
+
+          stream_barrier();
+          stream_head = next;
+          continue;
+        }
+      }
+
+      if (current_block->is_sync()) {
+        // Position and fan syncs apply to the steps before them, so wait until those are pulsed
+        if (stream_busy()) return;
+
+        TERN_(LASER_SYNCHRONOUS_M106_M107, if (current_block->is_fan_sync()) planner.sync_fan_speeds(planner.meta(current_block).fan_speed));
+
+        if (!(current_block->is_fan_sync() || current_block->is_pwr_sync())) {
+          const bool was_enabled = suspend();
+          _set_position(current_block->position);
+          if (was_enabled) wake_up();
+        }
+
+        current_block = nullptr;
+        planner.release_current_block();
+        continue;
+      }
+
+      // Bresenham: find the axes stepping on this step event
+      AxisBits step;
+      LOOP_LOGICAL_AXES(i) {
+        delta_error[i] += advance_dividend[i];
+        if (delta_error[i] >= 0) {
+          delta_error[i] -= advance_divisor;
+          step.bset(AxisEnum(i));
+        }
+      }
+
+      ev.step = step;
+      ev.dir = current_block->direction_bits;
+
+      if (++step_events_completed >= step_event_count) {
+        // Last step event. The next block's marker carries the interval to its first step.
+        ev.flags = STEP_EVENT_LAST;
+        ev.interval = 0;
+        current_block = nullptr;
+        planner.release_current_block();
+      }
+      else {
+        ev.flags = 0;
+        ev.interval = stream_next_interval();
+      }
+
+      stream_barrier();
+      stream_head = next;
+    }
+  }
+
+  /**
+   * Limit the step rate while the ring runs low, so the axes slow down within their
+   * acceleration limits instead of stopping dead when the ring runs dry. Once the
+   * main loop catches up, accelerate back until the stream's own rate is reached.
+   */
+  hal_timer_t Stepper::stream_govern(const hal_timer_t interval, const bool low) {
+    const uint32_t rate = (STEPPER_TIMER_RATE) / interval;
+    if (!stream_rate) {
+      if (!low) return interval;
+      stream_rate = rate;
+      stream_slowdowns++;
+    }
+
+    const uint32_t dv = _MAX(stream_accel / stream_rate, 1UL);
+    if (low)
+      stream_rate = stream_rate > dv + (MINIMAL_STEP_RATE) ? stream_rate - dv : MINIMAL_STEP_RATE;
+    else if ((stream_rate += dv) >= rate) {
+      stream_rate = 0;
+      return interval;
+    }
+
+    NOMORE(stream_rate, rate);
+    return _MAX(interval, calc_timer_interval(stream_rate));
+  }
+
+  /**
+   * The Step Stream ISR phase. Pulse the next pre-computed step event
+   * and return the interval to the one after it.
+   */
+  hal_timer_t Stepper::stream_isr() {
+    static bool in_block = false, stalled = false;
+    static uint16_t last_level = 0;
+
+    // Quick stop: drop everything until stream_fill() has finished the abort
+    if (abort_current_block) {
+      stream_tail = stream_head;
+      TERN_(POWER_LOSS_RECOVERY, stream_resume_tail = stream_resume_head);
+      in_block = stalled = false;
+      stream_rate = 0;
+      axis_did_move.reset();
+      return (STEPPER_TIMER_RATE) / 1000UL;
+    }
+
+    uint16_t tail = stream_tail;
+    const uint16_t head = stream_head;
+    if (tail == head) {
+      // Ran dry mid-block? Hold here, and when the events come back resume from a crawl.
+      if (in_block) {
+        if (!stalled) { stalled = true; stream_stalls++; }
+        stream_rate = MINIMAL_STEP_RATE;
+        return (STEPPER_TIMER_RATE) / 20000UL;
+      }
+      // Between blocks look again soon if stream_fill() has more to convert, otherwise wait 1ms
+      if (current_block || planner.has_blocks_queued()) return (STEPPER_TIMER_RATE) / 20000UL;
+      stream_rate = 0;
+      return (STEPPER_TIMER_RATE) / 1000UL;
+    }
+    stalled = false;
+
+    // The ring is low if it keeps draining while stream_fill() still owes events of a block
+    const uint16_t level = (head < tail ? STEP_STREAM_SIZE : 0) + head - tail;
+    const bool low = level < (STEP_STREAM_LOW_WATER) && level <= last_level && current_block && !current_block->is_sync();
+    last_level = level - 1;
+
+    const step_event_t &ev = stream_buff[tail];
+
+    if (ev.flags & STEP_EVENT_BLOCK) {
+      in_block = true;
+      axis_did_move = ev.step;
+
+      E_TERN_(stepper_extruder = ev.extruder);
+
+      // Slow down no faster than the weakest axis in the block can
+      uint32_t accel = UINT32_MAX;
+      LOOP_NUM_AXES(i) if (ev.step[i]) NOMORE(accel, planner.max_acceleration_steps_per_s2[i]);
+      TERN_(HAS_EXTRUDERS, if (ev.step.e) NOMORE(accel, planner.max_acceleration_steps_per_s2[E_AXIS_N(stepper_extruder)]));
+      stream_accel = accel;
+
+      #if ENABLED(POWER_LOSS_RECOVERY)
+        const uint8_t resume_tail = stream_resume_tail;
+        if (resume_tail != stream_resume_head) {
+          recovery.info.sdpos = stream_resume[resume_tail].sdpos;
+          recovery.info.current_position = stream_resume[resume_tail].start_position;
+          stream_resume_tail = BLOCK_MOD(resume_tail + 1);
+        }
+      #endif
+
+      TERN_(HAS_FILAMENT_RUNOUT_DISTANCE, stream_e_start = count_position.e);
+      if ( ENABLED(DUAL_X_CARRIAGE)
+        || ev.dir != last_direction_bits
+        || TERN0(HAS_MULTI_EXTRUDER, stepper_extruder != last_moved_extruder)
+      ) {
+        E_TERN_(last_moved_extruder = stepper_extruder);
+        set_directions(ev.dir);
+      }
+
+      // If the endstop is already pressed, endstop interrupts won't invoke
+      // endstop_triggered and the move will grind. So check here for a
+      // triggered endstop, which aborts the stream on the next ISR.
+      endstops.update();
+    }
+    else if (ev.step) {
+      USING_TIMED_PULSE();
+
+      const AxisBits step = ev.step;
+
+      // Start a step pulse
+      LOGICAL_AXIS_CODE(
+        if (step.e) { E_APPLY_STEP(STEP_STATE_E, false); },
+        if (step.x) { X_APPLY_STEP(STEP_STATE_X, false); }, if (step.y) { Y_APPLY_STEP(STEP_STATE_Y, false); },
+        if (step.z) { Z_APPLY_STEP(STEP_STATE_Z, false); }, if (step.i) { I_APPLY_STEP(STEP_STATE_I, false); },
+        if (step.j) { J_APPLY_STEP(STEP_STATE_J, false); }, if (step.k) { K_APPLY_STEP(STEP_STATE_K, false); },
+        if (step.u) { U_APPLY_STEP(STEP_STATE_U, false); }, if (step.v) { V_APPLY_STEP(STEP_STATE_V, false); },
+        if (step.w) { W_APPLY_STEP(STEP_STATE_W, false); }
+      );
+
+      // Begin waiting for the minimum pulse duration
+      START_TIMED_PULSE();
+
+      // Update stepper counts - required for various operations
+      LOGICAL_AXIS_CODE(
+        if (step.e) count_position.e += count_direction.e,
+        if (step.x) count_position.x += count_direction.x, if (step.y) count_position.y += count_direction.y,
+        if (step.z) count_position.z += count_direction.z, if (step.i) count_position.i += count_direction.i,
+        if (step.j) count_position.j += count_direction.j, if (step.k) count_position.k += count_direction.k,
+        if (step.u) count_position.u += count_direction.u, if (step.v) count_position.v += count_direction.v,
+        if (step.w) count_position.w += count_direction.w
+      );
+
+      #if HAS_EXTRUDERS
+        #if ENABLED(E_DUAL_STEPPER_DRIVERS)
+          constexpr bool e_axis_has_dedge = AXIS_HAS_DEDGE(E0) && AXIS_HAS_DEDGE(E1);
+        #else
+          #define _EDGE_BIT(N) | (AXIS_HAS_DEDGE(E##N) << TOOL_ESTEPPER(N))
+          constexpr Flags<E_STEPPERS> e_stepper_dedge { 0 REPEAT(EXTRUDERS, _EDGE_BIT) };
+          const bool e_axis_has_dedge = e_stepper_dedge[stepper_extruder];
+        #endif
+      #endif
+
+      // Only wait for axes without edge stepping
+      const bool any_wait = false LOGICAL_AXIS_GANG(
+        || (!e_axis_has_dedge && step.e),
+        || (!AXIS_HAS_DEDGE(X) && step.x), || (!AXIS_HAS_DEDGE(Y) && step.y), || (!AXIS_HAS_DEDGE(Z) && step.z),
+        || (!AXIS_HAS_DEDGE(I) && step.i), || (!AXIS_HAS_DEDGE(J) && step.j), || (!AXIS_HAS_DEDGE(K) && step.k),
+        || (!AXIS_HAS_DEDGE(U) && step.u), || (!AXIS_HAS_DEDGE(V) && step.v), || (!AXIS_HAS_DEDGE(W) && step.w)
+      );
+
+      // Allow pulses to be registered by stepper drivers
+      if (any_wait) AWAIT_HIGH_PULSE();
+
+      // Stop pulses. Axes with DEDGE will do nothing, assuming STEP_STATE_* is HIGH
+      LOGICAL_AXIS_CODE(
+        if (step.e) { E_APPLY_STEP(!STEP_STATE_E, false); },
+        if (step.x) { X_APPLY_STEP(!STEP_STATE_X, false); }, if (step.y) { Y_APPLY_STEP(!STEP_STATE_Y, false); },
+        if (step.z) { Z_APPLY_STEP(!STEP_STATE_Z, false); }, if (step.i) { I_APPLY_STEP(!STEP_STATE_I, false); },
+        if (step.j) { J_APPLY_STEP(!STEP_STATE_J, false); }, if (step.k) { K_APPLY_STEP(!STEP_STATE_K, false); },
+        if (step.u) { U_APPLY_STEP(!STEP_STATE_U, false); }, if (step.v) { V_APPLY_STEP(!STEP_STATE_V, false); },
+        if (step.w) { W_APPLY_STEP(!STEP_STATE_W, false); }
+      );
+    }
+
+    if (ev.flags & STEP_EVENT_LAST) {
+      #if HAS_FILAMENT_RUNOUT_DISTANCE
+        // Count the block's filament now that its steps are done
+        block_t done;
+        done.steps.x = axis_did_move.x || axis_did_move.y || axis_did_move.z;
+        done.steps.y = done.steps.z = 0;
+        done.steps.e = ABS(count_position.e - stream_e_start);
+        done.direction_bits = last_direction_bits;
+        E_TERN_(done.extruder = stepper_extruder);
+        runout.block_completed(&done);
+      #endif
+      in_block = false;
+      axis_did_move.reset();
+    }
+
+    hal_timer_t interval = ev.interval;
+    if (++tail == STEP_STREAM_SIZE) tail = 0;
+    stream_tail = tail;
+    if (interval && (stream_rate || low)) interval = stream_govern(interval, low);
+    return interval;
+  }
+
+#endif // STEP_STREAM
+
 #if ENABLED(BABYSTEPPING)
 
   #define _ENABLE_AXIS(A) enable_axis(_AXIS(A))
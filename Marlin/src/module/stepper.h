@@ -160,8 +160,11 @@ constexpr ena_mask_t enable_overlap[] = {
   #ifndef SHAPING_MIN_FREQ
     #define SHAPING_MIN_FREQ _MIN(0x7FFFFFFFL OPTARG(INPUT_SHAPING_X, SHAPING_FREQ_X) OPTARG(INPUT_SHAPING_Y, SHAPING_FREQ_Y))
   #endif
+  // Each step is split into SHAPING_MAX_IMPULSES impulses at most. The last echo of a step
+  // comes (SHAPING_MAX_IMPULSES - 1) half periods later, so the queue must cover that long.
+  constexpr uint8_t shaping_max_echoes = (SHAPING_MAX_IMPULSES) - 1;
   constexpr uint16_t shaping_min_freq = SHAPING_MIN_FREQ,
-                     shaping_echoes = max_step_rate / shaping_min_freq / 2 + 3;
+                     shaping_echoes = max_step_rate / shaping_min_freq / 2 * shaping_max_echoes + 3;
 
   typedef hal_timer_t shaping_time_t;
   enum shaping_echo_t { ECHO_NONE = 0, ECHO_FWD = 1, ECHO_BWD = 2 };
@@ -170,6 +173,19 @@ constexpr ena_mask_t enable_overlap[] = {
     TERN_(INPUT_SHAPING_Y, shaping_echo_t y:2);
   };
 
+  // Input shapers for M593 T. The numbers are kept from the original M593 documentation.
+  enum shaping_type_t : uint8_t { SHAPER_ZV, SHAPER_EI, SHAPER_2HEI, SHAPER_ZVD, SHAPER_MZV, NUM_SHAPERS };
+
+  // Where each echo of one axis reads the step queue
+  struct shaping_echo_heads_t {
+    uint8_t count;                                // Echoes per step
+    shaping_time_t delay[shaping_max_echoes];     // Delay of each echo, increasing
+    shaping_time_t peek[shaping_max_echoes];      // Time until each echo is due. shaping_time_t(-1) if none waits.
+    shaping_time_t peek_min;                      // Time until the first echo is due
+    uint16_t head[shaping_max_echoes];
+    uint16_t free_count;                          // Queue entries behind the last echo
+  };
+
   class ShapingQueue {
     private:
       static shaping_time_t       now;
@@ -178,96 +194,114 @@ constexpr ena_mask_t enable_overlap[] = {
       static uint16_t             tail;
 
       #if ENABLED(INPUT_SHAPING_X)
-        static shaping_time_t delay_x;    // = shaping_time_t(-1) to disable queueing
-        static shaping_time_t peek_x_val;
-        static uint16_t head_x;
-        static uint16_t _free_count_x;
+        static shaping_echo_heads_t echoes_x;
       #endif
       #if ENABLED(INPUT_SHAPING_Y)
-        static shaping_time_t delay_y;    // = shaping_time_t(-1) to disable queueing
-        static shaping_time_t peek_y_val;
-        static uint16_t head_y;
-        static uint16_t _free_count_y;
+        static shaping_echo_heads_t echoes_y;
       #endif
 
+      static shaping_echo_t echo(const uint16_t i, const AxisEnum axis) {
+        TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) return echo_axes[i].x);
+        TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) return echo_axes[i].y);
+        return ECHO_NONE;
+      }
+
+      static void update_peek_min(shaping_echo_heads_t &h) {
+        h.peek_min = h.peek[0];
+        const uint8_t n = _MIN(h.count, shaping_max_echoes); // Bounded for the compiler. count <= shaping_max_echoes.
+        for (uint8_t k = 1; k < n; k++) NOMORE(h.peek_min, h.peek[k]);
+      }
+
+      static void decrement_delays(shaping_echo_heads_t &h, const shaping_time_t interval) {
+        if (h.peek_min == shaping_time_t(-1)) return;
+        for (uint8_t k = 0; k < h.count; k++) if (h.peek[k] != shaping_time_t(-1)) h.peek[k] -= interval;
+        h.peek_min -= interval;
+      }
+
+      // Record the echo directions of a new step on one axis. The caller sets echo_axes[tail].
+      static void enqueue(shaping_echo_heads_t &h, const bool step) {
+        const uint8_t last = h.count - 1;
+        if (step) {
+          for (uint8_t k = 0; k < h.count; k++) if (h.head[k] == tail) h.peek[k] = h.delay[k];
+          h.free_count--;
+          update_peek_min(h);
+        }
+        else {
+          if (h.head[last] != tail) h.free_count--;
+          for (uint8_t k = 0; k < h.count; k++)
+            if (h.head[k] == tail && ++h.head[k] == shaping_echoes) h.head[k] = 0;
+        }
+      }
+
+      // Index of an echo that is due, or that must go out early to make room in the queue. -1 for none.
+      static int8_t due(const shaping_echo_heads_t &h, const uint16_t min_free) {
+        for (uint8_t k = 0; k < h.count; k++) if (!h.peek[k]) return k;
+        if (h.free_count < min_free) {
+          // The oldest entry: send its earlier echoes first
+          const uint16_t oldest = h.head[h.count - 1];
+          for (uint8_t k = 0; k < h.count; k++) if (h.head[k] == oldest) return k;
+        }
+        return -1;
+      }
+
+      static bool dequeue(shaping_echo_heads_t &h, const AxisEnum axis, const uint8_t k) {
+        const bool forward = echo(h.head[k], axis) == ECHO_FWD, last = k == h.count - 1;
+        do {
+          if (last) h.free_count++;
+          if (++h.head[k] == shaping_echoes) h.head[k] = 0;
+        } while (h.head[k] != tail && echo(h.head[k], axis) == ECHO_NONE);
+        h.peek[k] = h.head[k] == tail ? shaping_time_t(-1) : times[h.head[k]] + h.delay[k] - now;
+        update_peek_min(h);
+        return forward;
+      }
+
+      static void purge(shaping_echo_heads_t &h) {
+        for (uint8_t k = 0; k < shaping_max_echoes; k++) { h.head[k] = tail; h.peek[k] = shaping_time_t(-1); }
+        h.peek_min = shaping_time_t(-1);
+        h.free_count = shaping_echoes - 1;
+      }
+
     public:
       static void decrement_delays(const shaping_time_t interval) {
         now += interval;
-        TERN_(INPUT_SHAPING_X, if (peek_x_val != shaping_time_t(-1)) peek_x_val -= interval);
-        TERN_(INPUT_SHAPING_Y, if (peek_y_val != shaping_time_t(-1)) peek_y_val -= interval);
+        TERN_(INPUT_SHAPING_X, decrement_delays(echoes_x, interval));
+        TERN_(INPUT_SHAPING_Y, decrement_delays(echoes_y, interval));
       }
-      static void set_delay(const AxisEnum axis, const shaping_time_t delay) {
-        TERN_(INPUT_SHAPING_X, if (axis == X_AXIS) delay_x = delay);
-        TERN_(INPUT_SHAPING_Y, if (axis == Y_AXIS) delay_y = delay);
+      // Set the echo delays of an axis, increasing, all shaping_time_t(-1) to disable queueing.
+      // Only with an empty queue.
+      static void set_delays(const AxisEnum axis, const uint8_t count, const shaping_time_t delays[]) {
+        shaping_echo_heads_t &h = TERN(INPUT_SHAPING_X, TERN_(INPUT_SHAPING_Y, axis == Y_AXIS ? echoes_y :) echoes_x, echoes_y);
+        h.count = count;
+        for (uint8_t k = 0; k < count; k++) h.delay[k] = delays[k];
+        purge(h);
       }
       static void enqueue(const bool x_step, const bool x_forward, const bool y_step, const bool y_forward) {
         #if ENABLED(INPUT_SHAPING_X)
-          if (x_step) {
-            if (head_x == tail) peek_x_val = delay_x;
-            echo_axes[tail].x = x_forward ? ECHO_FWD : ECHO_BWD;
-            _free_count_x--;
-          }
-          else {
-            echo_axes[tail].x = ECHO_NONE;
-            if (head_x != tail)
-              _free_count_x--;
-            else if (++head_x == shaping_echoes)
-              head_x = 0;
-          }
+          echo_axes[tail].x = x_step ? (x_forward ? ECHO_FWD : ECHO_BWD) : ECHO_NONE;
+          enqueue(echoes_x, x_step);
         #endif
         #if ENABLED(INPUT_SHAPING_Y)
-          if (y_step) {
-            if (head_y == tail) peek_y_val = delay_y;
-            echo_axes[tail].y = y_forward ? ECHO_FWD : ECHO_BWD;
-            _free_count_y--;
-          }
-          else {
-            echo_axes[tail].y = ECHO_NONE;
-            if (head_y != tail)
-              _free_count_y--;
-            else if (++head_y == shaping_echoes)
-              head_y = 0;
-          }
+          echo_axes[tail].y = y_step ? (y_forward ? ECHO_FWD : ECHO_BWD) : ECHO_NONE;
+          enqueue(echoes_y, y_step);
         #endif
         times[tail] = now;
         if (++tail == shaping_echoes) tail = 0;
       }
       #if ENABLED(INPUT_SHAPING_X)
-        static shaping_time_t peek_x() { return peek_x_val; }
-        static bool dequeue_x() {
-          bool forward = echo_axes[head_x].x == ECHO_FWD;
-          do {
-            _free_count_x++;
-            if (++head_x == shaping_echoes) head_x = 0;
-          } while (head_x != tail && echo_axes[head_x].x == ECHO_NONE);
-          peek_x_val = head_x == tail ? shaping_time_t(-1) : times[head_x] + delay_x - now;
-          return forward;
-        }
-        static bool empty_x() { return head_x == tail; }
-        static uint16_t free_count_x() { return _free_count_x; }
+        static shaping_time_t peek_x() { return echoes_x.peek_min; }
+        static int8_t due_x(const uint16_t min_free) { return due(echoes_x, min_free); }
+        static bool dequeue_x(const uint8_t k) { return dequeue(echoes_x, X_AXIS, k); }
+        static bool empty_x() { return echoes_x.head[echoes_x.count - 1] == tail; }
       #endif
       #if ENABLED(INPUT_SHAPING_Y)
-        static shaping_time_t peek_y() { return peek_y_val; }
-        static bool dequeue_y() {
-          bool forward = echo_axes[head_y].y == ECHO_FWD;
-          do {
-            _free_count_y++;
-            if (++head_y == shaping_echoes) head_y = 0;
-          } while (head_y != tail && echo_axes[head_y].y == ECHO_NONE);
-          peek_y_val = head_y == tail ? shaping_time_t(-1) : times[head_y] + delay_y - now;
-          return forward;
-        }
-        static bool empty_y() { return head_y == tail; }
-        static uint16_t free_count_y() { return _free_count_y; }
+        static shaping_time_t peek_y() { return echoes_y.peek_min; }
+        static int8_t due_y(const uint16_t min_free) { return due(echoes_y, min_free); }
+        static bool dequeue_y(const uint8_t k) { return dequeue(echoes_y, Y_AXIS, k); }
+        static bool empty_y() { return echoes_y.head[echoes_y.count - 1] == tail; }
       #endif
       static void purge() {
-        const auto st = shaping_time_t(-1);
-        #if ENABLED(INPUT_SHAPING_X)
-          head_x = tail; _free_count_x = shaping_echoes - 1; peek_x_val = st;
-        #endif
-        #if ENABLED(INPUT_SHAPING_Y)
-          head_y = tail; _free_count_y = shaping_echoes - 1; peek_y_val = st;
-        #endif
+        TERN_(INPUT_SHAPING_X, purge(echoes_x));
+        TERN_(INPUT_SHAPING_Y, purge(echoes_y));
       }
   };
 
@@ -276,14 +310,40 @@ constexpr ena_mask_t enable_overlap[] = {
     float zeta;
     bool enabled : 1;
     bool forward : 1;
+    shaping_type_t type;
     int16_t delta_error = 0;    // delta_error for seconday bresenham mod 128
-    uint8_t factor1;
-    uint8_t factor2;
+    uint8_t factor[SHAPING_MAX_IMPULSES]; // Impulse amplitudes in 1:7 fixed point, adding up to 128
     int32_t last_block_end_pos = 0;
   };
 
 #endif // HAS_ZV_SHAPING
 
+#if ENABLED(STEP_STREAM)
+
+  // One pre-computed step event, produced in the main loop and consumed by the Stepper ISR
+  typedef struct {
+    hal_timer_t interval;         // Ticks from this event to the next one
+    AxisBits step,                // Axes to pulse. For a block marker: the axes that will move.
+             dir;                 // Directions of the axes to pulse. For a block marker: the block direction bits.
+    uint8_t flags;                // STEP_EVENT_* flags
+    #if HAS_MULTI_EXTRUDER
+      uint8_t extruder;           // For a block marker: the extruder to step
+    #endif
+  } step_event_t;
+
+  #define STEP_EVENT_BLOCK  _BV(0) // Start of a new block. No pulses.
+  #define STEP_EVENT_LAST   _BV(1) // Last step event of a block
+
+  #if ENABLED(POWER_LOSS_RECOVERY)
+    // Resume point of a block, handed to the ISR with its marker
+    typedef struct {
+      uint32_t sdpos;
+      xyze_pos_t start_position;
+    } stream_resume_t;
+  #endif
+
+#endif
+
 //
 // Stepper class definition
 //
@@ -326,6 +386,11 @@ class Stepper {
       static bool frozen;                 // Set this flag to instantly freeze motion
     #endif
 
+    #if ENABLED(STEP_STREAM)
+      static uint32_t stream_slowdowns,   // Times the ring ran low mid-block and the ISR slowed down
+                      stream_stalls;      // Times the ring ran dry mid-block and motion held
+    #endif
+
   private:
 
     static block_t* current_block;        // A pointer to the block currently being traced
@@ -425,6 +490,21 @@ class Stepper {
       static page_step_state_t page_step_state;
     #endif
 
+    #if ENABLED(STEP_STREAM)
+      static step_event_t stream_buff[STEP_STREAM_SIZE];  // Ring of pre-computed step events
+      static volatile uint16_t stream_head,               // Next event written by stream_fill()
+                               stream_tail;               // Next event read by stream_isr()
+      static uint32_t stream_rate,                        // (steps/s) Rate limit while the ring runs low, 0 when inactive
+                      stream_accel;                       // (steps/s²) Slowest acceleration of the axes in the block
+      #if ENABLED(POWER_LOSS_RECOVERY)
+        static stream_resume_t stream_resume[BLOCK_BUFFER_SIZE]; // Resume points of the blocks in the ring
+        static volatile uint8_t stream_resume_head, stream_resume_tail;
+      #endif
+      #if HAS_FILAMENT_RUNOUT_DISTANCE
+        static int32_t stream_e_start;                    // E position at the block marker
+      #endif
+    #endif
+
     static hal_timer_t ticks_nominal;
     #if DISABLED(S_CURVE_ACCELERATION)
       static uint32_t acc_step_rate; // needed for deceleration start point
@@ -486,6 +566,17 @@ class Stepper {
       }
     #endif
 
+    #if ENABLED(STEP_STREAM)
+      // The Step Stream ISR phase, pulsing one pre-computed step event
+      static hal_timer_t stream_isr();
+
+      // Convert planner blocks into step events. Called from idle().
+      static void stream_fill();
+
+      // Check whether any step events are still waiting to be pulsed
+      static bool stream_busy() { return stream_head != stream_tail; }
+    #endif
+
     // Check if the given block is busy or not - Must not be called from ISR contexts
     static bool is_block_busy(const block_t * const block);
 
@@ -647,6 +738,9 @@ class Stepper {
       static float get_shaping_damping_ratio(const AxisEnum axis);
       static void set_shaping_frequency(const AxisEnum axis, const_float_t freq);
       static float get_shaping_frequency(const AxisEnum axis);
+      static void set_shaping_type(const AxisEnum axis, const shaping_type_t type);
+      static shaping_type_t get_shaping_type(const AxisEnum axis);
+      static uint8_t get_shaping_impulses(const shaping_type_t type);
     #endif
 
   private:
@@ -673,6 +767,11 @@ class Stepper {
       static void microstep_init();
     #endif
 
+    #if ENABLED(STEP_STREAM)
+      static hal_timer_t stream_next_interval();
+      static hal_timer_t stream_govern(const hal_timer_t interval, const bool low);
+    #endif
+
     #if ENABLED(FT_MOTION)
       static void fxdTiCtrl_stepper();
       static void fxdTiCtrl_refreshAxisDidMove();
@@ -0,0 +1,333 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(SD_BINARY_GCODE)
+
+#include "binary_gcode.h"
+#include "cardreader.h"
+#include "../feature/meatpack.h"
+#include "../libs/crc32.h"
+#include "../libs/heatshrink/heatshrink_decoder.h"
+
+#define BGCODE_MAGIC        0x45444347UL  // "GCDE"
+#define BGCODE_VERSION      1
+#define BGCODE_HEADER_SIZE  10            // Magic, version, checksum type
+
+enum BlockType : uint16_t {
+  BLOCK_FILE_METADATA, BLOCK_GCODE, BLOCK_SLICER_METADATA,
+  BLOCK_PRINTER_METADATA, BLOCK_PRINT_METADATA, BLOCK_THUMBNAIL
+};
+enum BlockCompression : uint16_t { COMPRESS_NONE, COMPRESS_DEFLATE, COMPRESS_HEATSHRINK_11_4, COMPRESS_HEATSHRINK_12_4 };
+enum BlockEncoding : uint16_t { ENCODE_NONE, ENCODE_MEATPACK, ENCODE_MEATPACK_COMMENTS };
+enum ThumbnailFormat : uint16_t { THUMB_PNG, THUMB_JPG, THUMB_QOI };
+
+typedef struct {
+  uint16_t type, compression;
+  uint32_t size,            // Size of the data when decompressed
+           data_size,       // Size of the data in the file
+           start,           // File position of the block header
+           data,            // File position of the data
+           end;             // File position of the next block
+  uint16_t param[3];        // Encoding, or the thumbnail format, width, and height
+} block_t;
+
+uint32_t BinaryGcode::index;
+
+static uint8_t crc_size;    // Bytes of CRC after each block, 0 or 4
+static block_t block;       // The current block
+static uint32_t next_pos,   // File position of the next block header
+                block_left, // Data bytes of the block not yet read from the file
+                decoded,    // Bytes decompressed from the block so far
+                vpos,       // Decoded bytes consumed from all G-code blocks so far
+                out_vpos;   // Value of vpos once the buffered characters are taken
+static bool in_block,       // Reading a G-code block?
+            at_end,         // All G-code blocks were read
+            failed;         // The file is unusable
+
+static heatshrink_decoder hsd;
+static MeatPack meatpack(false);
+
+static uint8_t in_buf[HEATSHRINK_STATIC_INPUT_BUFFER_SIZE], in_pos, in_len, // Compressed data
+               dec_buf[64], dec_pos, dec_len,                               // Decompressed data
+               out_pos, out_len;                                            // G-code characters
+static char out_buf[2];
+
+static uint16_t le16(const uint8_t * const b) { return b[0] | (uint16_t(b[1]) << 8); }
+static uint32_t le32(const uint8_t * const b) { return le16(b) | (uint32_t(le16(b + 2)) << 16); }
+
+static bool fail(FSTR_P const why) {
+  SERIAL_ERROR_MSG("Binary G-code: ", why);
+  failed = true;
+  return false;
+}
+
+static bool read_exactly(void * const buf, const uint32_t n) { return card.read(buf, n) == n; }
+
+static void seek_file(const uint32_t pos) { if (card.getFilePos() != pos) card.setFilePos(pos); }
+
+/**
+ * Read the file header at the start of the file
+ */
+static bool read_file_header() {
+  uint8_t b[BGCODE_HEADER_SIZE];
+  seek_file(0);
+  if (!read_exactly(b, sizeof(b)) || le32(b) != BGCODE_MAGIC) return false;
+  if (le32(&b[4]) != BGCODE_VERSION || le16(&b[8]) > 1) return fail(F("Unsupported version"));
+  crc_size = le16(&b[8]) ? 4 : 0;
+  return true;
+}
+
+/**
+ * Read the header and parameters of the block at the given position
+ */
+static bool read_block(block_t &blk, const uint32_t pos) {
+  uint8_t b[12];
+  seek_file(pos);
+  if (!read_exactly(b, 8)) return false;
+  blk.type = le16(b);
+  blk.compression = le16(&b[2]);
+  blk.size = blk.data_size = le32(&b[4]);
+  uint8_t header_size = 8;
+  if (blk.compression) {
+    if (!read_exactly(b, 4)) return false;
+    blk.data_size = le32(b);
+    header_size += 4;
+  }
+  const uint8_t param_size = blk.type == BLOCK_THUMBNAIL ? 6 : 2;
+  if (!read_exactly(b, param_size)) return false;
+  for (uint8_t i = 0; i < param_size / 2; ++i) blk.param[i] = le16(&b[i * 2]);
+
+  blk.start = pos;
+  blk.data = pos + header_size + param_size;
+
+  // Compare by subtraction, so a corrupt size can't wrap the end back before the block
+  const uint32_t filesize = card.getFileSize();
+  if (blk.data > filesize || blk.data_size > filesize - blk.data || crc_size > filesize - blk.data - blk.data_size)
+    return false;
+  blk.end = blk.data + blk.data_size + crc_size;
+  return true;
+}
+
+/**
+ * Check the whole block against its CRC before any of it is used
+ */
+static bool verify_block() {
+  if (!crc_size) return true;
+  seek_file(block.start);
+  uint32_t crc = 0;
+  for (uint32_t left = block.end - crc_size - block.start; left;) {
+    const uint32_t n = _MIN(left, sizeof(dec_buf));
+    if (!read_exactly(dec_buf, n)) return false;
+    crc32(&crc, dec_buf, n);
+    left -= n;
+  }
+  uint8_t b[4];
+  return read_exactly(b, 4) && le32(b) == crc;
+}
+
+/**
+ * Get ready to decode the current G-code block
+ */
+static bool open_block() {
+  if (block.compression != COMPRESS_NONE && block.compression != COMPRESS_HEATSHRINK_12_4)
+    return fail(F("Unsupported compression"));
+  if (block.param[0] > ENCODE_MEATPACK_COMMENTS)
+    return fail(F("Unsupported encoding"));
+  if (!verify_block())
+    return fail(F("Block CRC mismatch"));
+
+  seek_file(block.data);
+  block_left = block.data_size;
+  decoded = 0;
+  in_pos = in_len = dec_pos = dec_len = 0;
+  heatshrink_decoder_reset(&hsd);
+  meatpack.reset_state();
+  in_block = true;
+  return true;
+}
+
+/**
+ * Move on to the next G-code block, skipping any other blocks
+ */
+static bool next_gcode_block() {
+  for (;;) {
+    if (next_pos >= card.getFileSize()) { at_end = true; return false; }
+    if (!read_block(block, next_pos)) return fail(F("Bad block header"));
+    next_pos = block.end;
+    if (block.type == BLOCK_GCODE) return open_block();
+  }
+}
+
+/**
+ * Fill the decompressed data buffer. Return false at the end or on an error.
+ */
+static bool fill_decoded() {
+  for (;;) {
+    if (!in_block && !next_gcode_block()) return false;
+
+    if (block.compression == COMPRESS_NONE) {
+      if (block_left) {
+        const uint8_t n = _MIN(block_left, sizeof(dec_buf));
+        if (!read_exactly(dec_buf, n)) return fail(F("Read error"));
+        block_left -= n;
+        decoded += n;
+        dec_pos = 0; dec_len = n;
+        return true;
+      }
+    }
+    else {
+      size_t count;
+      heatshrink_decoder_poll(&hsd, dec_buf, sizeof(dec_buf), &count);
+      if (count) {
+        decoded += count;
+        if (decoded > block.size) return fail(F("Bad block data"));
+        dec_pos = 0; dec_len = count;
+        return true;
+      }
+      if (in_pos < in_len) {                    // Feed the decoder
+        heatshrink_decoder_sink(&hsd, &in_buf[in_pos], in_len - in_pos, &count);
+        in_pos += count;
+        continue;
+      }
+      if (block_left) {                         // Read more compressed data
+        const uint8_t n = _MIN(block_left, sizeof(in_buf));
+        if (!read_exactly(in_buf, n)) return fail(F("Read error"));
+        block_left -= n;
+        in_pos = 0; in_len = n;
+        continue;
+      }
+      if (heatshrink_decoder_finish(&hsd) == HSDR_FINISH_MORE) continue;
+    }
+
+    // The block is done. Step over its CRC, already checked.
+    if (decoded != block.size) return fail(F("Bad block data"));
+    if (crc_size && !read_exactly(in_buf, crc_size)) return fail(F("Read error"));
+    in_block = false;
+  }
+}
+
+/**
+ * Take the next decoded byte and pass it through MeatPack, if used
+ */
+static bool decode_next() {
+  if (dec_pos >= dec_len && !fill_decoded()) return false;
+  const uint8_t c = dec_buf[dec_pos++];
+  ++vpos;
+  if (block.param[0] == ENCODE_NONE) {
+    out_buf[0] = c;
+    out_len = 1;
+  }
+  else {
+    meatpack.handle_rx_char(c, serial_index_t());
+    out_len = meatpack.get_result_char(out_buf);
+  }
+  out_pos = 0;
+  return true;
+}
+
+// Buffer more G-code characters, if there are none
+static bool fill_output() {
+  while (out_pos >= out_len) {
+    if (failed || at_end || !decode_next()) return false;
+    out_vpos = vpos;
+  }
+  return true;
+}
+
+static void rewind() {
+  next_pos = BGCODE_HEADER_SIZE;
+  vpos = out_vpos = 0;
+  in_block = at_end = false;
+  out_pos = out_len = dec_pos = dec_len = 0;
+}
+
+bool BinaryGcode::begin() {
+  failed = false;
+  const bool binary = read_file_header();
+  if (!binary && !failed) { seek_file(0); return false; }
+  rewind();
+  index = 0;
+  return true;
+}
+
+int16_t BinaryGcode::get() {
+  if (!fill_output()) {
+    if (failed) card.abortFilePrintSoon();
+    return -1;
+  }
+  const uint8_t c = out_buf[out_pos++];
+  if (out_pos >= out_len) index = out_vpos;   // Index is only advanced past whole output groups
+  return c;
+}
+
+bool BinaryGcode::eof() { return !fill_output() && at_end; }
+
+/**
+ * Seek to a position in the decoded G-code. The block holding it is
+ * checked and decoded from its start, so the MeatPack state is right.
+ */
+void BinaryGcode::setIndex(const uint32_t pos) {
+  if (failed) return;
+  rewind();
+  for (uint32_t start = 0;;) {
+    vpos = start;
+    if (next_pos >= card.getFileSize()) { at_end = true; break; }
+    if (!read_block(block, next_pos)) { fail(F("Bad block header")); break; }
+    next_pos = block.end;
+    if (block.type != BLOCK_GCODE) continue;
+    if (pos < start + block.size) {
+      if (open_block())
+        while (vpos < pos && decode_next()) { /* skip */ }
+      break;
+    }
+    start += block.size;
+  }
+  out_pos = out_len = 0;
+  out_vpos = index = vpos;
+}
+
+#if ENABLED(THUMBNAILS_PREVIEW)
+
+  bool BinaryGcode::find_thumbnail(const uint16_t min_w, const uint16_t max_w, uint32_t &pos, uint32_t &size, uint16_t &w, uint16_t &h) {
+    size = 0;
+    failed = false;
+    if (!read_file_header()) return failed;
+
+    // Thumbnails come before the G-code blocks
+    block_t blk;
+    for (uint32_t p = BGCODE_HEADER_SIZE; p < card.getFileSize() && read_block(blk, p) && blk.type != BLOCK_GCODE; p = blk.end) {
+      if (blk.type == BLOCK_THUMBNAIL && blk.compression == COMPRESS_NONE && blk.param[0] == THUMB_PNG && WITHIN(blk.param[1], min_w, max_w)) {
+        pos = blk.data;
+        size = blk.size;
+        w = blk.param[1];
+        h = blk.param[2];
+        break;
+      }
+    }
+    return true;
+  }
+
+#endif // THUMBNAILS_PREVIEW
+
+#endif // SD_BINARY_GCODE
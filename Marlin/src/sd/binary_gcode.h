@@ -0,0 +1,62 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * sd/binary_gcode.h - Reader for binary G-code (.bgcode) files
+ *
+ * A binary G-code file is a short file header followed by blocks. Each block has a
+ * header (type, compression, sizes), a few parameters, the data, and a CRC32 if the
+ * file header asks for one. Metadata and thumbnail blocks come first, then G-code
+ * blocks, which may be heatshrink compressed and MeatPack encoded.
+ *
+ * While printing, the stream index counts the decompressed bytes of the G-code blocks
+ * instead of the file position, so M26, M808 and procedure calls can seek as they do
+ * in a text file. Seeking replays the block holding the index.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+class BinaryGcode {
+public:
+  // Check the open file for a binary G-code header and get ready to read it
+  static bool begin();
+
+  // Next character of G-code, or -1 at the end or on an error
+  static int16_t get();
+
+  // No more G-code? (False after an error, which aborts the print instead.)
+  static bool eof();
+
+  // Position in the decoded G-code stream
+  static uint32_t getIndex() { return index; }
+  static void setIndex(const uint32_t pos);
+
+  #if ENABLED(THUMBNAILS_PREVIEW)
+    // Find a PNG thumbnail block with a width in the given range. Size is 0 if there is none.
+    // Return false if the open file isn't binary G-code.
+    static bool find_thumbnail(const uint16_t min_w, const uint16_t max_w, uint32_t &pos, uint32_t &size, uint16_t &w, uint16_t &h);
+  #endif
+
+private:
+  static uint32_t index;
+};
@@ -61,6 +61,10 @@
   #include "../../src/lcd/menu/menu.h"
 #endif
 
+#if HAS_SD_FSINFO_SCAN
+#include "../libs/fatfs/diskio.h"
+#endif
+
 #define DEBUG_OUT ANY(DEBUG_CARDREADER, MARLIN_DEV_MODE)
 #include "../core/debug_out.h"
 #include "../libs/hex_print.h"
@@ -81,6 +85,25 @@ dir_active_items_t CardReader::active_dir_items;
 FIL CardReader::curfile;
 FILINFO CardReader::curfilinfo;
 
+#if HAS_SD_READ_AHEAD
+__attribute__((aligned(4))) uint8_t CardReader::ra_buf[SD_READ_AHEAD_SECTORS * 512];
+uint16_t CardReader::ra_pos, CardReader::ra_len;
+#endif
+
+#if HAS_SD_FSINFO_SCAN
+WORD CardReader::fsinfo_scan_id;
+DWORD CardReader::fsinfo_scan_gen;
+uint32_t CardReader::fsinfo_scan_sect, CardReader::fsinfo_scan_free, CardReader::fsinfo_scan_first;
+#endif
+
+#if HAS_SD_DIR_INDEX
+CardReader::dir_index_entry_t CardReader::dir_index[SD_DIR_INDEX_SIZE];
+uint16_t CardReader::dir_index_count;
+bool CardReader::dir_index_built, CardReader::dir_index_full;
+WORD CardReader::dir_index_fs_id;
+DWORD CardReader::dir_index_cdir;
+#endif
+
 IF_DISABLED(NO_SD_AUTOSTART, uint8_t CardReader::autofile_index); // = 0
 
 #if ENABLED(BINARY_FILE_TRANSFER)
@@ -216,6 +239,7 @@ bool CardReader::openFileRead(const char *const path, const uint8_t subcall_type
     }
 
     abortFilePrintNow();
+    TERN_(SD_BINARY_GCODE, flag.binary_gcode = false);
 
     if (f_stat(path, &curfilinfo) == FR_OK && f_open(&curfile, path, FA_READ) == FR_OK)
     {
@@ -225,8 +249,11 @@ bool CardReader::openFileRead(const char *const path, const uint8_t subcall_type
             SERIAL_ECHOLNPGM(STR_SD_FILE_SELECTED);
         }
 
+        TERN_(THUMBNAILS_PREVIEW, flag.thumbnail = subcall_type == 9);
         if (subcall_type < 9)
         {
+            TERN_(SD_FAST_SEEK, create_link_map());
+            TERN_(SD_BINARY_GCODE, flag.binary_gcode = BinaryGcode::begin());
             //      selectFileByName(fname);
             ui.set_status(curfilinfo.fname);
         }
@@ -271,6 +298,7 @@ bool CardReader::openFileWrite(const char *const path, bool owerwrite /*= false*
         flags |= FA_OPEN_ALWAYS | FA_OPEN_APPEND;
     if (f_open(&curfile, path, flags) == FR_OK)
     {
+        TERN_(HAS_SD_DIR_INDEX, invalidate_dir_index());
         flag.saving = true;
         selectFileByName(path);
         TERN_(EMERGENCY_PARSER, emergency_parser.disable());
@@ -372,6 +400,7 @@ void CardReader::removeFile(const char *const name)
 #else
     if (f_unlink(name) == FR_OK)
     {
+        TERN_(HAS_SD_DIR_INDEX, invalidate_dir_index());
         SERIAL_ECHOLNPGM("File deleted:", name);
     }
     else
@@ -383,7 +412,7 @@ void CardReader::report_status()
 {
     if (isPrinting())
     {
-        SERIAL_ECHOPGM(STR_SD_PRINTING_BYTE, curfile.fptr);
+        SERIAL_ECHOPGM(STR_SD_PRINTING_BYTE, getFilePos());
         SERIAL_CHAR('/');
         SERIAL_ECHOLN(curfilinfo.fsize);
     }
@@ -607,10 +636,14 @@ bool CardReader::autofile_check()
 
 void CardReader::closefile(const bool store_location /*=false*/)
 {
+    TERN_(HAS_SD_READ_AHEAD, flush_read_ahead());
+    TERN_(SD_FAST_SEEK, drop_link_map());
     f_close(&curfile);
     curfile.obj.fs = 0;
 
     flag.saving = flag.logging = false;
+    TERN_(SD_BINARY_GCODE, flag.binary_gcode = false);
+    TERN_(THUMBNAILS_PREVIEW, flag.thumbnail = false);
     TERN_(EMERGENCY_PARSER, emergency_parser.enable());
 
     if (store_location)
@@ -727,6 +760,10 @@ uint16_t CardReader::get_num_Files()
 {
     if (!isMounted())
         return 0;
+#if HAS_SD_DIR_INDEX
+    if (dir_index_ready())
+        return dir_index_count;
+#endif
     uint16_t item_count = 0;
     TCHAR curpath[256];
     DIR dir;
@@ -778,6 +815,11 @@ void CardReader::selectFileByIndex(const uint16_t nr)
     DIR dir;
     FILINFO finfo;
 
+#if HAS_SD_DIR_INDEX
+    if (dir_index_ready() && select_indexed_file(nr))
+        return;
+#endif
+
     if (f_getcwd(curpath, sizeof(curpath)) != FR_OK)
         return;
     if (f_opendir(&dir, curpath) != FR_OK)
@@ -817,10 +859,137 @@ void CardReader::selectFileByIndex(const uint16_t nr)
     f_closedir(&dir);
 }
 
+#if HAS_SD_DIR_INDEX
+
+static uint8_t dir_index_hash(const char *name)
+{
+    uint8_t hash = 0;
+    while (*name)
+        hash = hash * 31 + *name++;
+    return hash;
+}
+
+//
+// True when the index matches the working directory, rebuilding it if needed.
+// False if the directory has more entries than the index holds.
+//
+bool CardReader::dir_index_ready()
+{
+    if (!dir_index_built || dir_index_fs_id != FS_sd.id || dir_index_cdir != FS_sd.cdir)
+        build_dir_index();
+    return dir_index_built && !dir_index_full;
+}
+
+//
+// Scan the working directory once, keeping the entries the browser shows
+//
+void CardReader::build_dir_index()
+{
+    DIR dir;
+    FILINFO finfo;
+    FRESULT res;
+    uint16_t files = 0, dirs = 0;
+
+    dir_index_built = dir_index_full = false;
+    dir_index_count = 0;
+
+    if (f_opendir(&dir, "") != FR_OK) // The working directory
+        return;
+
+    // Files are stored from the front of the table, folders from the back
+    while (1)
+    {
+        const uint16_t slot = dir.dptr / 32;
+        if ((res = f_readdir(&dir, &finfo)) != FR_OK || finfo.fname[0] == 0)
+            break;
+
+        const bool is_file = isFileMustShow(&finfo), is_dir = isDirMustShow(&finfo);
+        if (files + dirs + is_file + is_dir > SD_DIR_INDEX_SIZE)
+        {
+            dir_index_full = true;
+            break;
+        }
+        for (uint8_t i = 0; i < is_file + is_dir; i++)
+        {
+            const bool as_dir = !is_file || i;
+            dir_index_entry_t &e = as_dir ? dir_index[SD_DIR_INDEX_SIZE - 1 - dirs++] : dir_index[files++];
+            e.fsize = finfo.fsize;
+            e.fdate = finfo.fdate;
+            e.ftime = finfo.ftime;
+            e.slot = slot;
+            e.hash = dir_index_hash(finfo.fname);
+        }
+    }
+    f_closedir(&dir);
+    if (res != FR_OK)
+        return;
+
+    // Folders follow the files in directory order, as the scan lists them
+    for (uint16_t i = 0, j = SD_DIR_INDEX_SIZE - 1; i < dirs / 2; i++, j--)
+    {
+        const dir_index_entry_t e = dir_index[SD_DIR_INDEX_SIZE - dirs + i];
+        dir_index[SD_DIR_INDEX_SIZE - dirs + i] = dir_index[j];
+        dir_index[j] = e;
+    }
+    memmove(&dir_index[files], &dir_index[SD_DIR_INDEX_SIZE - dirs], dirs * sizeof(dir_index_entry_t));
+
+    #if ENABLED(SD_DIR_INDEX_BY_DATE)
+        // Newest files first, stable for equal dates
+        for (uint16_t i = 1; i < files; i++)
+        {
+            const dir_index_entry_t e = dir_index[i];
+            const uint32_t stamp = ((uint32_t)e.fdate << 16) | e.ftime;
+            uint16_t j = i;
+            for (; j > 0 && (((uint32_t)dir_index[j - 1].fdate << 16) | dir_index[j - 1].ftime) < stamp; j--)
+                dir_index[j] = dir_index[j - 1];
+            dir_index[j] = e;
+        }
+    #endif
+
+    dir_index_count = files + dirs;
+    dir_index_fs_id = FS_sd.id;
+    dir_index_cdir = FS_sd.cdir;
+    dir_index_built = true;
+}
+
+//
+// Read one indexed entry straight from its place in the directory.
+// False if the entry is no longer there, so the caller falls back to a scan.
+//
+bool CardReader::select_indexed_file(const uint16_t nr)
+{
+    DIR dir;
+    FILINFO finfo;
+
+    if (nr >= dir_index_count)
+        return true;
+
+    const dir_index_entry_t &e = dir_index[nr];
+    if (f_opendir(&dir, "") != FR_OK)
+        return false;
+    const bool found = f_seekdir(&dir, (DWORD)e.slot * 32) == FR_OK
+                    && f_readdir(&dir, &finfo) == FR_OK
+                    && finfo.fname[0] != 0
+                    && dir_index_hash(finfo.fname) == e.hash;
+    f_closedir(&dir);
+
+    if (!found)
+    {
+        invalidate_dir_index();
+        return false;
+    }
+
+    memcpy(&curfilinfo, &finfo, sizeof(finfo));
+    card.flag.filenameIsDir = (finfo.fattrib & AM_DIR);
+    return true;
+}
+
+#endif // HAS_SD_DIR_INDEX
+
 bool CardReader::isFileMustShow(FILINFO *finfo)
 {
     char *fext = FATFS_GetFileExtensionUTF(finfo->fname);
-    if ((strcmp(fext, "gcode") == 0 || strcmp(fext, "ini") == 0) && !(finfo->fattrib & AM_HID))
+    if ((strcmp(fext, "gcode") == 0 || strcmp(fext, "ini") == 0 || TERN0(SD_BINARY_GCODE, strcmp(fext, "bgcode") == 0)) && !(finfo->fattrib & AM_HID))
         return true;
 
     return false;
@@ -832,7 +1001,7 @@ bool CardReader::isFilePrintable(FILINFO *finfo /*= NULL*/)
     if (fi == NULL)
         fi = &curfilinfo;
     char *fext = FATFS_GetFileExtensionUTF(fi->fname);
-    if ((strcmp(fext, "gcode") == 0) && !(fi->fattrib & AM_HID) && !(fi->fattrib & AM_DIR))
+    if ((strcmp(fext, "gcode") == 0 || TERN0(SD_BINARY_GCODE, strcmp(fext, "bgcode") == 0)) && !(fi->fattrib & AM_HID) && !(fi->fattrib & AM_DIR))
         return true;
 
     return false;
@@ -866,18 +1035,84 @@ bool CardReader::isDirMustShow(FILINFO *finfo)
     return ((finfo->fattrib) & AM_DIR && !(finfo->fattrib & AM_HID));
 }
 
-int16_t CardReader::get()
+#if ENABLED(SD_FAST_SEEK)
+
+//
+// Walk the FAT chain of the opened file once and store its fragments
+// (cluster link map) in the shared memory, so f_lseek() becomes O(1).
+// If the memory is busy or the file is too fragmented the file is
+// simply left in normal seek mode.
+//
+void CardReader::create_link_map()
+{
+    if (shared_mem_owner != SHARED_MEM_FREE)
+        return;
+
+    DWORD *clmt = (DWORD *)shared_mem;
+    clmt[0] = SHARED_MEM_SIZE / sizeof(DWORD);
+    curfile.cltbl = clmt;
+    if (f_lseek(&curfile, CREATE_LINKMAP) == FR_OK)
+        shared_mem_owner = SHARED_MEM_FILE_LINKMAP;
+    else
+        curfile.cltbl = 0;
+}
+
+void CardReader::drop_link_map()
+{
+    curfile.cltbl = 0;
+    if (shared_mem_owner == SHARED_MEM_FILE_LINKMAP)
+        shared_mem_owner = SHARED_MEM_FREE;
+}
+
+#endif
+
+#if HAS_SD_READ_AHEAD
+
+//
+// Refill the read-ahead buffer from the current file position.
+// The first block after a seek is trimmed to end on a sector boundary,
+// so all following blocks go from the card straight into the buffer
+// with one multi-sector DMA transfer, bypassing the FatFs sector window.
+//
+bool CardReader::fill_read_ahead()
 {
-    int16_t val = 0;
     UINT readed = 0;
+    const UINT toread = sizeof(ra_buf) - (curfile.fptr % 512);
+
+    flush_read_ahead();
+    if (f_read(&curfile, ra_buf, toread, &readed) != FR_OK || readed == 0)
+        return false;
+
+    ra_len = readed;
+    return true;
+}
 
+#endif
+
+int16_t CardReader::get()
+{
     if (!isFileOpen())
         return -1;
 
+#if ENABLED(SD_BINARY_GCODE)
+    if (flag.binary_gcode)
+        return BinaryGcode::get();
+#endif
+
+#if HAS_SD_READ_AHEAD
+    if (ra_pos >= ra_len && !fill_read_ahead())
+        return -1;
+
+    return ra_buf[ra_pos++];
+#else
+    int16_t val = 0;
+    UINT readed = 0;
+
     if (f_read(&curfile, &val, 1, &readed) != FR_OK)
         return -1;
 
     return val;
+#endif
 }
 
 
@@ -886,10 +1121,31 @@ uint32_t CardReader::read(void *buf, uint32_t nbyte)
     if (!isFileOpen())
         return -1;
     UINT rd = 0;
+
+#if HAS_SD_READ_AHEAD
+    // Hand out the already buffered bytes first
+    uint32_t buffered = ra_len - ra_pos;
+    if (buffered)
+    {
+        NOMORE(buffered, nbyte);
+        memcpy(buf, &ra_buf[ra_pos], buffered);
+        ra_pos += buffered;
+        if (buffered == nbyte)
+            return nbyte;
+        buf = (uint8_t *)buf + buffered;
+        nbyte -= buffered;
+    }
+    // Bytes already copied out stay valid even if the read fails
+    if (f_read(&curfile, buf, nbyte, &rd) != FR_OK)
+        return buffered ? buffered : -1;
+
+    return rd + buffered;
+#else
     if (f_read(&curfile, buf, nbyte, &rd) != FR_OK)
         return -1;
     
     return rd;
+#endif
 }
 
 
@@ -897,6 +1153,13 @@ uint32_t CardReader::write(void *buf, uint32_t nbyte)
 {
     if (!isFileOpen())
         return -1;
+
+#if HAS_SD_READ_AHEAD
+    // Drop the read-ahead data so the write lands at the logical position
+    if (ra_pos < ra_len)
+        setFilePos(getFilePos());
+#endif
+
     UINT wr = 0;
     if (f_write(&curfile, buf, nbyte, &wr) != FR_OK)
         return -1;
@@ -910,8 +1173,11 @@ uint32_t CardReader::write(void *buf, uint32_t nbyte)
 //
 void CardReader::fileHasFinished()
 {
+    TERN_(HAS_SD_READ_AHEAD, flush_read_ahead());
+    TERN_(SD_FAST_SEEK, drop_link_map());
     f_close(&curfile);
     curfile.obj.fs = 0;
+    TERN_(SD_BINARY_GCODE, flag.binary_gcode = false);
 
 #if HAS_MEDIA_SUBCALLS
     if (file_subcall_ctr > 0)
@@ -982,10 +1248,15 @@ void CardReader::openLogFile(const char *const path)
     IF_DISABLED(SDCARD_READONLY, openFileWrite(path));
 }
 
-bool CardReader::mount(bool wifi)
+bool CardReader::mount(bool wifi, bool force /*= false*/)
 {
     FRESULT res = FR_OK;
 
+    // Keep the mounted volume, its FAT window and FSINFO state unless a re-mount is asked for.
+    // A removed card is released by manage_media, so it is not mounted any more here.
+    if (!force && isMounted())
+        return true;
+
     if ((res = f_mount(&FS_sd, DISK_SD, 1)) != FR_OK)
     {
         if (wifi)
@@ -1008,6 +1279,76 @@ bool CardReader::mount(bool wifi)
     return res == FR_OK;
 }
 
+#if HAS_SD_FSINFO_SCAN
+
+//
+// Count the free clusters of a FAT32 volume a few FAT sectors at a time,
+// when FSINFO had no valid free count or next free cluster at mount time.
+// Any FAT write during the scan restarts it. The FSINFO dirty flag can't tell,
+// since FatFs only sets it while the free count is valid.
+//
+void CardReader::fsinfo_scan()
+{
+    FATFS *fs = &FS_sd;
+    uint32_t buf[FF_MIN_SS / 4];
+
+    if (!isMounted() || fs->fs_type != FS_FAT32 || (fs->fsi_flag & 0x80) || isFileOpen())
+        return;
+    if (fs->free_clst <= fs->n_fatent - 2 && fs->last_clst >= 2 && fs->last_clst < fs->n_fatent)
+        return; // FSINFO is valid
+#if FF_MAX_SS != FF_MIN_SS
+    if (fs->ssize != FF_MIN_SS)
+        return;
+#endif
+
+    const uint32_t fat_sects = (fs->n_fatent + COUNT(buf) - 1) / COUNT(buf);
+
+    if (fsinfo_scan_id != fs->id || fsinfo_scan_gen != fs->fat_gen)
+    {
+        // The window may hold FAT changes not on the card yet
+        if (fs->wflag)
+            return;
+        fsinfo_scan_id = fs->id;
+        fsinfo_scan_gen = fs->fat_gen;
+        fsinfo_scan_sect = fsinfo_scan_free = fsinfo_scan_first = 0;
+    }
+    if (fsinfo_scan_sect >= fat_sects)
+        return; // Gave up on a read error
+
+    for (uint8_t n = 0; n < SD_FSINFO_SCAN_SECTORS && fsinfo_scan_sect < fat_sects; n++, fsinfo_scan_sect++)
+    {
+        if (disk_read(fs->pdrv, (BYTE *)buf, fs->fatbase + fsinfo_scan_sect, 1) != RES_OK)
+        {
+            fsinfo_scan_sect = fat_sects;
+            return;
+        }
+        for (uint16_t i = 0; i < COUNT(buf); i++)
+        {
+            const uint32_t clst = fsinfo_scan_sect * COUNT(buf) + i;
+            if (clst < 2 || clst >= fs->n_fatent)
+                continue;
+            if ((buf[i] & 0x0FFFFFFF) == 0)
+            {
+                fsinfo_scan_free++;
+                if (!fsinfo_scan_first)
+                    fsinfo_scan_first = clst;
+            }
+        }
+    }
+
+    if (fsinfo_scan_sect < fat_sects || fsinfo_scan_gen != fs->fat_gen)
+        return; // Not done yet, or the FAT changed and the next call restarts
+
+    fs->free_clst = fsinfo_scan_free;
+    if (fs->last_clst < 2 || fs->last_clst >= fs->n_fatent)
+        fs->last_clst = fsinfo_scan_first ? fsinfo_scan_first - 1 : 2;
+    fs->fsi_flag |= 1;
+    f_syncvol(DISK_SD);
+    DEBUG_ECHOLNPGM("SD: ", fsinfo_scan_free, " free clusters");
+}
+
+#endif // HAS_SD_FSINFO_SCAN
+
 /**
  * Handle SD card events
  */
@@ -1018,6 +1359,9 @@ bool CardReader::mount(bool wifi)
 void CardReader::manage_media()
 {
     static uint8_t prev_stat = 2; // First call, no prior state
+
+    TERN_(HAS_SD_FSINFO_SCAN, fsinfo_scan());
+
     uint8_t stat = uint8_t(IS_SD_INSERTED());
     if (stat == prev_stat)
         return;
@@ -1093,6 +1437,9 @@ void CardReader::endFilePrintNow()
 {
     TERN_(ADVANCED_PAUSE_FEATURE, did_pause_print = 0);
     flag.abort_sd_printing = false;
+    TERN_(THUMBNAILS_PREVIEW, flag.thumbnail = false);
+    TERN_(HAS_SD_READ_AHEAD, flush_read_ahead());
+    TERN_(SD_FAST_SEEK, drop_link_map());
     if (isFileOpen())
         f_close(&curfile);
 }
@@ -24,6 +24,14 @@
 #include "../inc/MarlinConfig.h"
 #include "../libs/fatfs/fatfs_shared.h"
 
+#if ENABLED(SD_FAST_SEEK)
+  #include "../module/shared_mem/shared_mem.h"
+#endif
+
+#if ENABLED(SD_BINARY_GCODE)
+  #include "binary_gcode.h"
+#endif
+
 #if HAS_MEDIA
 
 extern const char M23_STR[], M24_STR[];
@@ -45,6 +53,8 @@ typedef struct {
        sdprintdone:1,
        filenameIsDir:1,
        abort_sd_printing:1
+       OPTARG(SD_BINARY_GCODE, binary_gcode:1)
+       OPTARG(THUMBNAILS_PREVIEW, thumbnail:1) // Open file was opened to read its thumbnail
     ;
 } card_flags_t;
 
@@ -70,7 +80,7 @@ public:
   CardReader();
 
 
-  static bool mount(bool wifi = false);
+  static bool mount(bool wifi = false, bool force = false);
   static void release();
   static bool isMounted() { return FS_sd.fs_type != 0; }
   static bool isRootDir();
@@ -141,7 +151,7 @@ public:
   #endif
   static uint8_t percentDone() {
     if (flag.sdprintdone) return 100;
-    if (isFileOpen() && curfilinfo.fsize) return curfile.fptr / ((curfilinfo.fsize + 99) / 100);
+    if (isFileOpen() && curfilinfo.fsize) return getFilePos() / ((curfilinfo.fsize + 99) / 100);
     return 0;
   }
 
@@ -162,13 +172,40 @@ public:
 
   // Print File stats
   static uint32_t getFileSize()  { if (isFileOpen()) return curfilinfo.fsize; else return 0; }
-  static uint32_t getIndex()     { if (isFileOpen()) return curfile.fptr; else return 0; }
+  static uint32_t getFilePos()   { if (isFileOpen()) return curfile.fptr - TERN0(HAS_SD_READ_AHEAD, ra_len - ra_pos); else return 0; }
   static bool isFileOpen()       { return isMounted() && curfile.obj.fs != 0; }
-  static bool eof()              { return getIndex() >= getFileSize(); }
+
+  // Position in the G-code, which is the file position unless the file is binary G-code
+  static uint32_t getIndex() {
+    #if ENABLED(SD_BINARY_GCODE)
+      if (flag.binary_gcode) return BinaryGcode::getIndex();
+    #endif
+    return getFilePos();
+  }
+  static bool eof() {
+    #if ENABLED(SD_BINARY_GCODE)
+      if (flag.binary_gcode) return BinaryGcode::eof();
+    #endif
+    return getFilePos() >= getFileSize();
+  }
 
   // File data operations
   static int16_t get();
-  static void setIndex(const uint32_t index)      { if (isFileOpen()) f_lseek(&curfile, index); }
+  static void setFilePos(const uint32_t pos)      { if (isFileOpen()) { TERN_(HAS_SD_READ_AHEAD, flush_read_ahead()); f_lseek(&curfile, pos); } }
+  static void setIndex(const uint32_t index) {
+    #if ENABLED(SD_BINARY_GCODE)
+      if (flag.binary_gcode) { if (isFileOpen()) BinaryGcode::setIndex(index); return; }
+    #endif
+    setFilePos(index);
+  }
+
+  #if ENABLED(SD_FAST_SEEK)
+    static void drop_link_map();    // Give the shared memory back, seeks fall back to the FAT chain
+  #endif
+
+  #if HAS_SD_DIR_INDEX
+    static void invalidate_dir_index() { dir_index_built = false; } // Entries were added or removed
+  #endif
 
   #if ENABLED(AUTO_REPORT_SD_STATUS)
     //
@@ -187,6 +224,51 @@ public:
     static uint8_t activefileitems[MAX_DIR_DEPTH];
     static dir_active_items_t active_dir_items;
 
+  #if ENABLED(SD_FAST_SEEK)
+    static void create_link_map();
+  #endif
+
+  //
+  // Read-ahead buffer for the printed file
+  //
+  #if HAS_SD_READ_AHEAD
+    static uint8_t ra_buf[SD_READ_AHEAD_SECTORS * 512];
+    static uint16_t ra_pos, ra_len;
+    static bool fill_read_ahead();
+    static void flush_read_ahead() { ra_pos = ra_len = 0; }
+  #endif
+
+  //
+  // Index of the shown entries of the working directory, files first, then folders
+  //
+  #if HAS_SD_DIR_INDEX
+    typedef struct {
+      uint32_t fsize;
+      uint16_t fdate, ftime;
+      uint16_t slot;                // Position in the directory, in 32-byte entries
+      uint8_t  hash;                // Name hash, catches a directory changed behind our back
+    } dir_index_entry_t;
+
+    static dir_index_entry_t dir_index[SD_DIR_INDEX_SIZE];
+    static uint16_t dir_index_count;
+    static bool dir_index_built, dir_index_full;
+    static WORD dir_index_fs_id;    // Mount and directory the index was built for
+    static DWORD dir_index_cdir;
+    static bool dir_index_ready();
+    static void build_dir_index();
+    static bool select_indexed_file(const uint16_t nr);
+  #endif
+
+  //
+  // Background count of free clusters for FAT32 cards with an invalid FSINFO
+  //
+  #if HAS_SD_FSINFO_SCAN
+    static WORD fsinfo_scan_id;     // Mount the scan belongs to
+    static DWORD fsinfo_scan_gen;   // FAT write generation the scan started at
+    static uint32_t fsinfo_scan_sect, fsinfo_scan_free, fsinfo_scan_first;
+    static void fsinfo_scan();
+  #endif
+
   //
   // Procedure calls to other files
   //
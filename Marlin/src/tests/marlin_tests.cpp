@@ -24,6 +24,7 @@
 
 #if ENABLED(MARLIN_TEST_BUILD)
 
+#include "../gcode/parser.h"
 #include "../module/endstops.h"
 #include "../module/motion.h"
 #include "../module/planner.h"
@@ -72,6 +73,8 @@ void runStartupTests() {
   auto print_char_ptr = [](char * const str) { SERIAL_ECHOLN(str); };
   print_char_ptr(str);
 
+  // Quick number parsing against strtof/strtol, with timings
+  parser.test_numbers(TERN(__PLAT_LINUX__, 20000000, 20000));
 }
 
 // Periodic tests are run from within loop()
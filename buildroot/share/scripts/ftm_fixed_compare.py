@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+Compare the FT_MOTION float and FTM_FIXED_POINT builds on the Linux replay.
+
+Run the same G-code through two linux_replay firmwares, one built as-is and
+one with FTM_FIXED_POINT, and compare the step traces they write:
+
+- At every step edge of either trace, the step position of each axis may
+  differ by no more than the tolerance (8 steps by default). The two builds
+  round the trajectory differently, so a step can land a few points earlier
+  or later. 8 steps is 0.05 mm at 160 steps/mm. The built-in test differs
+  by up to 5 steps.
+- The final step positions may differ by no more than the final tolerance
+  (1 step by default). Block ends fall on whole steps and both builds
+  truncate, so 1599.9999 and 1600.0001 steps end one step apart. The float
+  build is as often the one that misses the ideal end.
+
+The exit code is 0 when both checks pass and 1 when one fails.
+
+  pio run -e linux_replay && pio run -e linux_replay_fixed
+  buildroot/share/scripts/ftm_fixed_compare.py .pio/build/linux_replay/program .pio/build/linux_replay_fixed/program
+
+Without G-code files a built-in test runs. It makes random XYZE moves and
+arcs under each shaper (M493 S1/10/11/15/13), with and without linear
+advance, as one replay per section so each starts from the same position.
+Other G-code files must enable FT_MOTION with M493 themselves.
+"""
+
+import argparse, os, random, re, struct, subprocess, sys, tempfile
+
+AXES = ('X', 'Y', 'Z', 'E0')
+PINS_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), '../../../Marlin/src/pins/linux/pins_RAMPS_LINUX.h')
+
+def read_pins():
+    """ Map the step and direction pins of the simulated board to axes """
+    text = open(PINS_FILE).read()
+    pin = lambda name: int(re.search(r'#define\s+' + name + r'_PIN\s+(\d+)', text).group(1))
+    return { pin(a + '_STEP'): a for a in AXES }, { pin(a + '_DIR'): a for a in AXES }
+
+def read_steps(trace, step_pins, dir_pins):
+    """ List the (time ns, axis, +1/-1) of every step in a replay trace (see IOLoggerTrace.h) """
+    data = open(trace, 'rb').read()
+    if data[:4] != b'MRT1': sys.exit("%s is not a replay trace" % trace)
+    RISE = 2
+    t, steps, dir_high = 0, [], { a: False for a in AXES }
+    for delta, pin, event in struct.iter_unpack('<IBB', data[4:]):
+        t += delta
+        if delta == 0xFFFFFFFF: continue  # NOP record splitting a long gap
+        if pin in dir_pins:
+            dir_high[dir_pins[pin]] = event == RISE
+        elif pin in step_pins and event == RISE:
+            a = step_pins[pin]
+            steps.append((t, a, 1 if dir_high[a] else -1))
+    return steps
+
+def compare(steps_a, steps_b):
+    """ Walk both step lists in time order. Return the largest position difference per axis and the final positions. """
+    pos_a, pos_b = { a: 0 for a in AXES }, { a: 0 for a in AXES }
+    worst = { a: (0, 0) for a in AXES }
+    i = j = 0
+    while i < len(steps_a) or j < len(steps_b):
+        if j >= len(steps_b) or (i < len(steps_a) and steps_a[i][0] <= steps_b[j][0]):
+            t, a, d = steps_a[i]; pos_a[a] += d; i += 1
+        else:
+            t, a, d = steps_b[j]; pos_b[a] += d; j += 1
+        diff = abs(pos_a[a] - pos_b[a])
+        if diff > worst[a][0]: worst[a] = (diff, t)
+    return worst, pos_a, pos_b
+
+def builtin_gcode(seed=1):
+    """ Random moves and arcs under every shaper, with and without linear advance. Yield (name, G-code) per section. """
+    rnd = random.Random(seed)
+    for mode in (1, 10, 11, 15, 13):
+        for la in (0, 1):
+            lines = ['M302 P1', 'G92 X50 Y50 Z5 E0', 'M83', 'M493 S%d P%d K0.05' % (mode, la)]
+            for _ in range(12):
+                x, y = rnd.uniform(20, 80), rnd.uniform(20, 80)
+                lines.append('G1 X%.3f Y%.3f Z%.3f E%.4f F%d' % (x, y, rnd.uniform(4, 6), rnd.uniform(0, 1.5), rnd.choice((1200, 3000, 6000, 9000))))
+            lines += ['G1 X60 Y50 F6000', 'G2 X60 Y70 J10 E0.8', 'G3 X60 Y50 J-10 E0.8', 'M400']
+            yield 'M493_S%d_P%d.gcode' % (mode, la), '\n'.join(lines) + '\n'
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('float_program', help='linux_replay firmware built with float FT_MOTION')
+    parser.add_argument('fixed_program', help='linux_replay firmware built with FTM_FIXED_POINT')
+    parser.add_argument('gcode', nargs='*', help='G-code files to replay (default: built-in test)')
+    parser.add_argument('-t', '--tolerance', type=int, default=8, help='largest allowed step position difference (default: 8)')
+    parser.add_argument('-f', '--final-tolerance', type=int, default=1, help='largest allowed final step position difference (default: 1)')
+    args = parser.parse_args()
+
+    step_pins, dir_pins = read_pins()
+    failed = False
+    with tempfile.TemporaryDirectory() as tmp:
+        files = args.gcode
+        if not files:
+            for name, gcode in builtin_gcode():
+                files.append(os.path.join(tmp, name))
+                open(files[-1], 'w').write(gcode)
+
+        for gcode in files:
+            traces = []
+            for n, program in enumerate((args.float_program, args.fixed_program)):
+                trace = os.path.join(tmp, 'trace%d.bin' % n)
+                run = subprocess.run([os.path.abspath(program), os.path.abspath(gcode), '-o', trace], cwd=tmp, capture_output=True, text=True)
+                if run.returncode: sys.exit("%s failed:\n%s" % (program, run.stderr))
+                traces.append(read_steps(trace, step_pins, dir_pins))
+
+            worst, pos_float, pos_fixed = compare(*traces)
+            print("%s: %d / %d steps" % (os.path.basename(gcode), len(traces[0]), len(traces[1])))
+            for a in AXES:
+                diff, t = worst[a]
+                ok = diff <= args.tolerance and abs(pos_float[a] - pos_fixed[a]) <= args.final_tolerance
+                failed |= not ok
+                print("  %-2s max difference %2d steps at %8.4f s, final %7d / %7d  %s" % (a, diff, t / 1e9, pos_float[a], pos_fixed[a], 'ok' if ok else 'FAIL'))
+
+    sys.exit(1 if failed else 0)
+
+if __name__ == '__main__':
+    main()